@@ -0,0 +1,95 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+
+#include "liboptparse/argument_stream.hh"
+
+_LIBOPTPARSE_::ArgumentStream::ArgumentStream(int fd,
+                                              std::size_t chunk_size)
+    : _fd(fd),
+      _buffer(chunk_size),
+      _begin(0),
+      _end(0),
+      _count(0),
+      _eof(false),
+      _failed(false) {
+    assert(chunk_size > 0);
+}
+
+std::string_view _LIBOPTPARSE_::ArgumentStream::next() {
+    while (true) {
+        char* begin = _buffer.data() + _begin;
+        const void* nul = std::memchr(begin, '\0', _end - _begin);
+        if (nul != NULL) {
+            std::size_t size = static_cast<const char*>(nul) - begin;
+            _begin += size + 1;
+            ++_count;
+            return std::string_view(begin, size);
+        }
+        if (_eof) {
+            if (_begin == _end) {
+                return std::string_view();
+            }
+            std::size_t size = _end - _begin;
+            _begin = _end;
+            ++_count;
+            return std::string_view(begin, size);
+        }
+        fill();
+    }
+}
+
+void _LIBOPTPARSE_::ArgumentStream::fill() {
+    /* Only the partial argument is moved, returned ones are dropped. */
+    if (_begin > 0) {
+        std::memmove(_buffer.data(), _buffer.data() + _begin,
+                     _end - _begin);
+        _end -= _begin;
+        _begin = 0;
+    }
+    if (_end == _buffer.size()) {
+        _buffer.resize(2 * _buffer.size());
+    }
+    ssize_t size;
+    do {
+        size = ::read(_fd, _buffer.data() + _end, _buffer.size() - _end);
+    } while (size < 0 && errno == EINTR);
+    if (size < 0) {
+        /* The partial argument is dropped. */
+        _eof = true;
+        _failed = true;
+        _begin = _end;
+    } else if (size == 0) {
+        _eof = true;
+    } else {
+        _end += static_cast<std::size_t>(size);
+    }
+}
+
+std::string_view _LIBOPTPARSE_::ArgumentStream::read(const void* stream,
+                                                     int index) {
+    ArgumentStream* self =
+        static_cast<ArgumentStream*>(const_cast<void*>(stream));
+    assert(index == self -> _count);
+    (void) index;
+    return self -> next();
+}
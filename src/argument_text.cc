@@ -0,0 +1,102 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "liboptparse/argument_text.hh"
+
+namespace {
+    /*!
+     * Call f with each char of the raw text passed, without escapes,
+     * until it returns false.
+     */
+    template<class Function>
+    void for_each_char(std::string_view raw, Function f) {
+        for (std::size_t i = 0; i < raw.size(); ++i) {
+            if (raw[i] == '\\') {
+                ++i;
+                if (i == raw.size()) {
+                    break;
+                }
+            }
+            if (!f(raw[i])) {
+                break;
+            }
+        }
+    }
+}
+
+std::size_t ArgumentText::size() const noexcept {
+    std::size_t size = _raw.size();
+    if (_escaped) {
+        size = 0;
+        for_each_char(_raw, [&size](char) { ++size; return true; });
+    }
+    return size;
+}
+
+std::size_t ArgumentText::copy(char* buffer,
+                               std::size_t size) const noexcept {
+    std::size_t copied = 0;
+    for_each_char(_raw, [&](char c) {
+        if (copied == size) {
+            return false;
+        }
+        buffer[copied++] = c;
+        return true;
+    });
+    return copied;
+}
+
+std::string ArgumentText::str() const {
+    if (!_escaped) {
+        return std::string(_raw);
+    }
+    std::string text;
+    text.reserve(_raw.size());
+    for_each_char(_raw, [&text](char c) {
+        text.push_back(c);
+        return true;
+    });
+    return text;
+}
+
+bool operator==(const ArgumentText& text,
+                std::string_view other) noexcept {
+    if (!text.has_escapes()) {
+        return text.raw() == other;
+    }
+    std::size_t matched = 0;
+    bool equal = true;
+    for_each_char(text.raw(), [&](char c) {
+        equal = matched < other.size() && other[matched] == c;
+        ++matched;
+        return equal;
+    });
+    return equal && matched == other.size();
+}
+
+bool operator!=(const ArgumentText& text,
+                std::string_view other) noexcept {
+    return !(text == other);
+}
+
+std::ostream& operator<<(std::ostream& os, const ArgumentText& text) {
+    for_each_char(text.raw(), [&os](char c) {
+        os.put(c);
+        return true;
+    });
+    return os;
+}
@@ -0,0 +1,103 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <charconv>
+#include <system_error>
+
+#include "liboptparse/binding.hh"
+
+namespace {
+    /*! Convert the whole text with std::from_chars. */
+    template<class T>
+    bool from_chars(std::string_view text, T& destination) {
+        const char* end = text.data() + text.size();
+        T value;
+        auto result = std::from_chars(text.data(), end, value);
+        if (result.ec != std::errc() || result.ptr != end) {
+            return false;
+        }
+        destination = value;
+        return true;
+    }
+}
+
+_LIBOPTPARSE_::ValueBinder::~ValueBinder() { }
+
+bool _LIBOPTPARSE_::convert_value(std::string_view text,
+                                  bool& destination) {
+    bool ok = text == "true" || text == "false";
+    if (ok) {
+        destination = text == "true";
+    }
+    return ok;
+}
+
+bool _LIBOPTPARSE_::convert_value(std::string_view text,
+                                  short& destination) {
+    return from_chars(text, destination);
+}
+
+bool _LIBOPTPARSE_::convert_value(std::string_view text,
+                                  int& destination) {
+    return from_chars(text, destination);
+}
+
+bool _LIBOPTPARSE_::convert_value(std::string_view text,
+                                  long& destination) {
+    return from_chars(text, destination);
+}
+
+bool _LIBOPTPARSE_::convert_value(std::string_view text,
+                                  long long& destination) {
+    return from_chars(text, destination);
+}
+
+bool _LIBOPTPARSE_::convert_value(std::string_view text,
+                                  unsigned short& destination) {
+    return from_chars(text, destination);
+}
+
+bool _LIBOPTPARSE_::convert_value(std::string_view text,
+                                  unsigned int& destination) {
+    return from_chars(text, destination);
+}
+
+bool _LIBOPTPARSE_::convert_value(std::string_view text,
+                                  unsigned long& destination) {
+    return from_chars(text, destination);
+}
+
+bool _LIBOPTPARSE_::convert_value(std::string_view text,
+                                  unsigned long long& destination) {
+    return from_chars(text, destination);
+}
+
+bool _LIBOPTPARSE_::convert_value(std::string_view text,
+                                  float& destination) {
+    return from_chars(text, destination);
+}
+
+bool _LIBOPTPARSE_::convert_value(std::string_view text,
+                                  double& destination) {
+    return from_chars(text, destination);
+}
+
+bool _LIBOPTPARSE_::convert_value(std::string_view text,
+                                  std::string& destination) {
+    destination.assign(text.data(), text.size());
+    return true;
+}
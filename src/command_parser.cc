@@ -0,0 +1,239 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <vector>
+
+#include "liboptparse/command_parser.hh"
+#include "liboptparse/static_parser_priv.hpp"
+
+CommandResult::CommandResult(std::unique_ptr<const Options> global,
+                             std::string_view command,
+                             std::unique_ptr<const Options> options)
+    : _global(std::move(global)),
+      _options(std::move(options)),
+      _command(command),
+      _error(ParseError { parse_ok, 0, 0 }) {
+    assert(_global != NULL);
+}
+
+CommandResult::CommandResult(const ParseError& error)
+    : _global(), _options(), _command(), _error(error) {
+    assert(_error.type != parse_ok);
+}
+
+CommandResult::~CommandResult() { }
+
+bool CommandResult::is_ok() const noexcept {
+    return _error.type == parse_ok;
+}
+
+CommandResult::operator bool() const noexcept {
+    return is_ok();
+}
+
+const ParseError& CommandResult::get_error() const noexcept {
+    return _error;
+}
+
+std::string_view CommandResult::get_command() const noexcept {
+    return _command;
+}
+
+std::unique_ptr<const Options> CommandResult::get_global_options()
+    noexcept {
+    return std::move(_global);
+}
+
+std::unique_ptr<const Options> CommandResult::get_options() noexcept {
+    return std::move(_options);
+}
+
+class CommandParser::Impl {
+public:
+    Impl() : _global(), _commands(), _slots(), _mask(0) { }
+
+    explicit Impl(const ProgramInfo& program_info)
+        : _global(program_info), _commands(), _slots(), _mask(0) { }
+
+    OptionParser& get_global_parser() noexcept {
+        return _global;
+    }
+
+    void add(const std::string& name, factory make) {
+        std::uint64_t hash = _LIBOPTPARSE_::hash_name(name);
+        if (lookup(name, hash) != NULL) {
+            throw std::invalid_argument("duplicate command: " + name);
+        }
+        /* Keep the load factor at most 1/2. */
+        if (2 * (_commands.size() + 1) > _slots.size()) {
+            rehash(_slots.empty() ? 16 : 2 * _slots.size());
+        }
+        _commands.push_back(Command {
+                name, hash, std::move(make),
+                std::unique_ptr<OptionParser>() });
+        place(_commands.size() - 1);
+    }
+
+    std::size_t size() const noexcept {
+        return _commands.size();
+    }
+
+    bool is_built(std::string_view name) const noexcept {
+        const Command* command =
+            lookup(name, _LIBOPTPARSE_::hash_name(name));
+        return command != NULL && command -> parser != NULL;
+    }
+
+    OptionParser* find(std::string_view name) {
+        Command* command = lookup(name, _LIBOPTPARSE_::hash_name(name));
+        if (command == NULL) {
+            return NULL;
+        }
+        if (command -> parser == NULL) {
+            std::unique_ptr<OptionParser> parser(new OptionParser());
+            command -> make(*parser);
+            command -> parser = std::move(parser);
+        }
+        return command -> parser.get();
+    }
+
+    CommandResult try_parse(int argc, const char *argv[]) {
+        ParseResult global = _global.try_parse(argc, argv,
+                                               stop_at_positional);
+        if (!global.is_ok()) {
+            return CommandResult(global.get_error());
+        }
+        ArgumentSpan tail = global.get_tail();
+        if (tail.argc == 0) {
+            return CommandResult(global.get_options(),
+                                 std::string_view(),
+                                 std::unique_ptr<const Options>());
+        }
+        int offset = argc - tail.argc;
+        std::string_view name(tail.argv[0]);
+        OptionParser* parser = find(name);
+        if (parser == NULL) {
+            return CommandResult(ParseError { unknown_command, offset, 0 });
+        }
+        /* The name of the subcommand is the program name of its argv. */
+        ParseResult options = parser -> try_parse(tail.argc, tail.argv);
+        if (!options.is_ok()) {
+            ParseError error = options.get_error();
+            error.index += offset;
+            return CommandResult(error);
+        }
+        return CommandResult(global.get_options(),
+                             name,
+                             options.get_options());
+    }
+
+private:
+    /*! A registered subcommand. */
+    struct Command {
+        std::string                   name;
+        std::uint64_t                 hash;
+        factory                       make;
+        std::unique_ptr<OptionParser> parser;
+    };
+
+    /*! Empty slot of the table. */
+    static constexpr std::uint32_t EMPTY = UINT32_MAX;
+
+    const Command* lookup(std::string_view name,
+                          std::uint64_t hash) const noexcept {
+        if (_slots.empty()) {
+            return NULL;
+        }
+        for (std::size_t slot = hash & _mask;
+             _slots[slot] != EMPTY;
+             slot = (slot + 1) & _mask) {
+            const Command& command = _commands[_slots[slot]];
+            if (command.hash == hash && command.name == name) {
+                return &command;
+            }
+        }
+        return NULL;
+    }
+
+    Command* lookup(std::string_view name, std::uint64_t hash) noexcept {
+        return const_cast<Command*>(
+            static_cast<const Impl*>(this) -> lookup(name, hash));
+    }
+
+    void place(std::size_t position) noexcept {
+        std::size_t slot = _commands[position].hash & _mask;
+        while (_slots[slot] != EMPTY) {
+            slot = (slot + 1) & _mask;
+        }
+        _slots[slot] = static_cast<std::uint32_t>(position);
+    }
+
+    /*! Rebuild the table from the stored hashes, names are not read. */
+    void rehash(std::size_t slots) {
+        _slots.assign(slots, EMPTY);
+        _mask = slots - 1;
+        for (std::size_t i = 0; i < _commands.size(); ++i) {
+            place(i);
+        }
+    }
+
+    OptionParser                 _global;
+    /*! Subcommands by position; a deque keeps them in place. */
+    std::deque<Command>          _commands;
+    /*! Positions of the subcommands by hash, power of two sized. */
+    std::vector<std::uint32_t>   _slots;
+    std::size_t                  _mask;
+};
+
+CommandParser::CommandParser() : _pimpl(new Impl()) { }
+
+CommandParser::CommandParser(const ProgramInfo& program_info)
+    : _pimpl(new Impl(program_info)) { }
+
+CommandParser::~CommandParser() { }
+
+OptionParser& CommandParser::get_global_parser() noexcept {
+    return _pimpl -> get_global_parser();
+}
+
+CommandParser& CommandParser::add(const std::string& name,
+                                  factory make) {
+    assert(!name.empty() && name[0] != '-' && make);
+    _pimpl -> add(name, std::move(make));
+    assert(!is_built(name));
+    return *this;
+}
+
+std::size_t CommandParser::size() const noexcept {
+    return _pimpl -> size();
+}
+
+bool CommandParser::is_built(std::string_view name) const noexcept {
+    return _pimpl -> is_built(name);
+}
+
+OptionParser* CommandParser::find(std::string_view name) {
+    return _pimpl -> find(name);
+}
+
+CommandResult CommandParser::try_parse(int argc, const char *argv[]) {
+    return _pimpl -> try_parse(argc, argv);
+}
@@ -0,0 +1,612 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "liboptparse/compiled_parser.hh"
+#include "liboptparse/environment.hh"
+#include "liboptparse/option_index.hh"
+#include "liboptparse/parser.hh"
+#include "liboptparse/parser_priv.hpp"
+#include "liboptparse/static_parser_priv.hpp"
+
+namespace {
+    const char SCHEMA_MAGIC[8] = { 'L', 'O', 'P', 'T', 'S', 'C', 'H', '\0' };
+    const std::uint32_t SCHEMA_VERSION = 3;
+    const std::uint32_t EMPTY_SLOT = UINT32_MAX;
+
+    /*! Text of the image: offset from the image and size. */
+    struct ImageText {
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    struct SchemaHeader {
+        char          magic[8];
+        std::uint32_t version;
+        /*! Size of option_id, the type of the short names table. */
+        std::uint32_t id_size;
+        std::uint32_t options;
+        /*! Slots of the long names table, a power of two. */
+        std::uint32_t slots;
+        std::uint64_t size;
+        /*! See OptionParser::set_env_prefix. */
+        ImageText     env_prefix;
+        /*! See OptionParser::set_response_files. */
+        std::uint64_t response_bytes;
+        std::uint32_t response_depth;
+        std::uint32_t padding;
+    };
+
+    struct ImageSpec {
+        ImageText     long_name;
+        ImageText     help;
+        ImageText     default_value;
+        ImageText     metavar;
+        ImageText     env_name;
+        std::uint8_t  short_name;
+        std::uint8_t  type;
+        std::uint8_t  padding[6];
+    };
+
+    static_assert(sizeof(SchemaHeader) % 8 == 0 &&
+                  sizeof(ImageSpec) % 8 == 0,
+                  "sections must keep the image aligned");
+
+    /*
+     * Sections follow the header in this order: ids by short name,
+     * as option_id so the index reads them in place, specs by id, ids
+     * by long name hash, ids by hash of the long name in upper case
+     * (see OptionIndex::find_upper_case), texts. The two tables have
+     * the same number of slots.
+     */
+    struct SchemaLayout {
+        std::size_t shorts;
+        std::size_t specs;
+        std::size_t slots;
+        std::size_t upper_slots;
+        std::size_t texts;
+
+        SchemaLayout(std::size_t options, std::size_t slot_count) {
+            shorts = sizeof(SchemaHeader);
+            specs = shorts + (UCHAR_MAX + 1) * sizeof(option_id);
+            slots = specs + options * sizeof(ImageSpec);
+            upper_slots = slots + slot_count * sizeof(std::uint32_t);
+            texts = upper_slots + slot_count * sizeof(std::uint32_t);
+        }
+    };
+
+    /*! Put the id passed in the first free slot from hash. */
+    void add_slot(std::uint32_t* table,
+                  std::size_t slots,
+                  std::uint64_t hash,
+                  option_id id) {
+        std::size_t slot = hash & (slots - 1);
+        while (table[slot] != EMPTY_SLOT) {
+            slot = (slot + 1) & (slots - 1);
+        }
+        table[slot] = static_cast<std::uint32_t>(id);
+    }
+
+    std::size_t slots_for(std::size_t options) {
+        std::size_t slots = 2;
+        while (slots < 2 * options) {
+            slots *= 2;
+        }
+        return slots;
+    }
+
+    std::size_t texts_size(const OptionArgument& argument) {
+        return argument.get_long_name().size() +
+            argument.get_help().size() +
+            argument.get_default_value().size() +
+            argument.get_metavar().size() +
+            argument.get_env_name().size();
+    }
+
+    /*! Schema used by the evaluator, see RuntimeSchema. */
+    struct ImageSchema {
+        const CompiledParser& parser;
+
+        option_id find(char short_name) const noexcept {
+            return parser.find(short_name);
+        }
+
+        option_id find(std::string_view long_name) const noexcept {
+            return parser.find(long_name);
+        }
+
+        OptionArgumentType get_type(option_id id) const noexcept {
+            return parser.get_type(id);
+        }
+    };
+}
+
+/*!
+ * \brief Image opened by a CompiledParser.
+ *
+ * It is the index of the options parsed, reading the short names
+ * table of the image in place, and it owns the mapping of the file
+ * if there is one. The matcher of the environment is built once,
+ * when the image is opened.
+ */
+class CompiledParser::Image : public _LIBOPTPARSE_::OptionIndex {
+public:
+    Image(const char* data, std::size_t size,
+          std::shared_ptr<void> mapping)
+        : OptionIndex(reinterpret_cast<const option_id*>(
+                          data + sizeof(SchemaHeader))),
+          _data(data),
+          _mapping(std::move(mapping)),
+          _options(0),
+          _slots(0),
+          _specs(NULL),
+          _table(NULL),
+          _upper_table(NULL),
+          _reads_environment(false),
+          _environment() {
+        const SchemaHeader* header =
+            reinterpret_cast<const SchemaHeader*>(data);
+        if (size < sizeof(SchemaHeader) ||
+            std::memcmp(header -> magic, SCHEMA_MAGIC,
+                        sizeof(SCHEMA_MAGIC)) != 0 ||
+            header -> version != SCHEMA_VERSION ||
+            header -> id_size != sizeof(option_id) ||
+            header -> size > size) {
+            throw std::invalid_argument("not a schema image");
+        }
+        SchemaLayout layout(header -> options, header -> slots);
+        bool valid = header -> slots != 0 &&
+            (header -> slots & (header -> slots - 1)) == 0 &&
+            layout.texts <= header -> size;
+        _options = header -> options;
+        _slots = header -> slots;
+        _specs = reinterpret_cast<const ImageSpec*>(data + layout.specs);
+        _table = reinterpret_cast<const std::uint32_t*>(
+            data + layout.slots);
+        _upper_table = reinterpret_cast<const std::uint32_t*>(
+            data + layout.upper_slots);
+        auto check = [&valid, header](const ImageText& text) {
+            valid = valid && text.offset <= header -> size &&
+                text.size <= header -> size - text.offset;
+        };
+        check(header -> env_prefix);
+        valid = valid && header -> response_depth <= INT_MAX;
+        for (std::uint32_t id = 0; valid && id < _options; ++id) {
+            check(_specs[id].long_name);
+            check(_specs[id].help);
+            check(_specs[id].default_value);
+            check(_specs[id].metavar);
+            check(_specs[id].env_name);
+            valid = valid && _specs[id].type <= repeated;
+        }
+        _reads_environment = header -> env_prefix.size != 0;
+        for (std::uint32_t id = 0; valid && id < _options; ++id) {
+            _reads_environment = _reads_environment ||
+                _specs[id].env_name.size != 0;
+        }
+        for (std::size_t i = 0; valid && i <= UCHAR_MAX; ++i) {
+            valid = _shorts[i] == NO_OPTION_ID || _shorts[i] < _options;
+        }
+        for (std::uint32_t i = 0; valid && i < _slots; ++i) {
+            valid = (_table[i] == EMPTY_SLOT || _table[i] < _options) &&
+                (_upper_table[i] == EMPTY_SLOT ||
+                 _upper_table[i] < _options);
+        }
+        if (!valid) {
+            throw std::invalid_argument("corrupted schema image");
+        }
+        if (_reads_environment) {
+            _environment.reset(new _LIBOPTPARSE_::EnvironmentMatcher(
+                                   *this, text(header -> env_prefix)));
+            for (option_id id = 0; id < _options; ++id) {
+                if (_specs[id].env_name.size != 0) {
+                    _environment -> add(text(_specs[id].env_name), id);
+                }
+            }
+        }
+    }
+
+    using OptionIndex::find;
+
+    option_id find(std::string_view long_name) const noexcept override {
+        std::size_t mask = _slots - 1;
+        std::size_t slot = _LIBOPTPARSE_::hash_name(long_name) & mask;
+        for (std::uint32_t probes = 0; probes < _slots; ++probes) {
+            std::uint32_t id = _table[slot];
+            if (id == EMPTY_SLOT) {
+                break;
+            }
+            if (text(_specs[id].long_name) == long_name) {
+                return id;
+            }
+            slot = (slot + 1) & mask;
+        }
+        return NO_OPTION_ID;
+    }
+
+    char get_short_name(option_id id) const noexcept override {
+        return static_cast<char>(_specs[id].short_name);
+    }
+
+    std::string_view get_long_name(option_id id) const noexcept override {
+        return text(_specs[id].long_name);
+    }
+
+    std::size_t size() const noexcept override {
+        return _options;
+    }
+
+    option_id find_upper_case(
+        std::string_view name) const noexcept override {
+        if (!_LIBOPTPARSE_::is_upper_case(name)) {
+            return NO_OPTION_ID;
+        }
+        std::size_t mask = _slots - 1;
+        std::size_t slot = _LIBOPTPARSE_::hash_upper_case(name) & mask;
+        option_id found = NO_OPTION_ID;
+        for (std::uint32_t probes = 0; probes < _slots; ++probes) {
+            std::uint32_t id = _upper_table[slot];
+            if (id == EMPTY_SLOT) {
+                break;
+            }
+            if (_LIBOPTPARSE_::equal_upper_case(
+                    text(_specs[id].long_name), name)) {
+                if (found != NO_OPTION_ID) {
+                    return NO_OPTION_ID;
+                }
+                found = id;
+            }
+            slot = (slot + 1) & mask;
+        }
+        return found;
+    }
+
+    const SchemaHeader& header() const noexcept {
+        return *reinterpret_cast<const SchemaHeader*>(_data);
+    }
+
+    bool reads_environment() const noexcept {
+        return _reads_environment;
+    }
+
+    /*! Gets the matcher of the environment, NULL if not read. */
+    const _LIBOPTPARSE_::EnvironmentMatcher* environment() const noexcept {
+        return _environment.get();
+    }
+
+    const ImageSpec& spec(option_id id) const noexcept {
+        assert(id < _options);
+        return _specs[id];
+    }
+
+    std::string_view text(const ImageText& reference) const noexcept {
+        return std::string_view(_data + reference.offset, reference.size);
+    }
+
+private:
+    const char*           _data;
+    /*! Mapping of the file, empty for images not owned. */
+    std::shared_ptr<void> _mapping;
+    std::uint32_t         _options;
+    std::uint32_t         _slots;
+    const ImageSpec*      _specs;
+    const std::uint32_t*  _table;
+    const std::uint32_t*  _upper_table;
+    /*! An env prefix or an env name is in the image. */
+    bool                  _reads_environment;
+    std::unique_ptr<_LIBOPTPARSE_::EnvironmentMatcher> _environment;
+};
+
+std::size_t CompiledParser::image_size(OptionParser& parser) {
+    std::size_t options = std::distance(parser.cbegin(), parser.cend());
+    SchemaLayout layout(options, slots_for(options));
+    std::size_t size = layout.texts + parser.get_env_prefix().size();
+    for (auto itr = parser.cbegin(); itr != parser.cend(); ++itr) {
+        size += texts_size(**itr);
+    }
+    if (size > UINT32_MAX) {
+        throw std::length_error("schema image larger than 4 GB");
+    }
+    return (size + 7) & ~std::size_t(7);
+}
+
+void CompiledParser::write_image(OptionParser& parser,
+                                 void* destination) {
+    assert(reinterpret_cast<std::uintptr_t>(destination) % 8 == 0);
+    std::size_t size = image_size(parser);
+    std::size_t options = std::distance(parser.cbegin(), parser.cend());
+    std::size_t slots = slots_for(options);
+    SchemaLayout layout(options, slots);
+    char* image = static_cast<char*>(destination);
+    std::memset(image, 0, size);
+    std::size_t used = layout.texts;
+    auto add_text = [image, &used](const std::string& text) {
+        std::memcpy(image + used, text.data(), text.size());
+        ImageText reference = {
+            static_cast<std::uint32_t>(used),
+            static_cast<std::uint32_t>(text.size()) };
+        used += text.size();
+        return reference;
+    };
+
+    SchemaHeader* header = reinterpret_cast<SchemaHeader*>(image);
+    std::memcpy(header -> magic, SCHEMA_MAGIC, sizeof(SCHEMA_MAGIC));
+    header -> version = SCHEMA_VERSION;
+    header -> id_size = sizeof(option_id);
+    header -> options = static_cast<std::uint32_t>(options);
+    header -> slots = static_cast<std::uint32_t>(slots);
+    header -> size = size;
+    header -> env_prefix = add_text(parser.get_env_prefix());
+    header -> response_bytes = parser.get_response_files().max_bytes;
+    header -> response_depth = static_cast<std::uint32_t>(
+        parser.get_response_files().max_depth);
+
+    option_id* shorts = reinterpret_cast<option_id*>(image + layout.shorts);
+    ImageSpec* specs = reinterpret_cast<ImageSpec*>(image + layout.specs);
+    std::uint32_t* table =
+        reinterpret_cast<std::uint32_t*>(image + layout.slots);
+    std::uint32_t* upper_table =
+        reinterpret_cast<std::uint32_t*>(image + layout.upper_slots);
+    std::fill(shorts, shorts + UCHAR_MAX + 1, NO_OPTION_ID);
+    std::fill(table, table + slots, EMPTY_SLOT);
+    std::fill(upper_table, upper_table + slots, EMPTY_SLOT);
+    for (auto itr = parser.cbegin(); itr != parser.cend(); ++itr) {
+        const OptionArgument& argument = **itr;
+        option_id id = argument.get_id();
+        ImageSpec& spec = specs[id];
+        spec.long_name = add_text(argument.get_long_name());
+        spec.help = add_text(argument.get_help());
+        spec.default_value = add_text(argument.get_default_value());
+        spec.metavar = add_text(argument.get_metavar());
+        spec.env_name = add_text(argument.get_env_name());
+        spec.short_name =
+            static_cast<std::uint8_t>(argument.get_short_name());
+        spec.type = static_cast<std::uint8_t>(argument.get_type());
+        if (argument.has_short_name()) {
+            shorts[static_cast<unsigned char>(argument.get_short_name())] =
+                id;
+        }
+        if (!argument.get_long_name().empty()) {
+            add_slot(table, slots,
+                     _LIBOPTPARSE_::hash_name(argument.get_long_name()),
+                     id);
+            add_slot(upper_table, slots,
+                     _LIBOPTPARSE_::hash_upper_case(
+                         argument.get_long_name()),
+                     id);
+        }
+    }
+}
+
+void CompiledParser::save(OptionParser& parser, const std::string& path) {
+    std::vector<std::uint64_t> image(image_size(parser) / 8);
+    write_image(parser, image.data());
+    int fd = ::open(path.c_str(),
+                    O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    const char* data = reinterpret_cast<const char*>(image.data());
+    std::size_t left = image.size() * 8;
+    while (fd >= 0 && left > 0) {
+        ssize_t written = ::write(fd, data, left);
+        if (written <= 0) {
+            break;
+        }
+        data += written;
+        left -= written;
+    }
+    if (fd < 0 || ::close(fd) != 0 || left > 0) {
+        throw std::runtime_error("unable to write schema: " + path);
+    }
+}
+
+CompiledParser::CompiledParser(const void* image, std::size_t size)
+    : _image(new Image(static_cast<const char*>(image), size,
+                       std::shared_ptr<void>())),
+      _program_info() {
+    assert(reinterpret_cast<std::uintptr_t>(image) % 8 == 0);
+}
+
+CompiledParser::CompiledParser(const std::string& path)
+    : _image(), _program_info() {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (fd < 0 || ::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) ||
+        info.st_size == 0) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        throw std::invalid_argument("unreadable schema file: " + path);
+    }
+    std::size_t size = static_cast<std::size_t>(info.st_size);
+    void* address = ::mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        throw std::invalid_argument("unreadable schema file: " + path);
+    }
+    std::shared_ptr<void> mapping(address, [size](void* mapped) {
+            ::munmap(mapped, size);
+        });
+    _image.reset(new Image(static_cast<const char*>(address), size,
+                           std::move(mapping)));
+}
+
+CompiledParser::~CompiledParser() { }
+
+ProgramInfo& CompiledParser::get_program_info() noexcept {
+    return _program_info;
+}
+
+std::size_t CompiledParser::size() const noexcept {
+    return _image -> size();
+}
+
+option_id CompiledParser::find(char short_name) const noexcept {
+    return _image -> find(short_name);
+}
+
+option_id CompiledParser::find(std::string_view long_name) const noexcept {
+    return _image -> find(long_name);
+}
+
+char CompiledParser::get_short_name(option_id id) const noexcept {
+    return _image -> get_short_name(id);
+}
+
+std::string_view CompiledParser::get_long_name(
+    option_id id) const noexcept {
+    return _image -> get_long_name(id);
+}
+
+std::string_view CompiledParser::get_help(option_id id) const noexcept {
+    return _image -> text(_image -> spec(id).help);
+}
+
+std::string_view CompiledParser::get_default_value(
+    option_id id) const noexcept {
+    return _image -> text(_image -> spec(id).default_value);
+}
+
+std::string_view CompiledParser::get_metavar(option_id id) const noexcept {
+    return _image -> text(_image -> spec(id).metavar);
+}
+
+std::string_view CompiledParser::get_env_name(
+    option_id id) const noexcept {
+    return _image -> text(_image -> spec(id).env_name);
+}
+
+OptionArgumentType CompiledParser::get_type(option_id id) const noexcept {
+    return static_cast<OptionArgumentType>(_image -> spec(id).type);
+}
+
+std::unique_ptr<const Options> CompiledParser::parse(int argc,
+                                                     const char *argv[]) {
+    ParseResult result = try_parse(argc, argv);
+    if (!result.is_ok()) {
+        std::ostringstream message;
+        message << result.get_error();
+        throw std::out_of_range(message.str());
+    }
+    return result.get_options();
+}
+
+ParseResult CompiledParser::try_parse(int argc, const char *argv[]) {
+    _LIBOPTPARSE_::FirstErrorReporter report;
+    std::unique_ptr<const Options> options;
+    ResponseFileLimits limits = get_response_files();
+    if (limits.max_depth > 0 &&
+        ResponseFiles::has_response_files(argc, argv)) {
+        ResponseFiles files;
+        ParseError error = files.expand(argc, argv, limits);
+        if (error.type != parse_ok) {
+            return ParseResult(error);
+        }
+        options = parse(static_cast<int>(files.size()), files.data(),
+                        report);
+    } else {
+        options = parse(argc, argv, report);
+    }
+    if (report.error.type != parse_ok) {
+        return ParseResult(report.error);
+    }
+    return ParseResult(std::move(options));
+}
+
+ParseResult CompiledParser::try_parse(int argc,
+                                      const char *argv[],
+                                      std::vector<ParseError>& errors) {
+    std::size_t first = errors.size();
+    _LIBOPTPARSE_::AllErrorsReporter report { errors };
+    std::unique_ptr<const Options> options;
+    ResponseFileLimits limits = get_response_files();
+    if (limits.max_depth > 0 &&
+        ResponseFiles::has_response_files(argc, argv)) {
+        ResponseFiles files;
+        ParseError error = files.expand(argc, argv, limits);
+        if (error.type != parse_ok) {
+            errors.push_back(error);
+            return ParseResult(error);
+        }
+        options = parse(static_cast<int>(files.size()), files.data(),
+                        report);
+    } else {
+        options = parse(argc, argv, report);
+    }
+    if (errors.size() != first) {
+        return ParseResult(errors[first]);
+    }
+    return ParseResult(std::move(options));
+}
+
+std::string_view CompiledParser::get_env_prefix() const noexcept {
+    return _image -> text(_image -> header().env_prefix);
+}
+
+bool CompiledParser::reads_environment() const noexcept {
+    return _image -> reads_environment();
+}
+
+ResponseFileLimits CompiledParser::get_response_files() const noexcept {
+    const SchemaHeader& header = _image -> header();
+    return ResponseFileLimits {
+        static_cast<std::size_t>(header.response_bytes),
+        static_cast<int>(header.response_depth) };
+}
+
+template<class Argument, class ErrorReporter>
+std::unique_ptr<const Options> CompiledParser::parse(
+    int argc,
+    const Argument* argv,
+    ErrorReporter& report) {
+    _LIBOPTPARSE_::ParsedValues parsed;
+    parsed.values.reserve(size());
+    for (option_id id = 0; id < size(); ++id) {
+        parsed.add_default(
+            get_type(id),
+            Options::value_type(
+                new OptionArgumentValue(
+                    std::string(get_default_value(id)))));
+    }
+    const _LIBOPTPARSE_::EnvironmentMatcher* matcher =
+        _image -> environment();
+    if (matcher != NULL &&
+        !_LIBOPTPARSE_::read_environment(
+            environ, *matcher, ImageSchema { *this }, parsed, report)) {
+        return std::unique_ptr<const Options>();
+    }
+    int tail = 0;
+    return _LIBOPTPARSE_::parse_command_line(
+        argc,
+        argv,
+        _program_info,
+        ImageSchema { *this },
+        _image,
+        std::move(parsed),
+        report,
+        stop_never,
+        tail);
+}
@@ -0,0 +1,110 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "liboptparse/config_file.hh"
+
+namespace {
+    bool is_blank(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    std::string_view trim(const char* begin, const char* end) {
+        while (begin != end && is_blank(*begin)) {
+            ++begin;
+        }
+        while (end != begin && is_blank(end[-1])) {
+            --end;
+        }
+        return std::string_view(begin, end - begin);
+    }
+}
+
+ConfigFile::ConfigFile() : _entries(), _address(NULL), _size(0) { }
+
+ConfigFile::~ConfigFile() {
+    clear();
+}
+
+ParseError ConfigFile::load(const std::string& path) {
+    clear();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return ParseError { unreadable_config_file, 0, 0 };
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        return ParseError { unreadable_config_file, 0, 0 };
+    }
+    std::size_t size = static_cast<std::size_t>(info.st_size);
+    if (size == 0) {
+        ::close(fd);
+        return ParseError { parse_ok, 0, 0 };
+    }
+    void* address = ::mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return ParseError { unreadable_config_file, 0, 0 };
+    }
+    ::madvise(address, size, MADV_SEQUENTIAL);
+    _address = address;
+    _size = size;
+
+    const char* current = static_cast<const char*>(address);
+    const char* end = current + size;
+    for (int line = 1; current < end; ++line) {
+        const char* newline = static_cast<const char*>(
+            std::memchr(current, '\n', end - current));
+        const char* line_end = newline != NULL ? newline : end;
+        std::string_view text = trim(current, line_end);
+        if (!text.empty() && text[0] != '#') {
+            std::size_t equal = text.find('=');
+            std::string_view key;
+            if (equal != std::string_view::npos) {
+                key = trim(text.data(), text.data() + equal);
+            }
+            if (key.empty()) {
+                int position = static_cast<int>(text.data() - current);
+                clear();
+                return ParseError { invalid_config_line, line, position };
+            }
+            _entries.push_back(ConfigEntry {
+                    key,
+                    trim(text.data() + equal + 1,
+                         text.data() + text.size()),
+                    line });
+        }
+        current = line_end + 1;
+    }
+    return ParseError { parse_ok, 0, 0 };
+}
+
+void ConfigFile::clear() noexcept {
+    if (_address != NULL) {
+        ::munmap(_address, _size);
+    }
+    _address = NULL;
+    _size = 0;
+    _entries.clear();
+}
@@ -0,0 +1,47 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "liboptparse/environment.hh"
+
+_LIBOPTPARSE_::EnvironmentMatcher::EnvironmentMatcher(
+    const OptionIndex& index,
+    std::string_view prefix)
+    : _index(index), _prefix(prefix), _names() { }
+
+void _LIBOPTPARSE_::EnvironmentMatcher::add(std::string_view env_name,
+                                            option_id id) {
+    _names.emplace(env_name, id);
+}
+
+option_id _LIBOPTPARSE_::EnvironmentMatcher::find(
+    std::string_view env_name,
+    bool& declared) const {
+    if (!_names.empty()) {
+        auto itr = _names.find(env_name);
+        if (itr != _names.end()) {
+            declared = true;
+            return itr -> second;
+        }
+    }
+    declared = false;
+    if (_prefix.empty() ||
+        env_name.size() <= _prefix.size() ||
+        env_name.compare(0, _prefix.size(), _prefix) != 0) {
+        return NO_OPTION_ID;
+    }
+    return _index.find_upper_case(env_name.substr(_prefix.size()));
+}
@@ -0,0 +1,411 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+#include "liboptparse/flat_options.hh"
+#include "liboptparse/static_parser_priv.hpp"
+
+namespace {
+    const char IMAGE_MAGIC[8] = { 'L', 'O', 'P', 'T', 'I', 'M', 'G', '\0' };
+    const std::uint32_t IMAGE_VERSION = 2;
+    const std::uint32_t NONE = UINT32_MAX;
+
+    /*! Text of the image: offset from the image and size. */
+    struct ImageText {
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    struct ImageHeader {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t options;
+        std::uint32_t arguments;
+        /*! Slots of the long names table, a power of two. */
+        std::uint32_t slots;
+        std::uint64_t size;
+        ImageText     program_name;
+        /*! Values of the repeated options. */
+        std::uint32_t values;
+        std::uint32_t padding;
+    };
+
+    struct ImageOption {
+        ImageText     long_name;
+        ImageText     value;
+        /*! Position of the first of its repeated values and count. */
+        std::uint32_t first_value;
+        std::uint32_t values;
+        std::uint8_t  short_name;
+        std::uint8_t  set;
+        std::uint8_t  padding[6];
+    };
+
+    /*
+     * Sections follow the header in this order: options by id, ids by
+     * short name, ids by long name hash, arguments, values of the
+     * repeated options grouped by id, texts.
+     */
+    const std::size_t SHORTS = 256;
+
+    static_assert(sizeof(ImageHeader) % 8 == 0 &&
+                  sizeof(ImageOption) % 8 == 0,
+                  "sections must keep the image aligned");
+
+    std::size_t slots_for(std::size_t options) {
+        std::size_t slots = 2;
+        while (slots < 2 * options) {
+            slots *= 2;
+        }
+        return slots;
+    }
+
+    /*! Offsets of the sections of an image. */
+    struct Layout {
+        std::size_t options;
+        std::size_t shorts;
+        std::size_t slots;
+        std::size_t arguments;
+        std::size_t values;
+        std::size_t texts;
+
+        Layout(std::size_t option_count,
+               std::size_t slot_count,
+               std::size_t argument_count,
+               std::size_t value_count) {
+            options = sizeof(ImageHeader);
+            shorts = options + option_count * sizeof(ImageOption);
+            slots = shorts + SHORTS * sizeof(std::uint32_t);
+            arguments = slots + slot_count * sizeof(std::uint32_t);
+            values = arguments + argument_count * sizeof(ImageText);
+            texts = values + value_count * sizeof(ImageText);
+        }
+    };
+
+    template<class T>
+    const T* section(const char* image, std::size_t offset) {
+        return reinterpret_cast<const T*>(image + offset);
+    }
+
+    /*! Sums the size of the texts of the options passed. */
+    std::size_t texts_size(const Options& options) {
+        std::size_t size = options.get_program_name().size();
+        for (option_id id = 0; id < options.size(); ++id) {
+            size += options.get_long_name(id).size() +
+                options.at_id(id) -> get_value().size();
+        }
+        for (auto itr = options.arguments_cbegin();
+             itr != options.arguments_cend();
+             ++itr) {
+            size += (*itr) -> get_value().size();
+        }
+        for (option_id id = 0; id < options.size(); ++id) {
+            for (std::string_view value : options.get_values(id)) {
+                size += value.size();
+            }
+        }
+        return size;
+    }
+
+    /*! Gets the number of values of the repeated options passed. */
+    std::size_t values_count(const Options& options) {
+        std::size_t count = 0;
+        for (option_id id = 0; id < options.size(); ++id) {
+            count += options.get_values(id).size();
+        }
+        return count;
+    }
+}
+
+FlatValue::operator bool() const {
+    return _LIBOPTPARSE_::stream_value<bool>(_value);
+}
+
+#define LIBOPTPARSE_FLAT_VALUE_CONVERSION(type)                 \
+    FlatValue::operator type() const {                          \
+        return _LIBOPTPARSE_::stream_value<type>(_value);       \
+    }
+
+LIBOPTPARSE_FLAT_VALUE_CONVERSION(int)
+LIBOPTPARSE_FLAT_VALUE_CONVERSION(short)
+LIBOPTPARSE_FLAT_VALUE_CONVERSION(long)
+LIBOPTPARSE_FLAT_VALUE_CONVERSION(unsigned short)
+LIBOPTPARSE_FLAT_VALUE_CONVERSION(unsigned long)
+LIBOPTPARSE_FLAT_VALUE_CONVERSION(unsigned int)
+LIBOPTPARSE_FLAT_VALUE_CONVERSION(float)
+LIBOPTPARSE_FLAT_VALUE_CONVERSION(double)
+
+#undef LIBOPTPARSE_FLAT_VALUE_CONVERSION
+
+FlatValue::operator std::string() const {
+    return std::string(_value);
+}
+
+std::string_view FlatValueSpan::operator[](
+    std::size_t position) const noexcept {
+    assert(position < _size);
+    const ImageText& text = static_cast<const ImageText*>(_texts)[position];
+    return std::string_view(_image + text.offset, text.size);
+}
+
+std::size_t FlatOptions::image_size(const Options& options) {
+    std::size_t arguments = std::distance(options.arguments_cbegin(),
+                                          options.arguments_cend());
+    Layout layout(options.size(), slots_for(options.size()), arguments,
+                  values_count(options));
+    std::size_t size = layout.texts + texts_size(options);
+    if (size > UINT32_MAX) {
+        throw std::length_error("options image larger than 4 GB");
+    }
+    /* Keep images placed one after the other aligned. */
+    return (size + 7) & ~std::size_t(7);
+}
+
+void FlatOptions::write_image(const Options& options, void* destination) {
+    assert(reinterpret_cast<std::uintptr_t>(destination) % 8 == 0);
+    std::size_t size = image_size(options);
+    std::size_t arguments = std::distance(options.arguments_cbegin(),
+                                          options.arguments_cend());
+    std::size_t slots = slots_for(options.size());
+    std::size_t values = values_count(options);
+    Layout layout(options.size(), slots, arguments, values);
+    char* image = static_cast<char*>(destination);
+    std::memset(image, 0, layout.texts);
+    std::size_t used = layout.texts;
+    auto add_text = [image, &used](std::string_view text) {
+        std::memcpy(image + used, text.data(), text.size());
+        ImageText reference = {
+            static_cast<std::uint32_t>(used),
+            static_cast<std::uint32_t>(text.size()) };
+        used += text.size();
+        return reference;
+    };
+
+    ImageHeader* header = reinterpret_cast<ImageHeader*>(image);
+    std::memcpy(header -> magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+    header -> version = IMAGE_VERSION;
+    header -> options = static_cast<std::uint32_t>(options.size());
+    header -> arguments = static_cast<std::uint32_t>(arguments);
+    header -> slots = static_cast<std::uint32_t>(slots);
+    header -> size = size;
+    header -> program_name = add_text(options.get_program_name());
+    header -> values = static_cast<std::uint32_t>(values);
+
+    ImageOption* entries =
+        reinterpret_cast<ImageOption*>(image + layout.options);
+    std::uint32_t* shorts =
+        reinterpret_cast<std::uint32_t*>(image + layout.shorts);
+    std::uint32_t* table =
+        reinterpret_cast<std::uint32_t*>(image + layout.slots);
+    std::fill(shorts, shorts + SHORTS, NONE);
+    std::fill(table, table + slots, NONE);
+    ImageText* value_texts =
+        reinterpret_cast<ImageText*>(image + layout.values);
+    std::uint32_t first_value = 0;
+    for (option_id id = 0; id < options.size(); ++id) {
+        std::string_view long_name = options.get_long_name(id);
+        char short_name = options.get_short_name(id);
+        entries[id].long_name = add_text(long_name);
+        entries[id].value = add_text(options.at_id(id) -> get_value());
+        entries[id].short_name = static_cast<std::uint8_t>(short_name);
+        entries[id].set = options.is_set(id);
+        ValueSpan repeated = options.get_values(id);
+        entries[id].first_value = first_value;
+        entries[id].values = static_cast<std::uint32_t>(repeated.size());
+        for (std::string_view value : repeated) {
+            value_texts[first_value++] = add_text(value);
+        }
+        if (short_name != '\0') {
+            shorts[static_cast<unsigned char>(short_name)] =
+                static_cast<std::uint32_t>(id);
+        }
+        if (!long_name.empty()) {
+            std::size_t slot = _LIBOPTPARSE_::hash_name(long_name) &
+                (slots - 1);
+            while (table[slot] != NONE) {
+                slot = (slot + 1) & (slots - 1);
+            }
+            table[slot] = static_cast<std::uint32_t>(id);
+        }
+    }
+    ImageText* texts =
+        reinterpret_cast<ImageText*>(image + layout.arguments);
+    for (auto itr = options.arguments_cbegin();
+         itr != options.arguments_cend();
+         ++itr) {
+        *texts++ = add_text((*itr) -> get_value());
+    }
+    std::memset(image + used, 0, size - used);
+}
+
+FlatOptions::FlatOptions(const void* image, std::size_t size)
+    : _image(static_cast<const char*>(image)),
+      _options(0),
+      _arguments(0),
+      _slots(0),
+      _values(0) {
+    assert(reinterpret_cast<std::uintptr_t>(image) % 8 == 0);
+    const ImageHeader* header = section<ImageHeader>(_image, 0);
+    if (size < sizeof(ImageHeader) ||
+        std::memcmp(header -> magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0 ||
+        header -> version != IMAGE_VERSION ||
+        header -> size > size) {
+        throw std::invalid_argument("not an options image");
+    }
+    Layout layout(header -> options, header -> slots, header -> arguments,
+                  header -> values);
+    bool valid = header -> slots != 0 &&
+        (header -> slots & (header -> slots - 1)) == 0 &&
+        layout.texts <= header -> size;
+    auto check = [&valid, header](const ImageText& text) {
+        valid = valid && text.offset <= header -> size &&
+            text.size <= header -> size - text.offset;
+    };
+    check(header -> program_name);
+    for (std::uint32_t id = 0; valid && id < header -> options; ++id) {
+        const ImageOption& entry =
+            section<ImageOption>(_image, layout.options)[id];
+        check(entry.long_name);
+        check(entry.value);
+        valid = valid && entry.first_value <= header -> values &&
+            entry.values <= header -> values - entry.first_value;
+    }
+    for (std::size_t i = 0; valid && i < SHORTS + header -> slots; ++i) {
+        std::uint32_t id = section<std::uint32_t>(_image, layout.shorts)[i];
+        valid = id == NONE || id < header -> options;
+    }
+    for (std::uint32_t i = 0; valid && i < header -> arguments; ++i) {
+        check(section<ImageText>(_image, layout.arguments)[i]);
+    }
+    for (std::uint32_t i = 0; valid && i < header -> values; ++i) {
+        check(section<ImageText>(_image, layout.values)[i]);
+    }
+    if (!valid) {
+        throw std::invalid_argument("corrupted options image");
+    }
+    _options = header -> options;
+    _arguments = header -> arguments;
+    _slots = header -> slots;
+    _values = header -> values;
+}
+
+FlatValue FlatOptions::at(char key) const noexcept {
+    option_id id = find_id(key);
+    assert(id != NO_OPTION_ID);
+    return at_id(id);
+}
+
+FlatValue FlatOptions::at(std::string_view long_name) const noexcept {
+    option_id id = find_id(long_name);
+    assert(id != NO_OPTION_ID);
+    return at_id(id);
+}
+
+FlatValue FlatOptions::at_id(option_id id) const noexcept {
+    assert(id < _options);
+    Layout layout(_options, _slots, _arguments, _values);
+    return FlatValue(
+        text(&section<ImageOption>(_image, layout.options)[id].value));
+}
+
+bool FlatOptions::is_set(option_id id) const noexcept {
+    assert(id < _options);
+    Layout layout(_options, _slots, _arguments, _values);
+    return section<ImageOption>(_image, layout.options)[id].set != 0;
+}
+
+FlatValueSpan FlatOptions::get_values(option_id id) const noexcept {
+    assert(id < _options);
+    Layout layout(_options, _slots, _arguments, _values);
+    const ImageOption& entry =
+        section<ImageOption>(_image, layout.options)[id];
+    return FlatValueSpan(
+        _image,
+        section<ImageText>(_image, layout.values) + entry.first_value,
+        entry.values);
+}
+
+FlatValueSpan FlatOptions::get_values(char key) const noexcept {
+    option_id id = find_id(key);
+    assert(id != NO_OPTION_ID);
+    return get_values(id);
+}
+
+FlatValueSpan FlatOptions::get_values(
+    std::string_view long_name) const noexcept {
+    option_id id = find_id(long_name);
+    assert(id != NO_OPTION_ID);
+    return get_values(id);
+}
+
+option_id FlatOptions::find_id(char key) const noexcept {
+    Layout layout(_options, _slots, _arguments, _values);
+    std::uint32_t id = section<std::uint32_t>(_image, layout.shorts)[
+        static_cast<unsigned char>(key)];
+    return id == NONE ? NO_OPTION_ID : id;
+}
+
+option_id FlatOptions::find_id(std::string_view long_name) const noexcept {
+    Layout layout(_options, _slots, _arguments, _values);
+    const ImageOption* entries =
+        section<ImageOption>(_image, layout.options);
+    const std::uint32_t* table =
+        section<std::uint32_t>(_image, layout.slots);
+    std::size_t slot = _LIBOPTPARSE_::hash_name(long_name) & (_slots - 1);
+    for (std::uint32_t probes = 0; probes < _slots; ++probes) {
+        std::uint32_t id = table[slot];
+        if (id == NONE) {
+            break;
+        }
+        if (text(&entries[id].long_name) == long_name) {
+            return id;
+        }
+        slot = (slot + 1) & (_slots - 1);
+    }
+    return NO_OPTION_ID;
+}
+
+std::size_t FlatOptions::size() const noexcept {
+    return _options;
+}
+
+std::size_t FlatOptions::arguments_size() const noexcept {
+    return _arguments;
+}
+
+std::string_view FlatOptions::get_argument(
+    std::size_t position) const noexcept {
+    assert(position < _arguments);
+    Layout layout(_options, _slots, _arguments, _values);
+    return text(&section<ImageText>(_image, layout.arguments)[position]);
+}
+
+std::string_view FlatOptions::get_program_name() const noexcept {
+    return text(&section<ImageHeader>(_image, 0) -> program_name);
+}
+
+std::string_view FlatOptions::text(const void* reference) const noexcept {
+    const ImageText* image_text =
+        static_cast<const ImageText*>(reference);
+    return std::string_view(_image + image_text -> offset,
+                            image_text -> size);
+}
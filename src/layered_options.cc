@@ -0,0 +1,100 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cassert>
+
+#include "liboptparse/layered_options.hh"
+
+LayeredOptions::LayeredOptions(layer_type base) : _layers() {
+    assert(base != NULL);
+    /* Room for command line, environment, config and base. */
+    _layers.reserve(4);
+    _layers.push_back(std::move(base));
+    assert(OK());
+}
+
+LayeredOptions& LayeredOptions::push(layer_type layer) {
+    assert(OK() && layer != NULL && layer -> size() == size());
+    _layers.push_back(std::move(layer));
+    assert(OK());
+    return *this;
+}
+
+std::size_t LayeredOptions::layers() const noexcept {
+    return _layers.size();
+}
+
+const LayeredOptions::layer_type& LayeredOptions::get_layer(
+    std::size_t position) const noexcept {
+    assert(OK() && position < _layers.size());
+    return _layers[position];
+}
+
+std::size_t LayeredOptions::find_layer(option_id id) const noexcept {
+    assert(OK() && id < size());
+    std::size_t position = _layers.size() - 1;
+    while (position > 0 && !_layers[position] -> is_set(id)) {
+        --position;
+    }
+    return position;
+}
+
+bool LayeredOptions::is_set(option_id id) const noexcept {
+    return _layers[find_layer(id)] -> is_set(id);
+}
+
+Options::value_type LayeredOptions::at_id(option_id id) const noexcept {
+    return _layers[find_layer(id)] -> at_id(id);
+}
+
+Options::value_type LayeredOptions::at(char key) const noexcept {
+    option_id id = _layers.front() -> find_id(key);
+    assert(OK() && id != NO_OPTION_ID);
+    return at_id(id);
+}
+
+Options::value_type LayeredOptions::at(
+    const std::string& long_name) const noexcept {
+    option_id id = _layers.front() -> find_id(long_name);
+    assert(OK() && id != NO_OPTION_ID);
+    return at_id(id);
+}
+
+ValueSpan LayeredOptions::get_values(option_id id) const noexcept {
+    return _layers[find_layer(id)] -> get_values(id);
+}
+
+ValueSpan LayeredOptions::get_values(char key) const noexcept {
+    option_id id = _layers.front() -> find_id(key);
+    assert(OK() && id != NO_OPTION_ID);
+    return get_values(id);
+}
+
+ValueSpan LayeredOptions::get_values(
+    const std::string& long_name) const noexcept {
+    option_id id = _layers.front() -> find_id(long_name);
+    assert(OK() && id != NO_OPTION_ID);
+    return get_values(id);
+}
+
+std::size_t LayeredOptions::size() const noexcept {
+    return _layers.front() -> size();
+}
+
+bool LayeredOptions::OK() const noexcept {
+    return !_layers.empty() && _layers.front() != NULL;
+}
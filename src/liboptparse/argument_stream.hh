@@ -0,0 +1,103 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      argument_stream.hh
+ * \brief     NUL-delimited arguments read from a file descriptor.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the source of the arguments parsed by
+ * OptionParser::parse_stream, like "xargs -0" reads them.
+ *
+ * Don't use this file directly! It is for internal use only.
+ */
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#ifndef LIBOPTPARSE_ARGUMENT_STREAM_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_ARGUMENT_STREAM_INCLUDE_GUARD_HH 1
+
+namespace _LIBOPTPARSE_ {
+    /*!
+     * \brief Arguments separated by '\0' read from a file descriptor.
+     *
+     * The descriptor is read in chunks into a buffer that holds only
+     * the argument being returned and the part of the chunk after
+     * it: an argument split by two chunks is moved to the front of
+     * the buffer before reading the next one. The buffer grows only
+     * to fit an argument longer than it, so memory does not depend
+     * on the number of arguments read.
+     */
+    class ArgumentStream {
+    public:
+        /*!
+         * Constructor with two parameters.
+         * \param fd         - Descriptor to read, it is not closed.
+         * \param chunk_size - Bytes read at once, greater than 0.
+         */
+        ArgumentStream(int fd, std::size_t chunk_size);
+
+        /*!
+         * Read the next argument. The one returned before is no more
+         * valid.
+         * \return The argument, a view with NULL data if there are no
+         *         more arguments or reading failed. The last argument
+         *         may miss its '\0'.
+         */
+        std::string_view next();
+
+        /*! Checks if reading the descriptor failed. */
+        bool failed() const noexcept {
+            return _failed;
+        }
+
+        /*! Gets the number of arguments returned by next. */
+        int count() const noexcept {
+            return _count;
+        }
+
+        /*! Gets the size of the buffer. */
+        std::size_t capacity() const noexcept {
+            return _buffer.size();
+        }
+
+        /*!
+         * Reader of ArgumentArray (see parser_priv.hpp): it returns
+         * the next argument of the stream passed.
+         */
+        static std::string_view read(const void* stream, int index);
+
+    private:
+        /*! Read a chunk after the data in the buffer. */
+        void fill();
+
+        int               _fd;
+        std::vector<char> _buffer;
+        /*! Data not yet returned is [_begin, _end). */
+        std::size_t       _begin;
+        std::size_t       _end;
+        int               _count;
+        bool              _eof;
+        bool              _failed;
+    };
+}
+
+#endif
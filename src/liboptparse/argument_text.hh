@@ -0,0 +1,108 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      argument_text.hh
+ * \brief     Text of a name or value read from the command line.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the view used by the tokenizer to refer to the
+ * text of the command line without copying it.
+ */
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#ifndef LIBOPTPARSE_ARGUMENT_TEXT_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_ARGUMENT_TEXT_INCLUDE_GUARD_HH 1
+
+/*!
+ * \brief View of a name or value inside an argument of argv.
+ *
+ * It does not own the text: it is valid as long as argv is. The
+ * text is kept as written on the command line, so it can contain
+ * escapes (a backslash followed by the escaped char); they are
+ * removed by the accessors below only when has_escapes is true.
+ */
+class ArgumentText {
+public:
+    /*! Default constructor. Initialize an empty text. */
+    constexpr ArgumentText() noexcept : _raw(), _escaped(false) { }
+
+    /*!
+     * Constructor with two parameters.
+     * \param raw     - Text as written on the command line.
+     * \param escaped - True if raw contains a backslash.
+     */
+    constexpr ArgumentText(std::string_view raw, bool escaped) noexcept
+        : _raw(raw), _escaped(escaped) { }
+
+    /*! Gets the text as written on the command line. */
+    constexpr std::string_view raw() const noexcept {
+        return _raw;
+    }
+
+    /*! Checks if the text contains escapes. */
+    constexpr bool has_escapes() const noexcept {
+        return _escaped;
+    }
+
+    /*! Checks if the text is empty. */
+    constexpr bool empty() const noexcept {
+        return _raw.empty();
+    }
+
+    /*! Gets the number of chars of the text without escapes. */
+    std::size_t size() const noexcept;
+
+    /*!
+     * Copy the text without escapes in the buffer passed.
+     * \param buffer - Buffer where copy the text.
+     * \param size   - Size of the buffer.
+     * \return The number of chars copied, at most size.
+     */
+    std::size_t copy(char* buffer, std::size_t size) const noexcept;
+
+    /*! Gets a copy of the text without escapes. */
+    std::string str() const;
+
+private:
+    std::string_view _raw;
+    bool             _escaped;
+};
+
+/*!
+ * Equality operator overload. It compares the text without escapes
+ * with the string passed, without copying it.
+ */
+bool operator==(const ArgumentText& text,
+                std::string_view other) noexcept;
+
+/*! Not equal operator overload. See operator==. */
+bool operator!=(const ArgumentText& text,
+                std::string_view other) noexcept;
+
+/*!
+ * ostream operator overload. It puts the text without escapes.
+ */
+std::ostream& operator<<(std::ostream& os, const ArgumentText& text);
+
+#endif
@@ -0,0 +1,133 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      binding.hh
+ * \brief     Destinations of option values.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the objects used to store the value of an
+ * option straight into a typed variable, or into a member of an
+ * object, while the command line is parsed (see
+ * OptionArgument::bind).
+ */
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+
+#ifndef LIBOPTPARSE_BINDING_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_BINDING_INCLUDE_GUARD_HH 1
+
+namespace _LIBOPTPARSE_ {
+    /*
+     * Conversions from the text of a value to the destination type.
+     * They return false, leaving the destination untouched, if the
+     * whole text is not a valid value of the type. Booleans accept
+     * "true" and "false" only.
+     */
+    bool convert_value(std::string_view text, bool& destination);
+    bool convert_value(std::string_view text, short& destination);
+    bool convert_value(std::string_view text, int& destination);
+    bool convert_value(std::string_view text, long& destination);
+    bool convert_value(std::string_view text, long long& destination);
+    bool convert_value(std::string_view text,
+                       unsigned short& destination);
+    bool convert_value(std::string_view text,
+                       unsigned int& destination);
+    bool convert_value(std::string_view text,
+                       unsigned long& destination);
+    bool convert_value(std::string_view text,
+                       unsigned long long& destination);
+    bool convert_value(std::string_view text, float& destination);
+    bool convert_value(std::string_view text, double& destination);
+    bool convert_value(std::string_view text, std::string& destination);
+
+    /*!
+     * \brief Destination of the values of an option.
+     */
+    class ValueBinder {
+    public:
+        /*! Virtual destructor. */
+        virtual ~ValueBinder();
+
+        /*!
+         * Convert the value passed into the destination.
+         * \param object - Object owning the destination, NULL if the
+         *                 destination is not a member.
+         * \param value  - Text of the value.
+         * \return False if the value is not valid for the type of the
+         *         destination.
+         *
+         * <h3> CONTRACT </h3>
+         * \pre object is an instance of get_object_type(), or NULL if
+         *      it is NULL.
+         */
+        virtual bool store(void* object,
+                           std::string_view value) const = 0;
+
+        /*!
+         * Gets the type of the object owning the destination.
+         * \return NULL if the destination is not a member.
+         */
+        virtual const std::type_info*
+        get_object_type() const noexcept = 0;
+    };
+
+    /*! \brief Destination pointed by a pointer. */
+    template<class T>
+    class PointerBinder : public ValueBinder {
+    public:
+        explicit PointerBinder(T* destination)
+            : _destination(destination) { }
+
+        bool store(void*, std::string_view value) const override {
+            return convert_value(value, *_destination);
+        }
+
+        const std::type_info* get_object_type() const noexcept override {
+            return NULL;
+        }
+
+    private:
+        T* _destination;
+    };
+
+    /*! \brief Destination member of an object of type C. */
+    template<class C, class T>
+    class MemberBinder : public ValueBinder {
+    public:
+        explicit MemberBinder(T C::* member) : _member(member) { }
+
+        bool store(void* object, std::string_view value) const override {
+            return convert_value(value,
+                                 static_cast<C*>(object) ->* _member);
+        }
+
+        const std::type_info* get_object_type() const noexcept override {
+            return &typeid(C);
+        }
+
+    private:
+        T C::* _member;
+    };
+}
+
+#endif
@@ -0,0 +1,219 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      command_parser.hh
+ * \brief     Parser of command lines with subcommands.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the parser of programs made of many
+ * subcommands, each one with its own options, like "prog [global
+ * options] command [command options]".
+ */
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "options.hh"
+#include "parse_result.hh"
+#include "parser.hh"
+
+#ifndef LIBOPTPARSE_COMMAND_PARSER_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_COMMAND_PARSER_INCLUDE_GUARD_HH 1
+
+/*!
+ * \brief Result of CommandParser::try_parse.
+ *
+ * It contains the global options, the name of the subcommand and its
+ * options, or the error that stopped the parse.
+ */
+class CommandResult {
+public:
+    /*!
+     * Constructor with three parameters. Initialize a successful
+     * result.
+     * \param global  - Global options. It must be not NULL.
+     * \param command - Name of the subcommand, empty if there is none.
+     * \param options - Options of the subcommand, NULL if there is
+     *                  none.
+     */
+    CommandResult(std::unique_ptr<const Options> global,
+                  std::string_view command,
+                  std::unique_ptr<const Options> options);
+
+    /*!
+     * Constructor with one parameter. Initialize a failed result.
+     * \param error - Error found. Its type must not be parse_ok.
+     */
+    explicit CommandResult(const ParseError& error);
+
+    /*! Move constructor. */
+    CommandResult(CommandResult&& result) = default;
+
+    /*! Default destructor. */
+    ~CommandResult();
+
+    /*! Checks if the parse succeeded. */
+    bool is_ok() const noexcept;
+
+    /*! Same as is_ok. */
+    explicit operator bool() const noexcept;
+
+    /*!
+     * Gets the error found. Its index refers to the whole argv, also
+     * when the error is inside the options of the subcommand.
+     */
+    const ParseError& get_error() const noexcept;
+
+    /*!
+     * Gets the name of the subcommand. It refers to argv.
+     * \return The first positional argument, empty if there is none
+     *         or the parse failed.
+     */
+    std::string_view get_command() const noexcept;
+
+    /*!
+     * Gets the options written before the subcommand, moving them out
+     * of this result.
+     */
+    std::unique_ptr<const Options> get_global_options() noexcept;
+
+    /*!
+     * Gets the options of the subcommand, moving them out of this
+     * result.
+     * \return The options, NULL if there is no subcommand, the parse
+     *         failed or they have already been taken.
+     */
+    std::unique_ptr<const Options> get_options() noexcept;
+
+private:
+    CommandResult(const CommandResult&);
+    CommandResult& operator=(const CommandResult&);
+
+    std::unique_ptr<const Options> _global;
+    std::unique_ptr<const Options> _options;
+    std::string_view               _command;
+    ParseError                     _error;
+};
+
+/*!
+ * \brief Parser of a program with subcommands.
+ *
+ * Options written before the first positional argument are parsed by
+ * the global parser; the first positional argument is the name of
+ * the subcommand and the rest of the command line is parsed by its
+ * parser. Response files enabled on the global parser may hold
+ * global options, but the subcommand name must be written in argv:
+ * the rest of argv is passed as is to the parser of the subcommand,
+ * which expands it if its own response files are enabled.
+ *
+ * The parser of a subcommand is registered as a factory: it is built
+ * only the first time its name is matched, so a program with many
+ * subcommands pays just for the one it runs. Names are looked up
+ * through an open addressing table of hashes computed when the
+ * subcommands are added.
+ */
+class CommandParser {
+public:
+    /*!
+     * Type definition of the function that configures the parser of
+     * a subcommand, adding its options.
+     */
+    typedef std::function<void(OptionParser& parser)> factory;
+
+    /*! Default constructor. */
+    CommandParser();
+
+    /*!
+     * Constructor with one parameter.
+     * \param program_info - Informations of the program, used by the
+     *                       global parser.
+     */
+    explicit CommandParser(const ProgramInfo& program_info);
+
+    /*! Not copyable: subcommands own their parsers. */
+    CommandParser(const CommandParser&) = delete;
+
+    /*! Default destructor */
+    ~CommandParser();
+
+    /*!
+     * Gets the parser of the options written before the subcommand.
+     * \return A reference to configure the global options.
+     */
+    OptionParser& get_global_parser() noexcept;
+
+    /*!
+     * Add a subcommand. Its factory is not called until the
+     * subcommand is used.
+     * \param name - Name of the subcommand, it must be not empty and
+     *               must not start with '-'.
+     * \param make - Function adding the options of the subcommand to
+     *               the parser passed.
+     * \return A reference to this parser to make a chain.
+     * \throw std::invalid_argument if the name is already used by an
+     *        other subcommand.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  Name passed must be valid, make not empty.
+     * \post The subcommand is registered and not built.
+     */
+    CommandParser& add(const std::string& name, factory make);
+
+    /*! Gets the number of subcommands added. */
+    std::size_t size() const noexcept;
+
+    /*!
+     * Checks if the parser of a subcommand has been built.
+     * \param name - Name of the subcommand.
+     * \return False if it has not been built or it does not exist.
+     */
+    bool is_built(std::string_view name) const noexcept;
+
+    /*!
+     * Gets the parser of a subcommand, building it if needed.
+     * \param name - Name of the subcommand.
+     * \return The parser, NULL if there is no subcommand with the
+     *         name passed.
+     */
+    OptionParser* find(std::string_view name);
+
+    /*!
+     * Parse the command line: global options, the subcommand name
+     * and the options of the subcommand. Only the parser of the
+     * subcommand found is built.
+     * \return The options and the subcommand found, or the first
+     *         error. A positional argument that is not the name of a
+     *         subcommand is an unknown_command error.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  argc less than equals size of argv vector.
+     * \post Options inside the result are VALID.
+     */
+    CommandResult try_parse(int argc, const char *argv[]);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> _pimpl;
+};
+
+#endif
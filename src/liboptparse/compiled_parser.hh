@@ -0,0 +1,189 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      compiled_parser.hh
+ * \brief     Parser reading its options from a binary image.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the parser whose options, with their lookup
+ * tables, are compiled once into a binary image: a program embeds
+ * the image or maps it from a file, instead of adding its options
+ * at each run.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "optargs.hh"
+#include "options.hh"
+#include "parse_result.hh"
+#include "program_info.hh"
+#include "response_file.hh"
+
+#ifndef LIBOPTPARSE_COMPILED_PARSER_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_COMPILED_PARSER_INCLUDE_GUARD_HH 1
+
+class OptionParser;
+
+/*!
+ * \brief Parser of the options compiled into a binary image.
+ *
+ * The image holds names, help, default values, metavars and env
+ * names of the options of an OptionParser, with the table of the
+ * short names and hash tables of the long names, as they are and in
+ * upper case, all referred by offsets, and the env prefix and
+ * response files limits of the parser: the environment and response
+ * files are read like OptionParser::try_parse does. It is read in
+ * place: opening it checks its header and offsets, nothing is built
+ * nor copied but a table of the env names, if any, so startup does
+ * not depend on the number of options. Parses build nothing from
+ * the image. Options are
+ * identified by the same ids they have in the OptionParser the
+ * image is made from, and parse returns the same options it
+ * returns.
+ *
+ * The image starts with a magic and a version, and it is in the byte
+ * order and word size of the machine that wrote it: it is meant to
+ * be built with the program. The options parsed keep the image
+ * alive, so they can outlive this parser.
+ */
+class CompiledParser {
+public:
+    /*!
+     * Gets the size of the image of the options of the parser
+     * passed.
+     * \throw std::length_error if the image would exceed 4 GB.
+     */
+    static std::size_t image_size(OptionParser& parser);
+
+    /*!
+     * Write the image of the options of the parser passed.
+     * \param destination - Memory of image_size(parser) bytes,
+     *                      aligned to 8 bytes.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  parser is valid, destination is aligned and large enough.
+     * \post destination holds an image CompiledParser can open.
+     */
+    static void write_image(OptionParser& parser, void* destination);
+
+    /*!
+     * Write the image of the options of the parser passed into the
+     * file passed, replacing it.
+     * \throw std::runtime_error if the file can not be written.
+     */
+    static void save(OptionParser& parser, const std::string& path);
+
+    /*!
+     * Constructor with two parameters. Open the image passed, e.g.
+     * embedded in the program: it must live as long as this parser
+     * and the options it returns.
+     * \param image - Beginning of the image, aligned to 8 bytes.
+     * \param size  - Bytes available from image.
+     * \throw std::invalid_argument if the image is not valid.
+     */
+    CompiledParser(const void* image, std::size_t size);
+
+    /*!
+     * Constructor with one parameter. Map the image saved in the
+     * file passed; the mapping lives as long as this parser or the
+     * options it returns.
+     * \throw std::invalid_argument if the file can not be read or the
+     *        image is not valid.
+     */
+    explicit CompiledParser(const std::string& path);
+
+    /*! Default destructor. */
+    ~CompiledParser();
+
+    /*! Gets the informations of the program. */
+    ProgramInfo& get_program_info() noexcept;
+
+    /*! Gets the number of options. */
+    std::size_t size() const noexcept;
+
+    /*!
+     * Gets the id of the option with the short name passed.
+     * \return The id of the option, NO_OPTION_ID if there is not.
+     */
+    option_id find(char short_name) const noexcept;
+
+    /*!
+     * Gets the id of the option with the long name passed.
+     * \return The id of the option, NO_OPTION_ID if there is not.
+     */
+    option_id find(std::string_view long_name) const noexcept;
+
+    /*
+     * Attributes of the option with the id passed, read in place.
+     * See the ones of OptionArgument. Ids must be less than size().
+     */
+    char get_short_name(option_id id) const noexcept;
+    std::string_view get_long_name(option_id id) const noexcept;
+    std::string_view get_help(option_id id) const noexcept;
+    std::string_view get_default_value(option_id id) const noexcept;
+    std::string_view get_metavar(option_id id) const noexcept;
+    std::string_view get_env_name(option_id id) const noexcept;
+    OptionArgumentType get_type(option_id id) const noexcept;
+
+    /*! Same as OptionParser::get_env_prefix. */
+    std::string_view get_env_prefix() const noexcept;
+
+    /*! Same as OptionParser::get_response_files. */
+    ResponseFileLimits get_response_files() const noexcept;
+
+    /*! Same as OptionParser::reads_environment. */
+    bool reads_environment() const noexcept;
+
+    /*! Same as OptionParser::parse. */
+    std::unique_ptr<const Options> parse(int argc, const char *argv[]);
+
+    /*! Same as OptionParser::try_parse. */
+    ParseResult try_parse(int argc, const char *argv[]);
+
+    /*! Same as OptionParser::try_parse collecting all errors. */
+    ParseResult try_parse(int argc,
+                          const char *argv[],
+                          std::vector<ParseError>& errors);
+
+private:
+    class Image;
+
+    /*!
+     * Implementation of the parses, over argv or the arguments of
+     * expanded response files.
+     */
+    template<class Argument, class ErrorReporter>
+    std::unique_ptr<const Options> parse(int argc,
+                                         const Argument* argv,
+                                         ErrorReporter& report);
+
+
+    /*! Image read, shared with the options parsed as their index. */
+    std::shared_ptr<const Image> _image;
+
+    /*! Informations of the program. */
+    ProgramInfo                  _program_info;
+};
+
+#endif
@@ -0,0 +1,118 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      config_file.hh
+ * \brief     Option values read from a "key = value" config file.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the loader of config files, whose values are
+ * merged under the command line by OptionParser::parse.
+ */
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "parse_result.hh"
+
+#ifndef LIBOPTPARSE_CONFIG_FILE_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_CONFIG_FILE_INCLUDE_GUARD_HH 1
+
+/*! \brief A "key = value" line of a config file. */
+struct ConfigEntry {
+    /*! Long name of the option, without "--". */
+    std::string_view key;
+
+    /*! Value of the option, taken literally. */
+    std::string_view value;
+
+    /*! Number of the line, starting from 1. */
+    int              line;
+};
+
+/*!
+ * \brief Entries of a config file.
+ *
+ * Each line is "key = value", where key is the long name of an
+ * option: blanks around key and value are dropped, the value is the
+ * rest of the line and it is taken literally, with no escapes. Empty
+ * lines and lines beginning with '#' are skipped.
+ *
+ * The file is mapped in memory and read in place: keys and values
+ * are slices of the mapping, which lives as long as this object, so
+ * nothing is copied until the entries are merged into the options
+ * (see OptionParser::parse(int, const char**, const ConfigFile&)).
+ */
+class ConfigFile {
+public:
+    /*! Default constructor. Initialize an empty config. */
+    ConfigFile();
+
+    /*! Default destructor. Unmap the file. */
+    ~ConfigFile();
+
+    /*!
+     * Load the config file passed, replacing the entries held by
+     * this object.
+     * \param path - Path of the file.
+     * \return The first error found, parse_ok if there is not:
+     *         unreadable_config_file if the file can not be read,
+     *         invalid_config_line with the number of the line if a
+     *         line has no '=' or no key.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  No preconditions.
+     * \post If no error is returned the entries are the ones of the
+     *       file, in order; otherwise there are no entries.
+     */
+    ParseError load(const std::string& path);
+
+    /*! Gets the entries, in the order of the file. */
+    const ConfigEntry* data() const noexcept {
+        return _entries.data();
+    }
+
+    /*! Gets the number of entries. */
+    std::size_t size() const noexcept {
+        return _entries.size();
+    }
+
+    const ConfigEntry* begin() const noexcept {
+        return _entries.data();
+    }
+
+    const ConfigEntry* end() const noexcept {
+        return _entries.data() + _entries.size();
+    }
+
+private:
+    ConfigFile(const ConfigFile&);
+    ConfigFile& operator=(const ConfigFile&);
+
+    /*! Unmap the file and drop the entries. */
+    void clear() noexcept;
+
+    std::vector<ConfigEntry> _entries;
+    void*                    _address;
+    std::size_t              _size;
+};
+
+#endif
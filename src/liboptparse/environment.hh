@@ -0,0 +1,147 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      environment.hh
+ * \brief     Option values taken from environment variables.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the matcher of environment variables to
+ * options used by OptionParser (see set_env_prefix).
+ *
+ * Don't use this file directly! It is for internal use only.
+ */
+
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "option_index.hh"
+
+#ifndef LIBOPTPARSE_ENVIRONMENT_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_ENVIRONMENT_INCLUDE_GUARD_HH 1
+
+namespace _LIBOPTPARSE_ {
+    /*!
+     * \brief Matcher of environment variables to options.
+     *
+     * A variable is matched to an option if its name has been
+     * declared by the option (see OptionArgument::set_env_name), or
+     * if it is the prefix followed by the long name of the option in
+     * upper case: with prefix "TOOL_" the variable TOOL_THREADS
+     * matches the option "threads" and TOOL_OUTPUTFILE the option
+     * "outputFile". Long names differing only by case can not be
+     * told apart this way, so none of them is matched by prefix.
+     * Prefixed variables are looked up in the index of the options
+     * (see OptionIndex::find_upper_case), so nothing is built for
+     * them at each parse.
+     * If an option is matched by both its declared variable and its
+     * prefixed one, the declared variable wins whatever their order
+     * in the environment; so each option gets at most one value.
+     * The environment is walked once whatever the number of options,
+     * and nothing is allocated while no variable matches.
+     */
+    class EnvironmentMatcher {
+    public:
+        /*!
+         * Constructor with two parameters.
+         * \param index  - Index of the long names of the options, it
+         *                 must live as long as this object.
+         * \param prefix - Prefix of the variables matched by long
+         *                 name, empty to match declared names only.
+         */
+        EnvironmentMatcher(const OptionIndex& index,
+                           std::string_view prefix);
+
+        /*!
+         * Add a variable name declared by an option.
+         * \param env_name - Name of the variable, it must live as long
+         *                   as this object.
+         * \param id       - Id of the option.
+         */
+        void add(std::string_view env_name, option_id id);
+
+        /*! Checks if no variable can be matched. */
+        bool empty() const noexcept {
+            return _prefix.empty() && _names.empty();
+        }
+
+        /*!
+         * Gets the option matched by the variable passed.
+         * \param env_name - Name of the variable.
+         * \param declared - Set to true if the name has been declared
+         *                   by the option.
+         * \return The id of the option, NO_OPTION_ID if there is not.
+         */
+        option_id find(std::string_view env_name, bool& declared) const;
+
+        /*!
+         * Walk the environment passed calling on_value with the value
+         * of each option matched, in order of id.
+         * \param envp     - Environment, NULL terminated array of
+         *                   "NAME=VALUE" strings.
+         * \param on_value - Callable with an option_id and the value
+         *                   of the variable as std::string_view.
+         */
+        template<class Callback>
+        void scan(const char* const* envp, Callback on_value) const {
+            if (empty()) {
+                return;
+            }
+            std::vector<Match> matches;
+            for (; *envp != NULL; ++envp) {
+                const char* equal = std::strchr(*envp, '=');
+                if (equal == NULL) {
+                    continue;
+                }
+                bool declared;
+                option_id id = find(std::string_view(*envp, equal - *envp),
+                                    declared);
+                if (id == NO_OPTION_ID) {
+                    continue;
+                }
+                if (matches.empty()) {
+                    matches.resize(_index.size());
+                }
+                if (declared || !matches[id].declared) {
+                    matches[id] = Match { equal + 1, declared };
+                }
+            }
+            for (option_id id = 0; id < matches.size(); ++id) {
+                if (matches[id].value != NULL) {
+                    on_value(id, std::string_view(matches[id].value));
+                }
+            }
+        }
+
+    private:
+        /*! Value of the variable matched by an option. */
+        struct Match {
+            const char* value;
+            bool        declared;
+        };
+
+        const OptionIndex&                              _index;
+        std::string_view                                _prefix;
+        std::unordered_map<std::string_view, option_id> _names;
+    };
+}
+
+#endif
@@ -0,0 +1,241 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      flat_options.hh
+ * \brief     Relocatable read-only image of Options.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the flat image of parsed options, made of
+ * offsets only, that can be placed in shared memory by a process and
+ * read in place by others.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "binding.hh"
+#include "options.hh"
+
+#ifndef LIBOPTPARSE_FLAT_OPTIONS_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_FLAT_OPTIONS_INCLUDE_GUARD_HH 1
+
+/*!
+ * \brief Value of an option read from a FlatOptions image.
+ *
+ * It converts to the same types of OptionArgumentValue, with the
+ * same results (see _LIBOPTPARSE_::stream_value). It also
+ * has operator* and operator-> yielding itself, so code written for
+ * the shared pointers returned by Options::at, like
+ * (int) *options.at("threads"), compiles unchanged.
+ */
+class FlatValue {
+public:
+    /*! Constructor with one parameter. */
+    explicit FlatValue(std::string_view value) noexcept
+        : _value(value) { }
+
+    /*! Gets the text of the value, inside the image. */
+    std::string_view get_value() const noexcept {
+        return _value;
+    }
+
+    /*! Gets the value as a list, see OptionArgumentValue::get_list. */
+    ListValue get_list(char delimiter = ',') const noexcept {
+        return ListValue(_value, delimiter);
+    }
+
+    const FlatValue& operator*() const noexcept {
+        return *this;
+    }
+
+    const FlatValue* operator->() const noexcept {
+        return this;
+    }
+
+    operator bool() const;
+    operator int() const;
+    operator short() const;
+    operator long() const;
+    operator unsigned short() const;
+    operator unsigned long() const;
+    operator unsigned int() const;
+    operator float() const;
+    operator double() const;
+    operator std::string() const;
+
+private:
+    std::string_view _value;
+};
+
+/*!
+ * \brief Values of a repeated option read from a FlatOptions image.
+ *
+ * It is the ValueSpan of an image: values are contiguous and read in
+ * place, by position, as long as the image lives.
+ */
+class FlatValueSpan {
+public:
+    /*! Default constructor. Initialize an empty array. */
+    constexpr FlatValueSpan() noexcept
+        : _image(NULL), _texts(NULL), _size(0) { }
+
+    /*!
+     * Constructor with three parameters.
+     * \param image - Beginning of the image.
+     * \param texts - Reference of the text of the first value.
+     * \param size  - Number of values.
+     */
+    constexpr FlatValueSpan(const char* image,
+                            const void* texts,
+                            std::size_t size) noexcept
+        : _image(image), _texts(texts), _size(size) { }
+
+    std::size_t size() const noexcept {
+        return _size;
+    }
+
+    bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    /*!
+     * Gets the value in the position passed.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  position less than size().
+     */
+    std::string_view operator[](std::size_t position) const noexcept;
+
+    /*! Same as ValueSpan::convert. */
+    template<class T>
+    bool convert(std::vector<T>& destination) const {
+        destination.reserve(destination.size() + _size);
+        for (std::size_t i = 0; i < _size; ++i) {
+            T value;
+            if (!_LIBOPTPARSE_::convert_value((*this)[i], value)) {
+                return false;
+            }
+            destination.push_back(std::move(value));
+        }
+        return true;
+    }
+
+private:
+    const char* _image;
+    const void* _texts;
+    std::size_t _size;
+};
+
+/*!
+ * \brief Options read from a flat image.
+ *
+ * The image holds names, values, the values of the repeated
+ * options, positional arguments and the hash tables used to look
+ * names up, all referred by offsets from its beginning: it has no
+ * pointers, so it can be written by a process into shared memory or
+ * a memfd and mapped read-only by others at any address. Reading it
+ * allocates nothing.
+ *
+ * The image is in the byte order of the machine that wrote it and
+ * it starts with a magic and a version checked when it is opened.
+ * It must be aligned to 8 bytes and live as long as this object.
+ */
+class FlatOptions {
+public:
+    /*!
+     * Gets the size of the image of the options passed.
+     * \throw std::length_error if the image would exceed 4 GB.
+     */
+    static std::size_t image_size(const Options& options);
+
+    /*!
+     * Write the image of the options passed.
+     * \param destination - Memory of image_size(options) bytes,
+     *                      aligned to 8 bytes.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  options is VALID, destination is aligned and large
+     *       enough.
+     * \post destination holds an image FlatOptions can open.
+     */
+    static void write_image(const Options& options, void* destination);
+
+    /*!
+     * Constructor with two parameters. Open the image passed.
+     * \param image - Beginning of the image, aligned to 8 bytes.
+     * \param size  - Bytes available from image.
+     * \throw std::invalid_argument if the image is not valid: wrong
+     *        magic or version, or offsets outside size.
+     */
+    FlatOptions(const void* image, std::size_t size);
+
+    /*! Gets the value of the option with the short name passed. */
+    FlatValue at(char key) const noexcept;
+
+    /*! Gets the value of the option with the long name passed. */
+    FlatValue at(std::string_view long_name) const noexcept;
+
+    /*! Gets the value of the option with the id passed. */
+    FlatValue at_id(option_id id) const noexcept;
+
+    /*! Same as Options::is_set. */
+    bool is_set(option_id id) const noexcept;
+
+    /*! Same as Options::get_values. */
+    FlatValueSpan get_values(option_id id) const noexcept;
+
+    /*! Same as Options::get_values. */
+    FlatValueSpan get_values(char key) const noexcept;
+
+    /*! Same as Options::get_values. */
+    FlatValueSpan get_values(std::string_view long_name) const noexcept;
+
+    /*! Same as Options::find_id. */
+    option_id find_id(char key) const noexcept;
+
+    /*! Same as Options::find_id. */
+    option_id find_id(std::string_view long_name) const noexcept;
+
+    /*! Gets the number of options. */
+    std::size_t size() const noexcept;
+
+    /*! Gets the number of positional arguments. */
+    std::size_t arguments_size() const noexcept;
+
+    /*! Gets the positional argument at the position passed. */
+    std::string_view get_argument(std::size_t position) const noexcept;
+
+    /*! Gets the name of the program. */
+    std::string_view get_program_name() const noexcept;
+
+private:
+    std::string_view text(const void* reference) const noexcept;
+
+    const char*   _image;
+    std::uint32_t _options;
+    std::uint32_t _arguments;
+    std::uint32_t _slots;
+    std::uint32_t _values;
+};
+
+#endif
@@ -0,0 +1,205 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      hasher.hh
+ * \brief     Fast non-cryptographic hash of sequences of fields.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the hash used to fingerprint command lines and
+ * option values.
+ *
+ * Don't use this file directly! It is for internal use only.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#ifndef LIBOPTPARSE_HASHER_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_HASHER_INCLUDE_GUARD_HH 1
+
+namespace _LIBOPTPARSE_ {
+    /*!
+     * Multiply the values passed into 128 bits and fold the halves.
+     */
+    inline std::uint64_t fold_multiply(std::uint64_t x,
+                                       std::uint64_t y) noexcept {
+#ifdef __SIZEOF_INT128__
+        unsigned __int128 product = static_cast<unsigned __int128>(x) * y;
+        return static_cast<std::uint64_t>(product) ^
+            static_cast<std::uint64_t>(product >> 64);
+#else
+        std::uint64_t product = (x ^ (x >> 32)) * y;
+        return product ^ (product >> 29);
+#endif
+    }
+
+    /*!
+     * \brief Hash of a sequence of fields, 64 or 128 bits.
+     *
+     * Fields are read 8 bytes at a time into two lanes mixed with
+     * different constants, and each field is closed by its length, so
+     * that sequences of fields with the same bytes, split in a
+     * different way, hash differently.
+     */
+    class Hasher {
+    public:
+        /*! Constructor with one parameter: the seed of the hash. */
+        explicit Hasher(std::uint64_t seed = 0) noexcept
+            : _low(seed ^ 0x243f6a8885a308d3ull),
+              _high(seed ^ 0x13198a2e03707344ull) { }
+
+        /*! Add a field made of the bytes passed. */
+        void add(std::string_view field) noexcept {
+            const char* data = field.data();
+            std::size_t size = field.size();
+            while (size >= 8) {
+                std::uint64_t word;
+                std::memcpy(&word, data, 8);
+                mix(word);
+                data += 8;
+                size -= 8;
+            }
+            std::uint64_t tail = 0;
+            std::memcpy(&tail, data, size);
+            mix(tail);
+            mix(field.size());
+        }
+
+        /*! Add a field made of the number passed. */
+        void add(std::uint64_t value) noexcept {
+            mix(value);
+        }
+
+        /*! Gets the 64 bits hash of the fields added. */
+        std::uint64_t digest() const noexcept {
+            return fold_multiply(_low ^ 0xa0761d6478bd642full,
+                                 _high ^ 0xe7037ed1a0b428dbull);
+        }
+
+        /*! Gets the low half of the 128 bits hash. */
+        std::uint64_t digest_low() const noexcept {
+            return fold_multiply(_low ^ 0x8ebc6af09c88c6e3ull,
+                                 0x589965cc75374cc3ull);
+        }
+
+        /*! Gets the high half of the 128 bits hash. */
+        std::uint64_t digest_high() const noexcept {
+            return fold_multiply(_high ^ 0x1d8e4e27c47d124full,
+                                 0xeb44accab455d165ull);
+        }
+
+    private:
+        void mix(std::uint64_t word) noexcept {
+            _low = fold_multiply(_low ^ word, 0x9e3779b97f4a7c15ull);
+            _high = fold_multiply(_high + word, 0xc2b2ae3d27d4eb4full);
+        }
+
+        std::uint64_t _low;
+        std::uint64_t _high;
+    };
+
+    /*!
+     * \brief Digest of option values and positional arguments, kept
+     *        up to date while they are set.
+     *
+     * Each value is hashed with its option id as seed and hashes are
+     * summed, lane by lane, so the digest does not depend on the order
+     * values are set in and replacing a value costs the hashes of the
+     * old and of the new one. Values are hashed as the strings they
+     * are, so an option set to its default value does not change the
+     * digest: callers store flags in a canonical form to hash them by
+     * their boolean value. Positional arguments are hashed in order.
+     */
+    class OptionsDigest {
+    public:
+        /*! Default constructor. Initialize an empty digest. */
+        OptionsDigest() noexcept
+            : _low(0), _high(0), _arguments(), _count(0) { }
+
+        /*! Add the value passed of the option with the id passed. */
+        void add_value(std::uint64_t id, std::string_view value) noexcept {
+            Hasher hasher(id);
+            hasher.add(value);
+            _low += hasher.digest_low();
+            _high += hasher.digest_high();
+        }
+
+        /*! Remove a value added before. */
+        void remove_value(std::uint64_t id,
+                          std::string_view value) noexcept {
+            Hasher hasher(id);
+            hasher.add(value);
+            _low -= hasher.digest_low();
+            _high -= hasher.digest_high();
+        }
+
+        /*!
+         * Add the value in the position passed of a repeated option:
+         * the same values in other order give other digests.
+         */
+        void add_repeated(std::uint64_t id,
+                          std::uint64_t position,
+                          std::string_view value) noexcept {
+            add_value(id + ((position + 1) << 32), value);
+        }
+
+        /*! Remove a value of a repeated option added before. */
+        void remove_repeated(std::uint64_t id,
+                             std::uint64_t position,
+                             std::string_view value) noexcept {
+            remove_value(id + ((position + 1) << 32), value);
+        }
+
+        /*! Add the next positional argument. */
+        void add_argument(std::string_view argument) noexcept {
+            _arguments.add(argument);
+            ++_count;
+        }
+
+        /*! Gets the low half of the 128 bits digest. */
+        std::uint64_t digest_low() const noexcept {
+            return finish().digest_low();
+        }
+
+        /*! Gets the high half of the 128 bits digest. */
+        std::uint64_t digest_high() const noexcept {
+            return finish().digest_high();
+        }
+
+    private:
+        Hasher finish() const noexcept {
+            Hasher hasher(_count);
+            hasher.add(_low);
+            hasher.add(_high);
+            hasher.add(_arguments.digest_low());
+            hasher.add(_arguments.digest_high());
+            return hasher;
+        }
+
+        std::uint64_t _low;
+        std::uint64_t _high;
+        Hasher        _arguments;
+        std::uint64_t _count;
+    };
+}
+
+#endif
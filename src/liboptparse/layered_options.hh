@@ -0,0 +1,174 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      layered_options.hh
+ * \brief     Options of several sources stacked by precedence.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the view used to look up options through
+ * several parse results, e.g. command line over environment over
+ * config file over defaults, without merging them.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "options.hh"
+
+#ifndef LIBOPTPARSE_LAYERED_OPTIONS_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_LAYERED_OPTIONS_INCLUDE_GUARD_HH 1
+
+/*!
+ * \brief Stack of Options looked up by precedence.
+ *
+ * Each layer is an Options parsed by the same parser. The value of
+ * an option is the one of the highest layer that set it (see
+ * Options::is_set), or the value of the base layer if none did:
+ * nothing is copied, each lookup checks one bit per layer from the
+ * top. Layers are shared and never changed, so a lower layer, like
+ * site-wide settings, can be shared by many views each with its own
+ * top layers.
+ * DEF := LayeredOptions is VALID if each layer is not null and all
+ *        layers have the same number of options.
+ */
+class LayeredOptions {
+public:
+    /*! Typedefinition for a layer. */
+    typedef std::shared_ptr<const Options> layer_type;
+
+    /*!
+     * Constructor with one parameter. Initialize a view with the
+     * layer passed only.
+     * \param base - Lowest layer, it gives the values of the options
+     *               not set by other layers.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  base is not null.
+     * \post This is a VALID object with one layer.
+     */
+    explicit LayeredOptions(layer_type base);
+
+    /*!
+     * Add a layer over the others: it takes precedence over them.
+     * \param layer - Layer to add.
+     * \return A reference to this object to make a chain.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is VALID, layer is not null and it has the same
+     *       number of options of the base.
+     * \post This is still VALID.
+     */
+    LayeredOptions& push(layer_type layer);
+
+    /*! Gets the number of layers, base included. */
+    std::size_t layers() const noexcept;
+
+    /*!
+     * Gets the layer at the position passed, 0 is the base.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is VALID and position less than layers().
+     * \post This is still VALID.
+     */
+    const layer_type& get_layer(std::size_t position) const noexcept;
+
+    /*!
+     * Gets the position of the layer giving the value of the option
+     * with the id passed.
+     * \return The position of the highest layer that set it, 0 if no
+     *         layer did.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is VALID and id less than size().
+     * \post This is still VALID.
+     */
+    std::size_t find_layer(option_id id) const noexcept;
+
+    /*!
+     * Checks if a layer set the option with the id passed.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is VALID and id less than size().
+     * \post This is still VALID.
+     */
+    bool is_set(option_id id) const noexcept;
+
+    /*!
+     * Gets the value of the option with the id passed, taken from
+     * the layer returned by find_layer.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is VALID and id less than size().
+     * \post This is still VALID and returned pointer is not NULL.
+     */
+    Options::value_type at_id(option_id id) const noexcept;
+
+    /*!
+     * Gets the value of the option with the short name passed.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is VALID and the options have the short name.
+     * \post This is still VALID and returned pointer is not NULL.
+     */
+    Options::value_type at(char key) const noexcept;
+
+    /*!
+     * Gets the value of the option with the long name passed.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is VALID and the options have the long name.
+     * \post This is still VALID and returned pointer is not NULL.
+     */
+    Options::value_type at(const std::string& long_name) const noexcept;
+
+    /*!
+     * Gets the values of the repeated option with the id passed,
+     * taken from the layer returned by find_layer: the values of the
+     * layers below are not merged.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is VALID and id less than size().
+     * \post This is still VALID.
+     */
+    ValueSpan get_values(option_id id) const noexcept;
+
+    /*! Same as get_values(option_id), by short name. */
+    ValueSpan get_values(char key) const noexcept;
+
+    /*! Same as get_values(option_id), by long name. */
+    ValueSpan get_values(const std::string& long_name) const noexcept;
+
+    /*! Gets the number of options of each layer. */
+    std::size_t size() const noexcept;
+
+private:
+    /*!
+     * Assertion method used to check if this object is valid. Layers
+     * are checked when they are added.
+     */
+    bool OK() const noexcept;
+
+    /*! Layers from the base to the top. */
+    std::vector<layer_type> _layers;
+};
+
+#endif
@@ -25,5 +25,14 @@
  * This is the module used as entry point on liboptparse.
  */
 
+#include "command_parser.hh"
+#include "compiled_parser.hh"
+#include "flat_options.hh"
+#include "layered_options.hh"
+#include "list_value.hh"
+#include "options_holder.hh"
+#include "parse_cache.hh"
 #include "optargs.hh"
 #include "parser.hh"
+#include "shell_split.hh"
+#include "static_parser.hh"
@@ -0,0 +1,96 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      list_value.hh
+ * \brief     Values made of a list of delimited items.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the view used to convert in bulk the value of
+ * an option holding a list, e.g. "--ids=1,2,3".
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#ifndef LIBOPTPARSE_LIST_VALUE_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_LIST_VALUE_INCLUDE_GUARD_HH 1
+
+/*!
+ * \brief Value made of items separated by a delimiter.
+ *
+ * Items are converted in bulk straight from the text, without
+ * splitting it into strings: integers are read eight digits at a
+ * time, and numbers that do not fit the fast path, e.g. with an
+ * exponent, are converted by std::from_chars. Items must be whole
+ * numbers in the std::from_chars format: no spaces, no leading '+'.
+ * An empty text has no items; an empty item is not valid.
+ */
+class ListValue {
+public:
+    /*!
+     * Constructor with two parameters.
+     * \param text      - Text of the list, it must live as long as
+     *                    this object.
+     * \param delimiter - Char separating the items.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  delimiter is not a digit, '-', '.', 'e' or 'E'.
+     */
+    constexpr explicit ListValue(std::string_view text,
+                                 char delimiter = ',') noexcept
+        : _text(text), _delimiter(delimiter) { }
+
+    /*! Gets the text of the list. */
+    std::string_view get_text() const noexcept {
+        return _text;
+    }
+
+    /*! Gets the char separating the items. */
+    char get_delimiter() const noexcept {
+        return _delimiter;
+    }
+
+    /*! Gets the number of items, counting the delimiters. */
+    std::size_t size() const noexcept;
+
+    /*!
+     * Convert the items into integers, appending them to the vector
+     * passed.
+     * \return False if an item is not a valid integer: the items
+     *         before it have been appended.
+     */
+    bool convert(std::vector<std::int64_t>& destination) const;
+
+    /*!
+     * Convert the items into doubles, appending them to the vector
+     * passed.
+     * \return False if an item is not a valid number: the items
+     *         before it have been appended.
+     */
+    bool convert(std::vector<double>& destination) const;
+
+private:
+    std::string_view _text;
+    char             _delimiter;
+};
+
+#endif
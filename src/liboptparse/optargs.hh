@@ -26,12 +26,37 @@
  * option arguments.
  */
 
+#include <cassert>
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <memory>
 
+#include "binding.hh"
+#include "list_value.hh"
+
 #ifndef LIBOPTARGS_OPTARGS_INCLUDE_GUARD_HH
 #define LIBOPTARGS_OPTARGS_INCLUDE_GUARD_HH 1
 
+namespace _LIBOPTPARSE_ {
+    /*!
+     * Convert the text of a value like the conversion operators of
+     * OptionArgumentValue and FlatValue do. It follows the rules of
+     * the standard input operator, so leading spaces and '+' are
+     * skipped and the chars after the value are ignored; a text that
+     * can not be read converts to 0 and values out of range to the
+     * nearest limit. Booleans are true only if the text starts with
+     * "true". The text is read in place with std::from_chars:
+     * nothing is allocated. Defined for bool, the integer types of
+     * the operators, float and double.
+     */
+    template<class T>
+    T stream_value(std::string_view text) noexcept;
+
+    template<>
+    bool stream_value<bool>(std::string_view text) noexcept;
+}
+
 /*!
  * \brief This represent a value of an option.
  *
@@ -142,6 +167,14 @@ public:
      */
     const std::string& get_value() const noexcept;
 
+    /*!
+     * Gets the value as a list of items separated by the delimiter
+     * passed, e.g. "1,2,3", to convert them in bulk.
+     * \param delimiter - Char separating the items.
+     * \return The list, a view on this value.
+     */
+    ListValue get_list(char delimiter = ',') const noexcept;
+
     /*!
      * Assignment operator overload. Assging to this object the same
      * value of the one passed as parameter.
@@ -189,6 +222,16 @@ bool operator!=(const OptionArgumentValue& first,
  */
 std::ostream& operator<<(std::ostream& os,
                          const OptionArgumentValue& value);
+/*!
+ * Type of the option ids. Each option added to a parser gets a dense
+ * id: the number of options added before it. Ids are used as array
+ * indexes, so lookups by id take constant time.
+ */
+typedef std::size_t option_id;
+
+/*! Id of an option not added to any parser. */
+const option_id NO_OPTION_ID = static_cast<option_id>(-1);
+
 /*!
  * This is an enumeration type representing the value type of an
  * argument.
@@ -202,16 +245,47 @@ enum OptionArgumentType {
     /*!
      * This type is used for arguments representing a simple flag that
      * does not accept any value and can be true or false. See useage
-     * documentation to know the right format.
+     * documentation to know the right format. Parsed options hold
+     * its value as "true" or "false", its default value included.
+     */
+    flag  = 1,
+    /*!
+     * This type is used for arguments with a value that can be given
+     * more than once, e.g. "-I dir1 -I dir2". Each value is appended
+     * to the ones before given by the same source, see
+     * Options::get_values; values given on the command line replace
+     * the ones of the environment, which replace the ones of a
+     * config file. The value of the option is its default one.
      */
-    flag  = 1
+    repeated = 2
+};
+
+/*!
+ * \brief Compile time description of an option.
+ *
+ * It is a literal type, so an array of specs can be checked and
+ * indexed at compile time by StaticOptionParser.
+ */
+struct OptionSpec {
+    /*! Short name of the option, '\0' if it has not. */
+    char               short_name;
+
+    /*! Long name of the option, NULL or empty if it has not. */
+    const char*        long_name;
+
+    /*! Type of the option. */
+    OptionArgumentType type;
+
+    /*! Default value of the option, NULL for the empty string. */
+    const char*        default_value;
 };
 
 /*!
  * \brief This class represent a single option argument.
  * DEF: OptionArgment is a VALID OPTION ARGUMENT if:
- *        - has a short name valid.
+ *        - has a short name valid or no short name ('\0').
  *        - if has a long name it is valid.
+ *        - has at least one name.
  */
 class OptionArgument {
 
@@ -243,6 +317,18 @@ public:
     explicit OptionArgument(char short_name,
                             const std::string& long_name);
 
+    /*!
+     * Constructor with one parameter. Initialize the option argument
+     * with the long name given and without short name.
+     * \param long_name - Long name to give to the option. It must
+     *                    be a valid not empty long name.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  long_name must be a valid not empty long name.
+     * \post The option argument is a valid OptionArgument
+     */
+    explicit OptionArgument(const std::string& long_name);
+
     /*!
      * Copy constructor. Initialize this object as a copy of the
      * one passed.
@@ -278,6 +364,16 @@ public:
      */
     char get_short_name() const noexcept;
 
+    /*!
+     * Checks if this option has a short name.
+     * \return False if the option has only the long name.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is a valid OptionArgument
+     * \post No postconditions.
+     */
+    bool has_short_name() const noexcept;
+
     /*!
      * Gets the long name.
      * \rerturn A valid long name.
@@ -352,6 +448,29 @@ public:
      */
     OptionArgument& set_metavar(const std::string& metavar) noexcept;
 
+    /*!
+     * Gets the name of the environment variable of this option.
+     * \return The name set by set_env_name, empty if there is not.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  No preconditions.
+     * \post No postconditions.
+     */
+    const std::string& get_env_name() const noexcept;
+
+    /*!
+     * Set the name of an environment variable whose value is used
+     * when the option is not given on the command line, see
+     * OptionParser::set_env_prefix.
+     * \param env_name - Name of the variable, empty for none.
+     * \return A reference to this object to make a chain.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  No preconditions.
+     * \post No postconditions.
+     */
+    OptionArgument& set_env_name(const std::string& env_name);
+
     /*!
      * Gets the type of this option. It is an enumeration used to know
      * what this argument represent: a valued option or a flag.
@@ -373,8 +492,71 @@ public:
      * \post No postconditions.
      */
     OptionArgument& set_type(OptionArgumentType value_type) noexcept;
+
+    /*!
+     * Gets the id of this option. It is given by the parser when the
+     * option is added and it is used to get the option's value from
+     * Options in constant time.
+     * \return The id of this option, NO_OPTION_ID if the option has
+     *         not been added to a parser.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  No preconditions.
+     * \post No postconditions.
+     */
+    option_id get_id() const noexcept;
+
+    /*!
+     * Bind this option to a variable: when the command line is
+     * parsed with OptionParser::try_parse_into, its value is
+     * converted and stored into the variable. The variable keeps its
+     * value if the option is not given.
+     * \param destination - Variable where store the value, it must
+     *                      live as long as this option. Supported
+     *                      types are bool, integers, float, double and
+     *                      std::string.
+     * \return A reference to this option to make a chain.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  destination is not NULL.
+     * \post No postconditions.
+     */
+    template<class T>
+    OptionArgument& bind(T* destination);
+
+    /*!
+     * Bind this option to a member of C: when the command line is
+     * parsed with OptionParser::try_parse_into passing an object of
+     * type C, the value is converted and stored into its member.
+     * \param member - Member where store the value. Supported types
+     *                 are the same of bind(T*).
+     * \return A reference to this option to make a chain.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  member is not NULL.
+     * \post No postconditions.
+     */
+    template<class C, class T>
+    OptionArgument& bind(T C::* member);
+
+    /*!
+     * Gets the destination of the values of this option.
+     * \return The destination set by bind, NULL if it is not bound.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  No preconditions.
+     * \post No postconditions.
+     */
+    const _LIBOPTPARSE_::ValueBinder* get_binder() const noexcept;
 private:
+    friend class OptionParser;
+
     OptionArgument& operator=(const OptionArgument&);
+
+    void set_id(option_id id) noexcept;
+
+    OptionArgument& set_binder(
+        std::shared_ptr<const _LIBOPTPARSE_::ValueBinder> binder) noexcept;
     
     class Impl;
     std::unique_ptr<Impl> _pimpl;
@@ -385,7 +567,8 @@ private:
  * \param first  - First element to compare.
  * \param second - Second element to compare.
  * \return True if the two arguments passed are equals. Two arguments
- *         are equals if short names are equals.
+ *         are equals if short names are equals. Arguments without
+ *         short name are equals if long names are equals.
  */
 bool operator==(const OptionArgument& first,
                 const OptionArgument& second);
@@ -399,4 +582,20 @@ bool operator==(const OptionArgument& first,
 bool operator!=(const OptionArgument& first,
                 const OptionArgument& second);
 
+template<class T>
+OptionArgument& OptionArgument::bind(T* destination) {
+    assert(destination != NULL);
+    return set_binder(
+        std::make_shared<const _LIBOPTPARSE_::PointerBinder<T>>(
+            destination));
+}
+
+template<class C, class T>
+OptionArgument& OptionArgument::bind(T C::* member) {
+    assert(member != NULL);
+    return set_binder(
+        std::make_shared<const _LIBOPTPARSE_::MemberBinder<C, T>>(
+            member));
+}
+
 #endif
@@ -0,0 +1,240 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      option_index.hh
+ * \brief     Index from option names to option ids.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the index used to translate short and long
+ * names to the dense ids of the options. It is for internal use
+ * only, do not include this header in your project file.
+ */
+
+#include <climits>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "optargs.hh"
+
+#ifndef LIBOPTPARSE_OPTION_INDEX_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_OPTION_INDEX_INCLUDE_GUARD_HH 1
+
+namespace _LIBOPTPARSE_ {
+    /*! Gets the char passed in upper case, only ASCII letters change. */
+    constexpr char upper_case(char c) noexcept {
+        return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+
+    /*! Checks if the names passed are equal but for the case. */
+    inline bool equal_upper_case(std::string_view first,
+                                 std::string_view second) noexcept {
+        if (first.size() != second.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < first.size(); ++i) {
+            if (upper_case(first[i]) != upper_case(second[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*! Gets the FNV-1a hash of the name passed in upper case. */
+    inline std::uint64_t hash_upper_case(std::string_view name) noexcept {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        for (char c : name) {
+            hash ^= static_cast<unsigned char>(upper_case(c));
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    /*! Checks if the name passed has no lower case ASCII letter. */
+    inline bool is_upper_case(std::string_view name) noexcept {
+        for (char c : name) {
+            if (c != upper_case(c)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*!
+     * \brief Index from option names to option ids.
+     *
+     * Ids are dense, starting from 0, so they can be used as index
+     * of a vector. Short names are looked up in a table with an
+     * entry for each char, filled by the derived class; long names
+     * lookup depends on the derived class.
+     * DEF: OptionIndex is a VALID OptionIndex if each id has at
+     *      least one name and names identify at most one id.
+     */
+    class OptionIndex {
+    public:
+        /*!
+         * Gets the id of the option with the short name passed.
+         * \return The id of the option, NO_OPTION_ID if there is not.
+         */
+        option_id find(char short_name) const noexcept {
+            return _shorts[static_cast<unsigned char>(short_name)];
+        }
+
+        /*!
+         * Gets the id of the option with the long name passed.
+         * \return The id of the option, NO_OPTION_ID if there is not.
+         */
+        virtual option_id find(
+            std::string_view long_name) const noexcept = 0;
+
+        /*!
+         * Gets the short name of the option with the id passed.
+         * \return The short name, '\0' if it has not.
+         */
+        virtual char get_short_name(option_id id) const noexcept = 0;
+
+        /*!
+         * Gets the long name of the option with the id passed.
+         * \return The long name, empty if it has not.
+         */
+        virtual std::string_view get_long_name(
+            option_id id) const noexcept = 0;
+
+        /*! Gets the number of options in the index. */
+        virtual std::size_t size() const noexcept = 0;
+
+        /*!
+         * Gets the id of the option whose long name, in upper case, is
+         * the name passed: e.g. "OUTPUTFILE" finds "outputFile". Long
+         * names differing only by case are not found this way. This
+         * implementation walks the long names: derived classes with a
+         * hash table override it.
+         * \return The id of the option, NO_OPTION_ID if there is not,
+         *         if it is ambiguous or if the name passed has lower
+         *         case letters.
+         */
+        virtual option_id find_upper_case(
+            std::string_view name) const noexcept;
+
+    protected:
+        /*!
+         * Constructor with one parameter.
+         * \param shorts - Table with UCHAR_MAX + 1 entries: the id of
+         *                 the option for each short name. It must
+         *                 live as long as this object.
+         */
+        constexpr explicit OptionIndex(const option_id* shorts)
+            : _shorts(shorts) { }
+
+        /*! Not virtual: indexes are never deleted through it. */
+        ~OptionIndex() = default;
+
+        OptionIndex(const OptionIndex&) = default;
+        OptionIndex& operator=(const OptionIndex&) = default;
+
+        /*! Table used by find(char). */
+        const option_id* _shorts;
+    };
+
+    /*!
+     * \brief Index filled at runtime as options are added.
+     *
+     * Ids are assigned in insertion order, long names are looked up
+     * through a hash table.
+     */
+    class HashOptionIndex : public OptionIndex {
+    public:
+        /*! Default constructor. Initialize an empty index. */
+        HashOptionIndex();
+
+        /*! Copy constructor. */
+        HashOptionIndex(const HashOptionIndex& index);
+
+        /*! Default destructor. */
+        ~HashOptionIndex();
+
+        /*!
+         * Add an option with the names passed.
+         * \param short_name - Short name of the option, '\0' if it
+         *                     has not.
+         * \param long_name  - Long name of the option, empty if it
+         *                     has not.
+         * \return The id given to the option: the number of options
+         *         added before it.
+         *
+         * <h3> CONTRACT </h3>
+         * \pre  At least one name is given and names are not in the
+         *       index yet.
+         * \post The option is found by each of its names.
+         */
+        option_id add(char short_name, const std::string& long_name);
+
+        using OptionIndex::find;
+
+        option_id find(
+            std::string_view long_name) const noexcept override;
+
+        char get_short_name(option_id id) const noexcept override;
+
+        std::string_view get_long_name(
+            option_id id) const noexcept override;
+
+        std::size_t size() const noexcept override;
+
+        option_id find_upper_case(
+            std::string_view name) const noexcept override;
+
+    private:
+        HashOptionIndex& operator=(const HashOptionIndex&);
+
+        struct UpperCaseHash {
+            std::size_t operator()(std::string_view name) const noexcept {
+                return static_cast<std::size_t>(hash_upper_case(name));
+            }
+        };
+
+        struct UpperCaseEqual {
+            bool operator()(std::string_view first,
+                            std::string_view second) const noexcept {
+                return equal_upper_case(first, second);
+            }
+        };
+
+        /*! Index the long name of the option with the id passed. */
+        void add_long_name(option_id id);
+
+        option_id                                       _table[UCHAR_MAX + 1];
+        std::unordered_map<std::string_view, option_id> _longs;
+        /*!
+         * Long names hashed and compared but for the case, see
+         * find_upper_case: NO_OPTION_ID if ambiguous.
+         */
+        std::unordered_map<std::string_view, option_id,
+                           UpperCaseHash, UpperCaseEqual> _uppers;
+        std::vector<char>                               _short_names;
+        /*! Long names storage, a deque keeps them at the same address. */
+        std::deque<std::string>                         _long_names;
+    };
+}
+
+#endif
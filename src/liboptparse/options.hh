@@ -26,22 +26,63 @@
  * the options of the cli in a high level way.
  */
 
+#include "hasher.hh"
 #include "optargs.hh"
+#include "option_index.hh"
 #include "program_info.hh"
+#include "repeated_values.hh"
+#include <cstdint>
+#include <iterator>
 #include <list>
 #include <map>
 #include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #ifndef LIBOTPPARSE_OPTIONS_INCLUDE_GUARD_HH
 #define LIBOTPPARSE_OPTIONS_INCLUDE_GUARD_HH 1
 
+/*!
+ * \brief Fingerprint of the effective values of Options.
+ *
+ * It is a 128 bits hash of the value of each option, by id, and of
+ * the positional arguments, in order. It depends only on the values:
+ * an option set to its default value, by the command line or
+ * otherwise, has the same fingerprint as one left to the default,
+ * and options set in any order have the same fingerprint. Flags are
+ * hashed by their boolean value, so a flag left unset and one set
+ * to false are equal; other values are compared as text, so
+ * "--threads=04" and "4" differ. Program name is not part of it. It
+ * is meant to key caches, it is not a cryptographic hash.
+ */
+struct OptionsFingerprint {
+    std::uint64_t low;
+    std::uint64_t high;
+
+    /*! Gets the 64 bits fingerprint. */
+    std::uint64_t value() const noexcept {
+        return low;
+    }
+
+    bool operator==(const OptionsFingerprint& other) const noexcept {
+        return low == other.low && high == other.high;
+    }
+
+    bool operator!=(const OptionsFingerprint& other) const noexcept {
+        return !(*this == other);
+    }
+};
+
 /*!
  * This is the object used to take trace of the pair key value of
- * the parsed options.
- * DEF := Options object is a VALID OPTIONS if its options and
- *        arguments pointer to the containers are not null,  each
- *        element inside theme are not null and program_info is not
- *        null and valid.
+ * the parsed options. Values are stored in an array indexed by
+ * option id, short and long names are looked up through the index
+ * shared with the parser.
+ * DEF := Options object is a VALID OPTIONS if its index, values and
+ *        arguments pointers are not null, there is a value for each
+ *        option in the index, each element inside theme are not null
+ *        and program_info is not null and valid.
  */
 class Options {
 
@@ -51,12 +92,27 @@ public:
      * container.
      */
     typedef std::shared_ptr<const OptionArgumentValue> value_type;
-    /*! Typedefinition for the container used for options. */
+    /*!
+     * Typedefinition for the container used to initialize options
+     * by short name.
+     */
     typedef std::map<char, value_type>     options_container;
+    /*! Typedefinition for the container of values, indexed by id. */
+    typedef std::vector<value_type>        values_container;
+    /*!
+     * Typedefinition for the flags telling, by id, which options have
+     * been set by the source parsed, see is_set.
+     */
+    typedef std::vector<bool>              given_container;
     /*! Typedefinition for the container used for plain aguments. */
     typedef std::list<value_type>          arguments_container;
-    /*! Typedefinition for option's container. */
-    typedef options_container::const_iterator options_const_iterator;
+    /*!
+     * Iterator on the pairs short name, value of the options with a
+     * short name, ordered by short name.
+     */
+    class options_const_iterator;
+    /*! Typedefinition for value's container. */
+    typedef values_container::const_iterator values_const_iterator;
     /*! Typedefinition for argument's container */
     typedef arguments_container::const_iterator arguments_const_iterator;
 
@@ -108,6 +164,43 @@ public:
         OptsForwardIterator opts_begin,
         OptsForwardIterator opts_end);
 
+    /*!
+     * Constructor with 8 parameters. Initialize this object with the
+     * values of the options in the index passed and the arguments
+     * passed as range parameters. This is the constructor used by
+     * the parser.
+     * \param progrom_info - Program info object used to initialize
+     *                       Options object with the information
+     *                       contained in it.
+     * \param index        - Index of the options. It is shared, not
+     *                       copied, and it must not change anymore.
+     * \param values       - Value of each option in the index,
+     *                       indexed by option id.
+     * \param given        - For each option, true if its value has
+     *                       been set by the source parsed, false if
+     *                       it is the default one.
+     * \param fingerprint  - Fingerprint of values and arguments,
+     *                       computed while they are set.
+     * \param repeated     - Values of the repeated options, frozen
+     *                       by this constructor.
+     * \param args_begin   - Iterator to the begin of arguments set.
+     * \param args_end     - Iterator to the end of arguments set.
+     *
+     * \tparam ArgsForwardIterator - Forward iterator for arguments.
+     *                               It must contains value_type
+     *                               objects.
+     */
+    template<class ArgsForwardIterator>
+    Options(
+        const ProgramInfo&  program_info,
+        std::shared_ptr<const _LIBOPTPARSE_::OptionIndex> index,
+        values_container&&  values,
+        given_container&&   given,
+        const OptionsFingerprint& fingerprint,
+        _LIBOPTPARSE_::RepeatedValues&& repeated,
+        ArgsForwardIterator args_begin,
+        ArgsForwardIterator args_end);
+
     
     /*! Destructor. It destroys the pointer to the dictionary. */
     ~Options();
@@ -143,6 +236,159 @@ public:
      */
     value_type operator[](char key) const noexcept;
 
+    /*!
+     * Gets the value of the option with the long name passed.
+     * \param  long_name - Long name of the option to get.
+     * \return Value of the option represented by the long name.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is a valid object and an option with the long name
+     *       passed must be contained in this object.
+     * \post This is still a valid object and returned pointer is not
+     *        NULL
+     */
+    value_type at(const std::string& long_name) const noexcept;
+
+    /*!
+     * Gets the value of the option with the id passed. It is a
+     * direct array access.
+     * \param  id - Id of the option, see OptionArgument::get_id.
+     * \return Value of the option with the id passed.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is a valid object and id less than size().
+     * \post This is still a valid object and returned pointer is not
+     *        NULL
+     */
+    value_type at_id(option_id id) const noexcept;
+
+    /*!
+     * Checks if the option with the id passed has been set by the
+     * source parsed: the command line, the environment or a config
+     * file. Options not set hold their default value. Options built
+     * from a container of values are all set. It is a bit test.
+     * \param  id - Id of the option, see OptionArgument::get_id.
+     * \return True if the option has been set.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is a valid object and id less than size().
+     * \post This is still a valid object.
+     */
+    bool is_set(option_id id) const noexcept;
+
+    /*!
+     * Gets the values of the repeated option with the id passed, in
+     * the order they have been given. Values are contiguous and live
+     * as long as this object. Options of the other types have none.
+     * \param  id - Id of the option, see OptionArgument::get_id.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is a valid object and id less than size().
+     * \post This is still a valid object.
+     */
+    ValueSpan get_values(option_id id) const noexcept;
+
+    /*!
+     * Gets the values of the repeated option with the short name
+     * passed, see get_values(option_id).
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is a valid object and key passed as parameter must
+     *       be contained in this object.
+     * \post This is still a valid object.
+     */
+    ValueSpan get_values(char key) const noexcept;
+
+    /*!
+     * Gets the values of the repeated option with the long name
+     * passed, see get_values(option_id).
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is a valid object and an option with the long name
+     *       passed must be contained in this object.
+     * \post This is still a valid object.
+     */
+    ValueSpan get_values(const std::string& long_name) const noexcept;
+
+    /*!
+     * Gets the id of the option with the short name passed.
+     * \return The id of the option, NO_OPTION_ID if there is not.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This must be a valid.
+     * \post This is still valid.
+     */
+    option_id find_id(char key) const noexcept;
+
+    /*!
+     * Gets the id of the option with the long name passed.
+     * \return The id of the option, NO_OPTION_ID if there is not.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This must be a valid.
+     * \post This is still valid.
+     */
+    option_id find_id(std::string_view long_name) const noexcept;
+
+    /*!
+     * Gets the short name of the option with the id passed.
+     * \return The short name, '\0' if it has not.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is a valid object and id less than size().
+     * \post This is still a valid object.
+     */
+    char get_short_name(option_id id) const noexcept;
+
+    /*!
+     * Gets the long name of the option with the id passed.
+     * \return The long name, empty if it has not.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This is a valid object and id less than size().
+     * \post This is still a valid object.
+     */
+    std::string_view get_long_name(option_id id) const noexcept;
+
+    /*!
+     * Gets the number of options, that is the number of values.
+     * \return The number of options.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This must be a valid.
+     * \post This is still valid.
+     */
+    std::size_t size() const noexcept;
+
+    /*!
+     * Gets the fingerprint of the values and arguments. Parsers
+     * compute it while they set them, so it costs nothing here.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This must be a valid.
+     * \post This is still valid.
+     */
+    const OptionsFingerprint& get_fingerprint() const noexcept;
+
+    /*!
+     * Gets a const iterator to the value of the option with id 0.
+     * Values are ordered by id.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This must be a valid.
+     * \post This is still valid.
+     */
+    values_const_iterator values_cbegin() const noexcept;
+
+    /*!
+     * Gets a const iterator to the next value after the last one.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This must be a valid.
+     * \post This is still valid.
+     */
+    values_const_iterator values_cend() const noexcept;
+
     /*!
      * Gets a const iterator to the begin of the options collection.
      * \return An iterator pointing to the begin of the options
@@ -212,6 +458,57 @@ private:
     std::unique_ptr<Impl> _pimpl;
 };
 
+/*!
+ * \brief Iterator on the options with a short name.
+ *
+ * It walks the short names of the index and yields the pairs short
+ * name, value like a std::map<char, value_type> iterator does.
+ */
+class Options::options_const_iterator {
+public:
+    /*! Category of the iterator. */
+    typedef std::forward_iterator_tag                iterator_category;
+    /*! Pair short name, value. */
+    typedef std::pair<char, Options::value_type>     value_type;
+    /*! Difference type. */
+    typedef std::ptrdiff_t                           difference_type;
+    /*! Pointer type. */
+    typedef const value_type*                        pointer;
+    /*! Reference type. */
+    typedef const value_type&                        reference;
+
+    /*! Default constructor. Initialize a singular iterator. */
+    options_const_iterator();
+
+    /*!
+     * Constructor with three parameters. Initialize the iterator on
+     * the first option with a short name greater or equal to the
+     * one passed.
+     * \param index      - Index of the options.
+     * \param values     - Values of the options.
+     * \param short_name - First short name to check as unsigned
+     *                     char, UCHAR_MAX + 1 for the end.
+     */
+    options_const_iterator(const _LIBOPTPARSE_::OptionIndex* index,
+                           const Options::values_container* values,
+                           int short_name);
+
+    reference operator*() const noexcept;
+    pointer operator->() const noexcept;
+    options_const_iterator& operator++() noexcept;
+    options_const_iterator operator++(int) noexcept;
+    bool operator==(const options_const_iterator& other) const noexcept;
+    bool operator!=(const options_const_iterator& other) const noexcept;
+
+private:
+    void load() noexcept;
+
+    const _LIBOPTPARSE_::OptionIndex* _index;
+    const Options::values_container*  _values;
+    int                               _short_name;
+    value_type                        _current;
+};
+
 #include "options_priv.hpp"
 
 #endif
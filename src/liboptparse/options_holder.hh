@@ -0,0 +1,220 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      options_holder.hh
+ * \brief     Options reloaded at runtime and read without locks.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the holder used by long running programs to
+ * replace their options, e.g. re-reading the config file on SIGHUP,
+ * while other threads keep reading them.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "options.hh"
+#include "parse_result.hh"
+
+#ifndef LIBOPTPARSE_OPTIONS_HOLDER_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_OPTIONS_HOLDER_INCLUDE_GUARD_HH 1
+
+class OptionParser;
+
+/*!
+ * \brief Current Options of a program, replaced read-copy-update
+ *        style.
+ *
+ * The options held are never changed: publish replaces them with a
+ * new snapshot through an atomic pointer swap, and the old snapshot
+ * is deleted once no reader can still see it. Readers announce the
+ * epoch they read in, in a slot of their own, before loading the
+ * pointer; the writer deletes a snapshot retired in an epoch older
+ * than all the announced ones. Reading takes a fixed number of
+ * atomic operations on the reader's own cache line and the shared
+ * pointer: no locks, no reference counts, so readers never wait.
+ * Writers are serialized by a mutex.
+ *
+ * Each reader thread reads through a Reader, taken once:
+ * \code
+ * OptionsHolder::Reader reader = holder.make_reader();
+ * while (serving) {
+ *     OptionsHolder::Snapshot options = reader.read();
+ *     use(options -> at("threads"));
+ * }
+ * \endcode
+ */
+class OptionsHolder {
+private:
+    /*! Epoch announced by a reader, on a cache line of its own. */
+    struct alignas(64) Slot {
+        /*! Epoch of the snapshot being read, 0 if none. */
+        std::atomic<std::uint64_t> epoch;
+        /*! True if a Reader owns the slot. */
+        std::atomic<bool>          used;
+    };
+
+public:
+    /*!
+     * \brief Options being read, valid as long as this object.
+     *
+     * It must be destroyed before the next read of its Reader.
+     */
+    class Snapshot {
+    public:
+        Snapshot(Snapshot&& other) noexcept;
+        ~Snapshot();
+
+        const Options& operator*() const noexcept {
+            return *_options;
+        }
+
+        const Options* operator->() const noexcept {
+            return _options;
+        }
+
+    private:
+        friend class OptionsHolder;
+
+        Snapshot(Slot* slot, const Options* options) noexcept
+            : _slot(slot), _options(options) { }
+
+        Snapshot(const Snapshot&);
+        Snapshot& operator=(const Snapshot&);
+
+        Slot*          _slot;
+        const Options* _options;
+    };
+
+    /*!
+     * \brief Handle used by one thread to read the options.
+     *
+     * It owns a slot of the holder until it is destroyed.
+     */
+    class Reader {
+    public:
+        Reader(Reader&& other) noexcept;
+        ~Reader();
+
+        /*!
+         * Gets the current options. It is wait-free.
+         *
+         * <h3> CONTRACT </h3>
+         * \pre  No Snapshot of this reader is alive.
+         * \post The snapshot is valid until it is destroyed.
+         */
+        Snapshot read() const noexcept;
+
+    private:
+        friend class OptionsHolder;
+
+        Reader(const OptionsHolder* holder, Slot* slot) noexcept
+            : _holder(holder), _slot(slot) { }
+
+        Reader(const Reader&);
+        Reader& operator=(const Reader&);
+
+        const OptionsHolder* _holder;
+        Slot*                _slot;
+    };
+
+    /*!
+     * Constructor with two parameters.
+     * \param options     - First options held.
+     * \param max_readers - Max number of Reader alive at once.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  options is not null, max_readers greater than 0.
+     * \post This holds the options passed.
+     */
+    explicit OptionsHolder(std::unique_ptr<const Options> options,
+                           std::size_t max_readers = 64);
+
+    /*!
+     * Default destructor. Delete all the snapshots: no Reader must be
+     * alive.
+     */
+    ~OptionsHolder();
+
+    /*!
+     * Gets a handle to read the options from a thread.
+     * \throw std::length_error if max_readers readers are alive.
+     */
+    Reader make_reader() const;
+
+    /*!
+     * Replace the options held with the ones passed. The old ones are
+     * deleted once no reader sees them, here or at a later publish
+     * or reclaim.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  options is not null.
+     * \post Readers reading from now on get the options passed.
+     */
+    void publish(std::unique_ptr<const Options> options);
+
+    /*!
+     * Parse the command line and the config file passed with the
+     * parser passed, and publish the options if there are no errors.
+     * Used to re-read the config file of a program when it changes.
+     * \return The first error found, loading or parsing: in this case
+     *         the options held are left untouched.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  Like OptionParser::try_parse with a config file.
+     * \post If no error is returned readers get the new options.
+     */
+    ParseError reload(OptionParser& parser,
+                      int argc,
+                      const char *argv[],
+                      const std::string& config_path);
+
+    /*!
+     * Delete the old snapshots no reader sees anymore.
+     * \return The number of old snapshots still waiting for readers.
+     */
+    std::size_t reclaim();
+
+private:
+    OptionsHolder(const OptionsHolder&);
+    OptionsHolder& operator=(const OptionsHolder&);
+
+    /*! Same as reclaim, with the mutex locked. */
+    std::size_t reclaim_locked() noexcept;
+
+    /*! Options read by readers. */
+    std::atomic<const Options*>  _current;
+    /*! Epoch of the current options, starting from 1. */
+    std::atomic<std::uint64_t>   _epoch;
+    std::unique_ptr<Slot[]>      _slots;
+    std::size_t                  _max_readers;
+    /*! Serializes writers and guards _retired. */
+    std::mutex                   _mutex;
+    /*! Snapshots replaced, with the epoch they were replaced in. */
+    std::vector<std::pair<std::uint64_t, const Options*>> _retired;
+};
+
+#endif
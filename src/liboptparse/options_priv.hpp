@@ -46,8 +46,13 @@ public:
         : _args(new Options::arguments_container(args_begin,
                                                  args_end)),
           _program_info(new ProgramInfo(program_info)),
-          _opts(new Options::options_container(opts_begin,
-                                               opts_end)) { };
+          _index(),
+          _values(new Options::values_container()),
+          _given(),
+          _fingerprint(),
+          _repeated() {
+        index_options(opts_begin, opts_end);
+    };
     
     template<class OptsForwardIterator>
     Impl(
@@ -56,27 +61,98 @@ public:
         OptsForwardIterator opts_end)
         : _args(new Options::arguments_container()),
           _program_info(new ProgramInfo(program_info)),
-          _opts(new Options::options_container(opts_begin,
-                                               opts_end)) { };
+          _index(),
+          _values(new Options::values_container()),
+          _given(),
+          _fingerprint(),
+          _repeated() {
+        index_options(opts_begin, opts_end);
+    };
+
+    template<class ArgsForwardIterator>
+    Impl(
+        const ProgramInfo&  program_info,
+        std::shared_ptr<const _LIBOPTPARSE_::OptionIndex> index,
+        Options::values_container&& values,
+        Options::given_container&& given,
+        const OptionsFingerprint& fingerprint,
+        _LIBOPTPARSE_::RepeatedValues&& repeated,
+        ArgsForwardIterator args_begin,
+        ArgsForwardIterator args_end)
+        : _args(new Options::arguments_container(args_begin,
+                                                 args_end)),
+          _program_info(new ProgramInfo(program_info)),
+          _index(index),
+          _values(new Options::values_container(std::move(values))),
+          _given(std::move(given)),
+          _fingerprint(fingerprint),
+          _repeated(std::move(repeated)) {
+        _repeated.freeze(_values -> size());
+    }
 
     bool OK() const noexcept;
 
     bool contains_option(char key) const noexcept;
+    bool contains_option(const std::string& key) const noexcept;
     Options::value_type at(char key) const noexcept;
+    Options::value_type at(const std::string& key) const noexcept;
+    Options::value_type at_id(option_id id) const noexcept;
+    bool is_set(option_id id) const noexcept;
+    ValueSpan get_values(option_id id) const noexcept;
+    option_id find_id(char key) const noexcept;
+    option_id find_id(std::string_view key) const noexcept;
+    char get_short_name(option_id id) const noexcept;
+    std::string_view get_long_name(option_id id) const noexcept;
+    std::size_t size() const noexcept;
+    const OptionsFingerprint& get_fingerprint() const noexcept;
 
     Options::options_const_iterator options_cbegin() const noexcept;
     
     Options::options_const_iterator options_cend() const noexcept;
 
+    Options::values_const_iterator values_cbegin() const noexcept;
+
+    Options::values_const_iterator values_cend() const noexcept;
+
     Options::arguments_const_iterator arguments_cbegin() const noexcept;
 
     Options::arguments_const_iterator arguments_cend() const noexcept;
 
     const std::string& get_program_name() const noexcept;
 private:
+    template<class OptsForwardIterator>
+    void index_options(OptsForwardIterator opts_begin,
+                       OptsForwardIterator opts_end) {
+        std::shared_ptr<_LIBOPTPARSE_::HashOptionIndex> index(
+            new _LIBOPTPARSE_::HashOptionIndex());
+        for (auto itr = opts_begin; itr != opts_end; ++itr) {
+            index -> add(itr -> first, "");
+            _values -> push_back(itr -> second);
+        }
+        _given.assign(_values -> size(), true);
+        _index = index;
+        _LIBOPTPARSE_::OptionsDigest digest;
+        for (option_id id = 0; id < _values -> size(); ++id) {
+            if ((*_values)[id] != NULL) {
+                digest.add_value(id, (*_values)[id] -> get_value());
+            }
+        }
+        for (auto& argument : *_args) {
+            if (argument != NULL) {
+                digest.add_argument(argument -> get_value());
+            }
+        }
+        _fingerprint = OptionsFingerprint {
+            digest.digest_low(), digest.digest_high() };
+    }
+
     std::unique_ptr<arguments_container> _args;
     std::shared_ptr<ProgramInfo>    _program_info;
-    std::unique_ptr<options_container> _opts;
+    std::shared_ptr<const _LIBOPTPARSE_::OptionIndex> _index;
+    std::unique_ptr<values_container> _values;
+    given_container                   _given;
+    OptionsFingerprint                _fingerprint;
+    _LIBOPTPARSE_::RepeatedValues     _repeated;
 };
 
 
@@ -102,4 +178,23 @@ Options::Options(
                                opts_begin,
                                opts_end)) { }
 
+template<class ArgsForwardIterator>
+Options::Options(
+    const ProgramInfo&  program_info,
+    std::shared_ptr<const _LIBOPTPARSE_::OptionIndex> index,
+    values_container&&  values,
+    given_container&&   given,
+    const OptionsFingerprint& fingerprint,
+    _LIBOPTPARSE_::RepeatedValues&& repeated,
+    ArgsForwardIterator args_begin,
+    ArgsForwardIterator args_end)
+    : _pimpl(new Impl(program_info,
+                      index,
+                      std::move(values),
+                      std::move(given),
+                      fingerprint,
+                      std::move(repeated),
+                      args_begin,
+                      args_end)) { }
+
 #endif
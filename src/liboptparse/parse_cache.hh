@@ -0,0 +1,191 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      parse_cache.hh
+ * \brief     Bounded cache of the options parsed by command line.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the cache used by programs parsing the same
+ * command lines over and over, e.g. a service receiving commands.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "options.hh"
+#include "parse_result.hh"
+#include "response_file.hh"
+
+#ifndef LIBOPTPARSE_PARSE_CACHE_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_PARSE_CACHE_INCLUDE_GUARD_HH 1
+
+/*! \brief Counters of a ParseCache. */
+struct ParseCacheStats {
+    /*! Parses answered by the cache. */
+    std::uint64_t hits;
+    /*! Parses not found in the cache. */
+    std::uint64_t misses;
+    /*! Entries dropped to make room for new ones. */
+    std::uint64_t evictions;
+    /*!
+     * Parses not cached because they read more than the command
+     * line, see ParseCache.
+     */
+    std::uint64_t bypasses;
+    /*! Entries held. */
+    std::size_t   entries;
+    /*!
+     * Estimate of the bytes held by the entries: command lines,
+     * options and bookkeeping.
+     */
+    std::size_t   bytes;
+
+    /*! Gets hits over lookups, 0 if there are none. */
+    double hit_rate() const noexcept {
+        std::uint64_t lookups = hits + misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups;
+    }
+};
+
+/*!
+ * \brief Bounded cache of parsed options, keyed by command line.
+ *
+ * A command line is looked up by a fast hash of its arguments, then
+ * compared argument by argument, so different command lines never
+ * share options. On a hit the same immutable Options are returned,
+ * shared; on a miss the command line is parsed and kept, dropping
+ * the least recently used one when the cache is full. Errors are not
+ * cached.
+ *
+ * Entries are split in shards by hash, each with its own lock and
+ * LRU list, so threads using the same cache rarely wait for each
+ * other. A cache belongs to one parser: options are cached without
+ * the parser that made them, so the parser must not change while
+ * the cache is used.
+ *
+ * Only the command line is part of the key, so parses reading
+ * other inputs are never cached: if the parser reads the
+ * environment (an env prefix or an option with an env name) every
+ * parse goes to the parser, and so do command lines naming response
+ * files when the parser expands them. They are counted as bypasses.
+ */
+class ParseCache {
+public:
+    /*!
+     * Constructor with two parameters.
+     * \param capacity - Max number of command lines held, split
+     *                   evenly among the shards.
+     * \param shards   - Number of shards, rounded up to a power of
+     *                   two and limited by capacity.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  capacity and shards greater than 0.
+     * \post The cache is empty.
+     */
+    explicit ParseCache(std::size_t capacity, std::size_t shards = 16);
+
+    /*! Default destructor. */
+    ~ParseCache();
+
+    /*!
+     * Gets the options of the command line passed, parsing it with
+     * the parser passed if it is not in the cache.
+     * \param parser - Parser with the try_parse(argc, argv),
+     *                 reads_environment() and get_response_files()
+     *                 methods, e.g. OptionParser or CompiledParser.
+     * \param error  - Set to the error found if it is not NULL.
+     * \return The options, NULL if the command line has errors.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  argc less than equals size of argv vector, parser is
+     *       always the same.
+     * \post Options returned are VALID.
+     */
+    template<class Parser>
+    std::shared_ptr<const Options> parse(Parser& parser,
+                                         int argc,
+                                         const char *argv[],
+                                         ParseError* error = NULL) {
+        bool cached = !parser.reads_environment() &&
+            (parser.get_response_files().max_depth == 0 ||
+             !ResponseFiles::has_response_files(argc, argv));
+        std::uint64_t hash = 0;
+        if (cached) {
+            hash = hash_arguments(argc, argv);
+            std::shared_ptr<const Options> options =
+                lookup(hash, argc, argv);
+            if (options != NULL) {
+                return options;
+            }
+        } else {
+            count_bypass();
+        }
+        ParseResult result = parser.try_parse(argc, argv);
+        if (!result.is_ok()) {
+            if (error != NULL) {
+                *error = result.get_error();
+            }
+            return std::shared_ptr<const Options>();
+        }
+        if (!cached) {
+            return result.get_options();
+        }
+        return store(hash, argc, argv, result.get_options());
+    }
+
+    /*! Gets the counters of the cache, summed over the shards. */
+    ParseCacheStats get_stats() const;
+
+    /*! Drop all the entries. Counters are kept. */
+    void clear();
+
+private:
+    ParseCache(const ParseCache&);
+    ParseCache& operator=(const ParseCache&);
+
+    /*! Hash of the arguments of the command line passed. */
+    static std::uint64_t hash_arguments(int argc,
+                                        const char *argv[]) noexcept;
+
+    /*! Gets the cached options, NULL counting a miss if there are not. */
+    std::shared_ptr<const Options> lookup(std::uint64_t hash,
+                                          int argc,
+                                          const char *argv[]);
+
+    /*! Count a parse not cached. */
+    void count_bypass() noexcept;
+
+    /*!
+     * Cache the options passed.
+     * \return The options cached for the command line: other ones if
+     *         an other thread cached them first.
+     */
+    std::shared_ptr<const Options> store(
+        std::uint64_t hash,
+        int argc,
+        const char *argv[],
+        std::shared_ptr<const Options> options);
+
+    class Impl;
+    std::unique_ptr<Impl> _pimpl;
+};
+
+#endif
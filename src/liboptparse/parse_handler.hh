@@ -0,0 +1,90 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      parse_handler.hh
+ * \brief     Callbacks of the event parsing.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the interface of the objects notified by
+ * OptionParser::parse_events as the command line is read.
+ */
+
+#include "argument_text.hh"
+#include "optargs.hh"
+#include "parse_result.hh"
+
+#ifndef LIBOPTPARSE_PARSE_HANDLER_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_PARSE_HANDLER_INCLUDE_GUARD_HH 1
+
+/*!
+ * \brief Receiver of the events of a parse.
+ *
+ * Events are notified in command line order. Texts passed refer to
+ * argv: copy them if they have to outlive it. Default implementations
+ * do nothing, so override only the events needed.
+ */
+class ParseHandler {
+public:
+    /*! Virtual destructor. */
+    virtual ~ParseHandler();
+
+    /*!
+     * The first argument, the name of the program, has been read.
+     * \param name - Text of the argument.
+     */
+    virtual void on_program_name(const ArgumentText& name);
+
+    /*!
+     * An option has been found. If it has a value, on_value follows.
+     * \param option - Option found.
+     */
+    virtual void on_option(const OptionArgument& option);
+
+    /*!
+     * The value of the option notified by the last on_option has
+     * been read.
+     * \param option - Option found.
+     * \param value  - Text of the value.
+     */
+    virtual void on_value(const OptionArgument& option,
+                          const ArgumentText& value);
+
+    /*!
+     * A positional argument has been found.
+     * \param value - Text of the argument.
+     */
+    virtual void on_positional(const ArgumentText& value);
+
+    /*!
+     * The whole command line has been read. It is not called if the
+     * parse is stopped by an error.
+     */
+    virtual void on_end();
+
+    /*!
+     * An error has been found.
+     * \param error - Error found.
+     * \return True to go on reading the command line, false to stop.
+     *         Default is false.
+     */
+    virtual bool on_error(const ParseError& error);
+};
+
+#endif
@@ -0,0 +1,152 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      parse_range.hh
+ * \brief     Lazy range over the items of a command line.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the range returned by OptionParser::parse_lazily:
+ * the command line is tokenized and evaluated as the range is
+ * iterated, so the rest of argv is not read if the iteration stops.
+ */
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "argument_text.hh"
+#include "optargs.hh"
+#include "option_index.hh"
+#include "parse_result.hh"
+#include "parser_priv.hpp"
+
+#ifndef LIBOPTPARSE_PARSE_RANGE_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_PARSE_RANGE_INCLUDE_GUARD_HH 1
+
+/*!
+ * This is an enumeration type representing the kind of an item of
+ * the command line.
+ */
+enum ParsedItemType {
+    /*! The first argument: the name of the program. */
+    parsed_program_name = 0,
+    /*! An option, with or without its value. */
+    parsed_option = 1,
+    /*! A positional argument. */
+    parsed_positional = 2,
+    /*! An error: the iteration goes on after it. */
+    parsed_error = 3
+};
+
+/*!
+ * \brief An item of the command line: see ParsedItemType.
+ *
+ * It is a plain value, texts refer to argv.
+ */
+struct ParsedItem {
+    /*! Kind of the item. */
+    ParsedItemType        type;
+
+    /*! Option found, NULL if type is not parsed_option. */
+    const OptionArgument* option;
+
+    /*!
+     * Text of the program name, of the positional argument or of
+     * the value of the option. Empty if the option has no value.
+     */
+    ArgumentText          value;
+
+    /*! True if the option has a value. */
+    bool                  has_value;
+
+    /*! Error found, its type is parse_ok if type is not parsed_error. */
+    ParseError            error;
+};
+
+/*!
+ * \brief Range over the items of a command line.
+ *
+ * Items are read from argv one at a time as the range is iterated,
+ * using the same tokenizer and evaluator of OptionParser::parse. The
+ * range refers to the parser that returned it and to argv: they must
+ * live, and the parser must not change, until the iteration ends.
+ */
+class ParseRange {
+public:
+    /*! \brief Input iterator over the items of the command line. */
+    class const_iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef ParsedItem              value_type;
+        typedef std::ptrdiff_t          difference_type;
+        typedef const ParsedItem*       pointer;
+        typedef const ParsedItem&       reference;
+
+        /*! Initialize an end iterator. */
+        const_iterator();
+
+        reference operator*() const noexcept;
+        pointer operator->() const noexcept;
+        const_iterator& operator++();
+
+        /*!
+         * Equality operator. Only end iterators are equal: an input
+         * iterator can only be compared with the end of its range.
+         */
+        bool operator==(const const_iterator& other) const noexcept;
+        bool operator!=(const const_iterator& other) const noexcept;
+
+    private:
+        friend class ParseRange;
+
+        const_iterator(const ParseRange& range);
+
+        /*! Evaluate tokens until at least an item is found. */
+        void load();
+
+        const ParseRange*              _range;
+        _LIBOPTPARSE_::TokenIterator   _token;
+        _LIBOPTPARSE_::EvaluationState _state;
+        /*! Items found by the last evaluation step. */
+        std::vector<ParsedItem>        _items;
+        std::size_t                    _next;
+    };
+
+    /*! Gets the iterator to the first item, it starts the parse. */
+    const_iterator begin() const;
+
+    /*! Gets the end iterator. */
+    const_iterator end() const;
+
+private:
+    friend class OptionParser;
+
+    ParseRange(const _LIBOPTPARSE_::HashOptionIndex& index,
+               const std::vector<OptionArgument*>& arguments,
+               int argc,
+               const char *argv[]);
+
+    const _LIBOPTPARSE_::HashOptionIndex& _index;
+    const std::vector<OptionArgument*>&   _arguments;
+    int                                   _argc;
+    const char**                          _argv;
+};
+
+#endif
@@ -0,0 +1,236 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      parse_result.hh
+ * \brief     Result of a parse that does not throw.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the definition of the objects used to report
+ * parse errors without throwing exceptions.
+ */
+
+#include <memory>
+#include <ostream>
+
+#include "options.hh"
+
+#ifndef LIBOPTPARSE_PARSE_RESULT_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_PARSE_RESULT_INCLUDE_GUARD_HH 1
+
+/*!
+ * This is an enumeration type representing the kind of a parse
+ * error.
+ */
+enum ParseErrorType {
+    /*! No error: the command line has been parsed. */
+    parse_ok = 0,
+    /*! A short option, alone or grouped, is not registered. */
+    unknown_short_option = 1,
+    /*! A long option is not registered. */
+    unknown_long_option = 2,
+    /*! A "--" is not followed by the name of the option. */
+    missing_option_name = 3,
+    /*!
+     * A long option, or a short option not grouped, that is not a
+     * flag is not followed by its value.
+     */
+    missing_option_value = 4,
+    /*!
+     * The value of an option can not be converted to the type of
+     * its destination (see OptionArgument::bind), or the value of a
+     * flag read from the environment or a config is not a boolean.
+     */
+    invalid_option_value = 5,
+    /*!
+     * A positional argument is not the name of a subcommand (see
+     * CommandParser).
+     */
+    unknown_command = 6,
+    /*! A response file can not be opened or read. */
+    unreadable_response_file = 7,
+    /*! Response files exceed the bytes allowed. */
+    response_file_too_large = 8,
+    /*!
+     * Response files are nested deeper than allowed, or a response
+     * file includes itself.
+     */
+    nested_response_file = 9,
+    /*! Reading the arguments from a stream failed. */
+    unreadable_input = 10,
+    /*! A config file can not be opened or read. */
+    unreadable_config_file = 11,
+    /*! A line of a config file is not "key = value". */
+    invalid_config_line = 12,
+    /*! A key of a config file is not the long name of an option. */
+    unknown_config_key = 13,
+    /*!
+     * A parse stopping before the end (see StopMode) stops inside a
+     * response file: the arguments after the stop are not a tail of
+     * argv.
+     */
+    split_response_file = 14
+};
+
+/*!
+ * \brief This represent an error found parsing the command line.
+ *
+ * It is a plain value: it does not own any memory and it is cheap
+ * to copy.
+ */
+struct ParseError {
+    /*! Kind of the error. */
+    ParseErrorType type;
+
+    /*!
+     * Index inside argv of the argument with the error; for the
+     * errors of config files, the line number; -1 for the values of
+     * environment variables.
+     */
+    int            index;
+
+    /*!
+     * Position, inside the argument with the error, of the first
+     * char of the wrong token.
+     */
+    int            position;
+};
+
+/*!
+ * This is an enumeration type representing where a parse stops
+ * before the end of the command line.
+ */
+enum StopMode {
+    /*! The whole command line is parsed. */
+    stop_never = 0,
+    /*! The parse stops after an argument made of "--" only. */
+    stop_at_separator = 1,
+    /*!
+     * The parse stops at the argument containing the first
+     * positional argument, or after "--" like stop_at_separator.
+     */
+    stop_at_positional = 2
+};
+
+/*!
+ * \brief Arguments of the command line not parsed.
+ *
+ * It refers to the original argv array: nothing is copied, so it can
+ * be forwarded as it is to an other parser or to exec.
+ */
+struct ArgumentSpan {
+    /*! Number of arguments. */
+    int          argc;
+
+    /*! First argument, argv[argc] of the original array if empty. */
+    const char** argv;
+};
+
+/*!
+ * Gets a short description of the error type passed.
+ * \param type - Error type to describe.
+ * \return A not NULL static string.
+ */
+const char* describe(ParseErrorType type) noexcept;
+
+/*!
+ * ostream operator overload. It puts the description of the error
+ * and where it has been found.
+ * \param os    - Out stream where put the error.
+ * \param error - Error to put in the out stream.
+ * \return os reference to allow chaining.
+ */
+std::ostream& operator<<(std::ostream& os, const ParseError& error);
+
+/*!
+ * \brief Result of OptionParser::try_parse.
+ *
+ * It contains the parsed options or the error that stopped the
+ * parse, never both.
+ */
+class ParseResult {
+public:
+    /*!
+     * Constructor with one parameter. Initialize a successful
+     * result.
+     * \param options - Parsed options. It must be not NULL.
+     */
+    explicit ParseResult(std::unique_ptr<const Options> options);
+
+    /*!
+     * Constructor with one parameter. Initialize a failed result.
+     * \param error - Error found. Its type must not be parse_ok.
+     */
+    explicit ParseResult(const ParseError& error);
+
+    /*! Move constructor. */
+    ParseResult(ParseResult&& result) = default;
+
+    /*! Default destructor. */
+    ~ParseResult();
+
+    /*!
+     * Checks if the parse succeeded.
+     * \return True if this result contains options, false if it
+     *         contains an error.
+     */
+    bool is_ok() const noexcept;
+
+    /*! Same as is_ok. */
+    explicit operator bool() const noexcept;
+
+    /*!
+     * Gets the error found.
+     * \return The error of the parse. Its type is parse_ok if the
+     *         parse succeeded.
+     */
+    const ParseError& get_error() const noexcept;
+
+    /*!
+     * Gets the arguments not parsed because the parse stopped (see
+     * StopMode).
+     * \return The tail of argv. Its argc is 0 if the whole command
+     *         line has been parsed or the parse failed.
+     */
+    const ArgumentSpan& get_tail() const noexcept;
+
+    /*!
+     * Set the arguments not parsed.
+     * \param tail - Tail of argv.
+     * \return A reference to this result.
+     */
+    ParseResult& set_tail(const ArgumentSpan& tail) noexcept;
+
+    /*!
+     * Gets the parsed options, moving them out of this result.
+     * \return The parsed options, NULL if the parse failed or they
+     *         have already been taken.
+     */
+    std::unique_ptr<const Options> get_options() noexcept;
+
+private:
+    ParseResult(const ParseResult&);
+    ParseResult& operator=(const ParseResult&);
+
+    std::unique_ptr<const Options> _options;
+    ParseError                     _error;
+    ArgumentSpan                   _tail;
+};
+
+#endif
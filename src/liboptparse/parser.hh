@@ -26,12 +26,22 @@
  * the command lin arguments.
  */
 
+#include "config_file.hh"
 #include "optargs.hh"
 #include "options.hh"
+#include "parse_handler.hh"
+#include "parse_range.hh"
+#include "parse_result.hh"
 #include "program_info.hh"
+#include "response_file.hh"
+#include <iterator>
 #include <list>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <memory>
+#include <typeinfo>
+#include <vector>
 
 #ifndef LIBOPTPARSE_PARSER_INCLUDE_GUARD_HH
 #define LIBOPTPARSE_PARSER_INCLUDE_GUARD_HH 1
@@ -40,6 +50,11 @@
  * This is the parser class used to configure option arguments and
  * parse command line.
  *
+ * Each option argument added gets a dense id (see
+ * OptionArgument::get_id) used to get its value from Options. Adding
+ * an option takes amortized constant time: names are indexed as
+ * options are added and repeated names are rejected.
+ *
  * DEF: OptionParse is a VALID OptionParser if each argument inside it
  *      is valid and has not repetition: all OptionArgument are
  *      different (see operator== overload for OptionArgument). 
@@ -80,11 +95,11 @@ public:
      *                   class documentation).
      * \return A reference to the option argument added to configure
      *         it using setter methods to make a chain.
+     * \throw std::invalid_argument if its short or long name is
+     *        already used by an other argument of this parser.
      *
      * <h3> CONTRACT </h3>
-     * \pre  Argument added must be valid and not added yet (use
-     *       begin and and methods with std algorithm to check
-     *       containment)
+     * \pre  Argument added must be valid.
      * \post Argument returned is valid and equals to the argument
      *       passed as parameter. Parser is still valid.
      */
@@ -98,16 +113,33 @@ public:
      *                     function).
      * \return A reference to the option argument added to configure
      *         it using setter methods to make a chain.
+     * \throw std::invalid_argument if the short name is already used
+     *        by an other argument of this parser.
      *
      * <h3> CONTRACT </h3>
-     * \pre  Short name passed must be valid and not contained in this
-     *       parser (use begin and and methods with std algorithm to
-     *       check containment)
+     * \pre  Short name passed must be valid.
      * \post Argument returned is valid with the short name specified
      *       and parser is still valid.
      */
     OptionArgument& add(char short_name);
 
+    /*!
+     * Add an option argument with only the long name specified.
+     * \param long_name - Long name to assign to the argument added,
+     *                    it must be a VALID LONG NAME not empty (see
+     *                    is_valid_long_name utility function).
+     * \return A reference to the option argument added to configure
+     *         it using setter methods to make a chain.
+     * \throw std::invalid_argument if the long name is already used
+     *        by an other argument of this parser.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  Long name passed must be valid and not empty.
+     * \post Argument returned is valid with the long name specified
+     *       and without short name. Parser is still valid.
+     */
+    OptionArgument& add(const std::string& long_name);
+
     /*!
      * Add an option  argument with short and long name specified.
      * \param short_name - Short name used to initialize an option
@@ -119,20 +151,83 @@ public:
      *                     is_valid_long_name utility function).
      * \return A reference to the option argument added to configure
      *         it using setter methods to make a chain.
+     * \throw std::invalid_argument if the short or the long name is
+     *        already used by an other argument of this parser.
      *
      * <h3> CONTRACT </h3>
-     * \pre  Short and long name passed must be valid and not
-     *       contained in this parser (use begin and and methods with
-     *       std algorithm to check containment)
+     * \pre  Short and long name passed must be valid.
      * \post Argument returned is valid with the short and long name
      *       specified and. Parser is still valid.
      */
     OptionArgument& add(char short_name,
                         const std::string& long_name);
 
+    /*!
+     * Enable the expansion of response files (see ResponseFiles) by
+     * parse and try_parse: an argument "@path" is replaced by the
+     * arguments written inside the file path before parsing. The
+     * index of the errors found parsing refers to the expanded
+     * command line. The tail of a parse stopping before the end
+     * (see StopMode) is the rest of argv with its response files
+     * not expanded; a stop inside a response file is a
+     * split_response_file error, indexed by the argument naming the
+     * file.
+     * \param limits - Limits of the expansion, a max_depth of 0
+     *                 disables it. Default is disabled.
+     * \return A reference to this parser.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This parser must be valid, max_depth not negative.
+     * \post Parser is still valid.
+     */
+    OptionParser& set_response_files(const ResponseFileLimits& limits);
+
+    /*!
+     * Enable the values taken from environment variables by parse
+     * and try_parse: an option not given on the command line takes
+     * the value of the variable named by its env name (see
+     * OptionArgument::set_env_name) or, if the prefix is not empty,
+     * of the variable made of the prefix followed by its long name
+     * in upper case; with prefix "TOOL_" the option "threads" reads
+     * TOOL_THREADS and "outputFile" reads TOOL_OUTPUTFILE. Long
+     * names differing only by case are not read by prefix. If both
+     * variables of an option are set, the one named by its env name
+     * wins. A flag takes "true", "yes" or "1" to be set, "false",
+     * "no" or "0" to be unset, in any case: other values are
+     * invalid_option_value errors with index -1. The command line
+     * overrides the environment, which overrides default values.
+     * The environment is read at each parse, walking it once;
+     * parse_into, parse_events and parse_stream do not read it.
+     * \param prefix - Prefix of the variables, empty to read only the
+     *                 variables named by the options. Default is
+     *                 empty.
+     * \return A reference to this parser.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This parser must be valid.
+     * \post Parser is still valid.
+     */
+    OptionParser& set_env_prefix(const std::string& prefix);
+
+    /*! Gets the limits set by set_response_files. */
+    const ResponseFileLimits& get_response_files() const noexcept;
+
+    /*! Gets the prefix set by set_env_prefix. */
+    const std::string& get_env_prefix() const noexcept;
+
+    /*!
+     * Checks if parse and try_parse read the environment: the env
+     * prefix is not empty or an option has an env name.
+     */
+    bool reads_environment() const noexcept;
+
     /*!
      * Parse the option specified as parameter according to the option
      * arguments added before calling this method.
+     * \throw std::out_of_range if the command line contains an
+     *        unknown option, a "--" without name or an option that is
+     *        not a flag without its value. The message describes the
+     *        error, see try_parse.
      *
      * <h3> CONTRACT </h3>
      * \pre  This parser must be valid, argc less than equals size
@@ -142,6 +237,236 @@ public:
     std::unique_ptr<const Options> parse(int argc,
                                          const char *argv[]);
 
+    /*!
+     * Parse the option specified as parameter like parse does, but
+     * it reports errors through the result instead of throwing.
+     * \return The parsed options or the first error found, with the
+     *         index of the wrong argument inside argv.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This parser must be valid, argc less than equals size
+     *       of argv vector.
+     * \post Options inside the result are VALID and parser is still
+     *       valid.
+     */
+    ParseResult try_parse(int argc, const char *argv[]);
+
+    /*!
+     * Parse the option specified as parameter like try_parse does,
+     * but stop at the point selected: with stop_at_separator at the
+     * first "--", with stop_at_positional at the first positional
+     * argument. Arguments after that point are not read at all and
+     * are returned untouched as the tail of the result, e.g. to pass
+     * them to a subcommand or to an other program.
+     * \param stop - Where the parse stops.
+     * \return The parsed options and the tail of argv, or the first
+     *         error found.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This parser must be valid, argc less than equals size
+     *       of argv vector.
+     * \post Options inside the result are VALID, the tail is a suffix
+     *       of argv and parser is still valid.
+     */
+    ParseResult try_parse(int argc, const char *argv[], StopMode stop);
+
+    /*!
+     * Parse the option specified as parameter without stopping at
+     * the first error: each error found is appended to the errors
+     * passed. Use it to validate a command line reporting all its
+     * problems at once; clearing and reusing the same vector avoids
+     * allocations across calls.
+     * \param errors - Container where errors are appended.
+     * \return The parsed options if there are no errors, the first
+     *         error found otherwise.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This parser must be valid, argc less than equals size
+     *       of argv vector.
+     * \post Options inside the result are VALID and parser is still
+     *       valid.
+     */
+    ParseResult try_parse(int argc,
+                          const char *argv[],
+                          std::vector<ParseError>& errors);
+
+    /*!
+     * Parse the option specified as parameter like parse does, with
+     * the values of the config file passed merged under the command
+     * line: each option takes, in order of precedence, the value of
+     * the command line, of the environment (see set_env_prefix), of
+     * the last entry of the config with its long name as key, or its
+     * default value. The values of flags are read like the ones of
+     * the environment.
+     * \param config - Entries of the config file.
+     * \throw std::out_of_range like parse, and if a key of the config
+     *        is not the long name of an option or the value of a
+     *        flag is not valid.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This parser must be valid, argc less than equals size
+     *       of argv vector.
+     * \post Options are VALID and parser is still valid.
+     */
+    std::unique_ptr<const Options> parse(int argc,
+                                         const char *argv[],
+                                         const ConfigFile& config);
+
+    /*!
+     * Parse the option specified as parameter like
+     * parse(int, const char**, const ConfigFile&) does, but it reports
+     * errors through the result instead of throwing.
+     * \param config - Entries of the config file.
+     * \return The parsed options or the first error found: an
+     *         unknown key of the config is unknown_config_key and a
+     *         value not valid for a flag is invalid_option_value,
+     *         with the number of its line as index.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This parser must be valid, argc less than equals size
+     *       of argv vector.
+     * \post Options inside the result are VALID and parser is still
+     *       valid.
+     */
+    ParseResult try_parse(int argc,
+                          const char *argv[],
+                          const ConfigFile& config);
+
+    /*!
+     * Parse the arguments inside a contiguous range of string-like
+     * items, like parse(int, const char*[]) does. The range is read
+     * in place: nothing is copied, so arguments need not be
+     * NUL-terminated. Its first item is the program name.
+     * \param arguments - Range, e.g. std::vector<std::string> or an
+     *                    array of std::string_view, whose items
+     *                    std::string_view can be built from.
+     * \throw std::out_of_range like parse(int, const char*[]).
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This parser must be valid, the range must live until the
+     *       options returned are destroyed if they refer to it.
+     * \post Options are VALID and parser is still valid.
+     */
+    template<class Range>
+    std::unique_ptr<const Options> parse(const Range& arguments);
+
+    /*!
+     * Same as parse(const Range&), but errors are reported through
+     * the result like try_parse(int, const char*[]) does.
+     */
+    template<class Range>
+    ParseResult try_parse(const Range& arguments);
+
+    /*!
+     * Parse the command line storing the values straight into the
+     * variables the options are bound to (see OptionArgument::bind),
+     * without building Options. Options not bound and positional
+     * arguments are checked but not stored.
+     * \return The first error found, parse_ok if there is not. A
+     *         value that can not be converted to the type of its
+     *         variable is an invalid_option_value error.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This parser must be valid, argc less than equals size
+     *       of argv vector, no option is bound to a member.
+     * \post Parser is still valid.
+     */
+    ParseError try_parse_into(int argc, const char *argv[]);
+
+    /*!
+     * Same as try_parse_into, but each error found is appended to the
+     * errors passed.
+     * \return The first error found, parse_ok if there is not.
+     */
+    ParseError try_parse_into(int argc,
+                              const char *argv[],
+                              std::vector<ParseError>& errors);
+
+    /*!
+     * Same as try_parse_into, but options bound to a member of C
+     * store their value inside the object passed.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This parser must be valid, argc less than equals size
+     *       of argv vector, options are bound to variables or to
+     *       members of C.
+     * \post Parser is still valid.
+     */
+    template<class C>
+    ParseError try_parse_into(C& object, int argc, const char *argv[]);
+
+    /*!
+     * Same as try_parse_into(C&, int, const char*[]), but each error
+     * found is appended to the errors passed.
+     */
+    template<class C>
+    ParseError try_parse_into(C& object,
+                              int argc,
+                              const char *argv[],
+                              std::vector<ParseError>& errors);
+
+    /*!
+     * Parse the command line notifying each option, value and
+     * positional argument to the handler passed, as they are read.
+     * No Options is built and no memory is allocated by the parser:
+     * texts passed to the handler refer to argv.
+     * \param handler - Handler of the events. Errors are notified
+     *                  through on_error, that decides if the parse
+     *                  goes on.
+     * \return The first error found, parse_ok if there is not.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This parser must be valid, argc less than equals size
+     *       of argv vector.
+     * \post Parser is still valid.
+     */
+    ParseError parse_events(int argc,
+                            const char *argv[],
+                            ParseHandler& handler);
+
+    /*!
+     * Parse the arguments read from a file descriptor or a pipe,
+     * separated by '\0' like "xargs -0" reads them, notifying them
+     * to the handler as they arrive like parse_events does. There is
+     * no program name: the first argument read is the first option
+     * or positional argument, with index 0.
+     *
+     * The descriptor is read in chunks of the size passed and only
+     * the argument being evaluated is kept, so memory is bounded by
+     * the chunk size and the longest argument, not by the number of
+     * arguments. Texts passed to the handler are valid only during
+     * the call.
+     * \param fd         - Descriptor to read until its end, it is not
+     *                     closed.
+     * \param handler    - Handler of the events.
+     * \param chunk_size - Bytes read at once.
+     * \return The first error found, parse_ok if there is not. If
+     *         reading fails the arguments end there and the error is
+     *         unreadable_input.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This parser must be valid, chunk_size greater than 0.
+     * \post Parser is still valid.
+     */
+    ParseError parse_stream(int fd,
+                            ParseHandler& handler,
+                            std::size_t chunk_size = 65536);
+
+    /*!
+     * Gets a range over the items of the command line: it is parsed
+     * as the range is iterated, so stopping the iteration stops the
+     * parse and the rest of argv is not read.
+     * \return The range of the items. Errors are items too, the
+     *         iteration goes on after them.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  This parser must be valid, argc less than equals size
+     *       of argv vector. Parser and argv must not change until the
+     *       iteration ends.
+     * \post Parser is still valid.
+     */
+    ParseRange parse_lazily(int argc, const char *argv[]) const;
+
     /*!
      * Get the const iterator to the begin of the option argument
      * collection.
@@ -166,9 +491,55 @@ public:
 private:
     OptionParser& operator=(const OptionParser&);
 
+    /*!
+     * Implementation of try_parse_into: object is the instance of
+     * type owning the members, errors NULL to stop at the first one.
+     */
+    ParseError parse_into(void* object,
+                          const std::type_info* type,
+                          int argc,
+                          const char *argv[],
+                          std::vector<ParseError>* errors);
+
+    /*! Implementation of try_parse over a range of arguments. */
+    ParseResult try_parse_array(int argc,
+                                _LIBOPTPARSE_::ArgumentArray arguments);
+
     class Impl;
     std::unique_ptr<Impl> _pimpl;
 
 };
 
+template<class C>
+ParseError OptionParser::try_parse_into(C& object,
+                                        int argc,
+                                        const char *argv[]) {
+    return parse_into(&object, &typeid(C), argc, argv, NULL);
+}
+
+template<class C>
+ParseError OptionParser::try_parse_into(C& object,
+                                        int argc,
+                                        const char *argv[],
+                                        std::vector<ParseError>& errors) {
+    return parse_into(&object, &typeid(C), argc, argv, &errors);
+}
+
+template<class Range>
+std::unique_ptr<const Options> OptionParser::parse(const Range& arguments) {
+    ParseResult result = try_parse(arguments);
+    if (!result.is_ok()) {
+        std::ostringstream message;
+        message << result.get_error();
+        throw std::out_of_range(message.str());
+    }
+    return result.get_options();
+}
+
+template<class Range>
+ParseResult OptionParser::try_parse(const Range& arguments) {
+    return try_parse_array(static_cast<int>(std::size(arguments)),
+                           std::data(arguments));
+}
+
 #endif
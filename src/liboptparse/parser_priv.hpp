@@ -0,0 +1,834 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      parser_priv.hpp
+ * \brief     Tokenizer and evaluator of the command line.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the template part of the parser: the tokenizer
+ * and the evaluator of the tokens. They are templates on the schema
+ * of the options, so the runtime parser and the static one (see
+ * static_parser.hh) share the same state machine, each with its own
+ * name lookup inlined.
+ *
+ * DEF: A type is a SCHEMA if it has the member functions
+ *        - option_id find(char) const
+ *        - option_id find(std::string_view) const
+ *        - OptionArgumentType get_type(option_id) const
+ *
+ * DEF: A type is a HANDLER if it has the member functions
+ *        - void on_program_name(const ArgumentText&)
+ *        - bool on_option(option_id)
+ *        - bool on_option(option_id, const ArgumentText&)
+ *        - void on_positional(const ArgumentText&)
+ *        - void on_end()
+ *      on_option is called with each option found, with its value if
+ *      it has one, and returns false if the value is not valid for
+ *      the option.
+ *
+ * Tokens are read lazily from argv and refer to it, so evaluating a
+ * command line does not allocate memory: allocations, if any, are
+ * made by the handler.
+ *
+ * Don't use this file directly! It is for internal use only.
+ */
+
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "argument_text.hh"
+#include "environment.hh"
+#include "hasher.hh"
+#include "optargs.hh"
+#include "option_index.hh"
+#include "options.hh"
+#include "parse_result.hh"
+#include "program_info.hh"
+#include "repeated_values.hh"
+#include "scanner.hh"
+
+#ifndef LIBOPTPARSE_PARSER_PRIV_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_PARSER_PRIV_INCLUDE_GUARD_HH 1
+
+namespace _LIBOPTPARSE_ {
+    enum TokenType {
+        MINUS,
+        NAME,
+        /*! An argument made of "--" only. */
+        SEPARATOR
+    };
+    
+    struct Token {
+        TokenType    type;
+        ArgumentText value;
+        int          index;
+        int          position;
+    };
+
+    /*!
+     * \brief Contiguous array of arguments of any string-like type.
+     *
+     * It refers to the caller's array without copying it: each
+     * argument is read as a string_view only when the tokenizer gets
+     * to it. Any type a string_view can be built from is accepted,
+     * e.g. const char* (NUL-terminated), std::string or
+     * std::string_view.
+     */
+    class ArgumentArray {
+    public:
+        /*! Type of the function reading an argument of a source. */
+        typedef std::string_view (*reader)(const void* source, int index);
+
+        /*! Initialize a view of the array passed. */
+        template<class T>
+        ArgumentArray(const T* data) noexcept
+            : _data(data), _read(&read<T>), _sized(true) { }
+
+        /*!
+         * Initialize a view of a source whose length is not known,
+         * e.g. a stream. Arguments are read in order, each one only
+         * after the previous one has been used, and a view with NULL
+         * data ends them.
+         */
+        ArgumentArray(const void* source, reader read) noexcept
+            : _data(source), _read(read), _sized(false) { }
+
+        /*! Gets the argument at the index passed. */
+        std::string_view operator[](int index) const {
+            return _read(_data, index);
+        }
+
+        /*! Checks if the argument passed ends a source not sized. */
+        bool is_end(std::string_view argument) const noexcept {
+            return !_sized && argument.data() == NULL;
+        }
+
+    private:
+        template<class T>
+        static std::string_view read(const void* data, int index) {
+            return std::string_view(static_cast<const T*>(data)[index]);
+        }
+
+        const void*      _data;
+        reader           _read;
+        bool             _sized;
+    };
+
+    /*!
+     * \brief Forward iterator over the tokens of argv.
+     *
+     * Tokens are read one at a time, the first time the iterator is
+     * dereferenced or compared after being incremented: arguments
+     * after the last token looked at are never read. A token never
+     * spans two arguments.
+     */
+    class TokenIterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Token                     value_type;
+        typedef std::ptrdiff_t            difference_type;
+        typedef const Token*              pointer;
+        typedef const Token&              reference;
+
+        /*! Initialize the end iterator of argv with argc arguments. */
+        explicit TokenIterator(int argc)
+            : _argc(argc), _argv(static_cast<const char**>(NULL)),
+              _arg(argc),
+              _begin(NULL), _current(NULL), _end(NULL), _token(),
+              _pending(false) { }
+
+        /*! Initialize an iterator to the first token of argv. */
+        TokenIterator(int argc, ArgumentArray argv)
+            : _argc(argc), _argv(argv), _arg(-1),
+              _begin(NULL), _current(NULL), _end(NULL), _token(),
+              _pending(true) { }
+
+        reference operator*() const {
+            resolve();
+            return _token;
+        }
+
+        pointer operator->() const {
+            resolve();
+            return &_token;
+        }
+
+        TokenIterator& operator++() {
+            resolve();
+            _pending = true;
+            return *this;
+        }
+
+        TokenIterator operator++(int) {
+            resolve();
+            TokenIterator old(*this);
+            _pending = true;
+            return old;
+        }
+
+        bool operator==(const TokenIterator& other) const {
+            resolve();
+            other.resolve();
+            return _arg == other._arg && _current == other._current;
+        }
+
+        bool operator!=(const TokenIterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        /*! Read the pending token, if any. */
+        void resolve() const {
+            if (_pending) {
+                _pending = false;
+                next();
+            }
+        }
+
+        /*! Read the next token, moving to the next argument if needed. */
+        void next() const {
+            while (true) {
+                if (_current == _end) {
+                    ++_arg;
+                    if (_arg >= _argc) {
+                        _arg = _argc;
+                        _current = NULL;
+                        return;
+                    }
+                    std::string_view argument = _argv[_arg];
+                    if (_argv.is_end(argument)) {
+                        _arg = _argc;
+                        _current = NULL;
+                        return;
+                    }
+                    _begin = _current = argument.data();
+                    _end = _begin + argument.size();
+                    continue;
+                }
+                int position = static_cast<int>(_current - _begin);
+                switch (*_current) {
+                case '=':
+                case ' ':
+                    ++_current;
+                    break;
+                case '-':
+                    if (position == 0 && _end - _begin == 2 &&
+                        _begin[1] == '-') {
+                        _token = Token {
+                            SEPARATOR, ArgumentText(), _arg, position };
+                        _current = _end;
+                    } else {
+                        _token = Token {
+                            MINUS, ArgumentText(), _arg, position };
+                        ++_current;
+                    }
+                    return;
+                default:
+                    _token = Token { NAME, read_name(), _arg, position };
+                    return;
+                }
+            }
+        }
+
+        /*!
+         * Read the name beginning at the current position and ending
+         * at the first not escaped space or equal.
+         */
+        ArgumentText read_name() const {
+            const char* name = _current;
+            bool escaped = false;
+            while (true) {
+                _current = find_delimiter(_current, _end);
+                if (_current == _end || *_current != '\\') {
+                    break;
+                }
+                escaped = true;
+                ++_current;
+                if (_current != _end) {
+                    ++_current;
+                }
+            }
+            return ArgumentText(
+                std::string_view(name, _current - name), escaped);
+        }
+
+        /* Reading is deferred: the state changes in const methods. */
+        int                  _argc;
+        ArgumentArray        _argv;
+        mutable int          _arg;
+        mutable const char*  _begin;
+        mutable const char*  _current;
+        mutable const char*  _end;
+        mutable Token        _token;
+        mutable bool         _pending;
+    };
+
+    /*! Max length of an escaped long name that can be looked up. */
+    const std::size_t MAX_ESCAPED_NAME = 256;
+
+    /*!
+     * Look up a long name, removing its escapes if it has.
+     * \return The id of the option, NO_OPTION_ID if there is not.
+     */
+    template<class Schema>
+    option_id find_long_name(const Schema& schema,
+                             const ArgumentText& name) {
+        if (!name.has_escapes()) {
+            return schema.find(name.raw());
+        }
+        char buffer[MAX_ESCAPED_NAME];
+        std::size_t size = name.size();
+        if (size > MAX_ESCAPED_NAME) {
+            return NO_OPTION_ID;
+        }
+        name.copy(buffer, size);
+        return schema.find(std::string_view(buffer, size));
+    }
+
+    /*!
+     * Schema of the runtime parser: names are looked up in the hash
+     * index, types are read from the option arguments.
+     */
+    struct RuntimeSchema {
+        const HashOptionIndex& index;
+        const std::vector<OptionArgument*>&   arguments;
+
+        option_id find(char short_name) const noexcept {
+            return index.find(short_name);
+        }
+
+        option_id find(std::string_view long_name) const noexcept {
+            return index.find(long_name);
+        }
+
+        OptionArgumentType get_type(option_id id) const noexcept {
+            return arguments[id] -> get_type();
+        }
+    };
+
+    /*! Error type parse_ok. */
+    constexpr ParseError NO_ERROR = { parse_ok, 0, 0 };
+
+    template<class ForwardIterator>
+    ParseError make_error(ParseErrorType type,
+                          ForwardIterator token,
+                          int offset = 0) {
+        return ParseError { type,
+                            token -> index,
+                            token -> position + offset };
+    }
+
+    /*
+     * Error reporters. They are called with each error found and
+     * return true if the parse has to go on.
+     */
+    struct FirstErrorReporter {
+        ParseError error = NO_ERROR;
+
+        bool operator()(const ParseError& found) {
+            error = found;
+            return false;
+        }
+    };
+
+    struct AllErrorsReporter {
+        std::vector<ParseError>& errors;
+
+        bool operator()(const ParseError& found) {
+            errors.push_back(found);
+            return true;
+        }
+    };
+
+    /*!
+     * Gets the value shared by options set without a value.
+     * \return A pointer to a "true" value.
+     */
+    const Options::value_type& true_value();
+
+    /*!
+     * Gets the value shared by flags set to false.
+     * \return A pointer to a "false" value.
+     */
+    const Options::value_type& false_value();
+
+    /*!
+     * Read the text of a flag given by the environment or a config:
+     * "true", "yes" and "1" set it, "false", "no" and "0" unset it,
+     * in any case.
+     * \return The canonical value of the flag, see true_value and
+     *         false_value; NULL if the text is not valid.
+     */
+    const Options::value_type* flag_value(std::string_view text) noexcept;
+
+    template<class ForwardIterator>
+    void parse_minus(ForwardIterator& itr, ForwardIterator end) {
+        while(itr != end && itr -> type != MINUS) {
+            ++itr;
+        }
+        ++itr;
+    }
+
+    template<class ForwardIterator,
+             class Schema,
+             class Handler,
+             class ErrorReporter>
+    bool parse_short_options(
+        ForwardIterator& itr,
+        ForwardIterator end,
+        const Schema& schema,
+        Handler& handler,
+        ErrorReporter& report) {
+        while(itr != end && itr -> type != NAME) {
+            ++itr;
+        }
+        if (itr == end) {
+            return true;
+        }
+        auto name = itr;
+        ArgumentText opt_name = itr -> value;
+        ++itr;
+
+        if (opt_name.size() > 1) {
+            std::string_view raw = opt_name.raw();
+            for (std::size_t i = 0; i < raw.size(); ++i) {
+                std::size_t offset = i;
+                if (raw[i] == '\\' && ++i == raw.size()) {
+                    break;
+                }
+                option_id id = schema.find(raw[i]);
+                ParseErrorType error = id == NO_OPTION_ID ?
+                    unknown_short_option :
+                    handler.on_option(id) ? parse_ok : invalid_option_value;
+                if (error != parse_ok &&
+                    !report(make_error(error, name, offset))) {
+                    return false;
+                }
+            }
+        } else {
+            char short_name = '\0';
+            opt_name.copy(&short_name, 1);
+            option_id id = schema.find(short_name);
+            if (id == NO_OPTION_ID) {
+                return report(make_error(unknown_short_option, name));
+            }
+            if (schema.get_type(id) == OptionArgumentType::flag) {
+                if (!handler.on_option(id)) {
+                    return report(make_error(invalid_option_value, name));
+                }
+            } else if (itr == end || itr -> type != NAME) {
+                return report(make_error(missing_option_value, name));
+            } else {
+                auto value = itr;
+                ++itr;
+                if (!handler.on_option(id, value -> value)) {
+                    return report(make_error(invalid_option_value, value));
+                }
+            }
+        }
+        return true;
+    }
+
+    template<class ForwardIterator,
+             class Schema,
+             class Handler,
+             class ErrorReporter>
+    bool parse_long_option(
+        ForwardIterator& itr,
+        ForwardIterator end,
+        const Schema& schema,
+        Handler& handler,
+        ErrorReporter& report) {
+        auto minus = itr;
+        while(itr != end && itr -> type != NAME) {
+            ++itr;
+        }
+        if (itr == end) {
+            return report(make_error(missing_option_name, minus));
+        }
+        auto name = itr;
+        option_id id = find_long_name(schema, itr -> value);
+        ++itr;
+        if (id == NO_OPTION_ID) {
+            return report(make_error(unknown_long_option, name));
+        }
+        if(schema.get_type(id) == OptionArgumentType::flag) {
+            if (!handler.on_option(id)) {
+                return report(make_error(invalid_option_value, name));
+            }
+        } else if (itr != end && itr -> type == NAME) {
+            auto value = itr;
+            ++itr;
+            if (!handler.on_option(id, value -> value)) {
+                return report(make_error(invalid_option_value, value));
+            }
+        } else {
+            return report(make_error(missing_option_value, name));
+        }
+        return true;
+    }
+
+    /*! State of an evaluation between two steps. */
+    struct EvaluationState {
+        /*! Where the evaluation stops. */
+        StopMode stop;
+
+        /*! True if the next name is the program name. */
+        bool     is_program_name;
+
+        /*! True if the evaluation stopped as requested by stop. */
+        bool     stopped;
+
+        /*! Index of the first argument not evaluated. */
+        int      tail;
+
+        explicit EvaluationState(StopMode stop_mode, int argc)
+            : stop(stop_mode),
+              is_program_name(true),
+              stopped(false),
+              tail(argc) { }
+    };
+
+    /*!
+     * Evaluate the next option or argument: one step of evaluate.
+     * \param itr   - Next token to evaluate, moved after the tokens
+     *                evaluated. When the evaluation stops it is not
+     *                moved, so the rest of argv is not read.
+     * \param state - State of the evaluation.
+     * \return False if the reporter stopped the evaluation.
+     */
+    template<class ForwardIterator,
+             class Schema,
+             class Handler,
+             class ErrorReporter>
+    bool evaluate_next(
+        ForwardIterator& itr,
+        ForwardIterator end,
+        EvaluationState& state,
+        const Schema& schema,
+        Handler& handler,
+        ErrorReporter& report) {
+        bool go_on = true;
+        switch(itr -> type) {
+        case SEPARATOR:
+            if (state.stop != stop_never) {
+                state.stopped = true;
+                state.tail = itr -> index + 1;
+            } else {
+                go_on = parse_long_option(
+                    itr, end, schema, handler, report);
+            }
+            break;
+        case MINUS:
+            parse_minus(itr, end);
+            if (itr != end && itr -> type == MINUS) {
+                go_on = parse_long_option(
+                    itr, end, schema, handler, report);
+            } else {
+                go_on = parse_short_options(
+                    itr, end, schema, handler, report);
+            }
+            break;
+        case NAME:
+            if (state.is_program_name) {
+                state.is_program_name = false;
+                handler.on_program_name(itr -> value);
+            } else if (state.stop == stop_at_positional) {
+                state.stopped = true;
+                state.tail = itr -> index;
+                break;
+            } else {
+                handler.on_positional(itr -> value);
+            }
+            ++itr;
+            break;
+        }
+        return go_on;
+    }
+
+    /*!
+     * Evaluate the tokens passed.
+     * \param state - State of the evaluation, on return its tail is
+     *                the index of the first argument not evaluated.
+     */
+    template<class ForwardIterator,
+             class Schema,
+             class Handler,
+             class ErrorReporter>
+    void evaluate(
+        ForwardIterator begin,
+        ForwardIterator end,
+        EvaluationState& state,
+        const Schema& schema,
+        Handler& handler,
+        ErrorReporter& report) {
+        auto itr = begin;
+        bool go_on = true;
+        while(itr != end && go_on && !state.stopped) {
+            go_on = evaluate_next(
+                itr, end, state, schema, handler, report);
+        }
+        if (go_on) {
+            handler.on_end();
+        }
+    }
+
+    /*!
+     * \brief Values of the options being parsed, by id, kept with
+     *        their digest.
+     */
+    struct ParsedValues {
+        Options::values_container values;
+        Options::given_container  given;
+        RepeatedValues            repeated;
+        OptionsDigest             digest;
+        /*! Source of the values read now, see next_source. */
+        unsigned                  source = 0;
+        /*! Source of the values of each repeated option, by id. */
+        std::vector<unsigned>     sources;
+
+        /*!
+         * Add the default value of the next option. The default of a
+         * flag is stored in its canonical form, "true" or "false"
+         * like it reads, so that it hashes like the flag set to the
+         * same value.
+         */
+        void add_default(OptionArgumentType type,
+                         Options::value_type value) {
+            if (type == OptionArgumentType::flag) {
+                value = static_cast<bool>(*value) ?
+                    true_value() : false_value();
+            }
+            digest.add_value(values.size(), value -> get_value());
+            values.push_back(std::move(value));
+            given.push_back(false);
+        }
+
+        /*! Set the value of the option with the id passed. */
+        void set(option_id id, Options::value_type value) {
+            digest.remove_value(id, values[id] -> get_value());
+            digest.add_value(id, value -> get_value());
+            values[id] = std::move(value);
+            given[id] = true;
+        }
+
+        /*!
+         * Start reading the values of a source taking precedence
+         * over the ones read before, e.g. the environment over a
+         * config file.
+         */
+        void next_source() noexcept {
+            ++source;
+        }
+
+        /*!
+         * Append a value of the repeated option with the id passed.
+         * The first value of a source replaces the ones of the
+         * sources before, the next ones are appended to it.
+         */
+        template<class Text>
+        void append(option_id id, const Text& value) {
+            if (sources.size() <= id) {
+                sources.resize(values.size(), 0);
+            }
+            if (sources[id] != source) {
+                sources[id] = source;
+                repeated.drop(id, [this, id](std::size_t position,
+                                             std::string_view text) {
+                    digest.remove_repeated(id, position, text);
+                });
+            }
+            std::size_t position = repeated.add(id, value);
+            digest.add_repeated(id, position, repeated.back());
+            given[id] = true;
+        }
+
+        /*!
+         * Set the value of the option with the id passed, read from
+         * the environment or a config, appending it if the option is
+         * repeated. The value of a flag is stored in its canonical
+         * form, see flag_value.
+         * \return False if the value is not valid for a flag.
+         */
+        bool store(option_id id,
+                   OptionArgumentType type,
+                   std::string_view value) {
+            if (type == OptionArgumentType::flag) {
+                const Options::value_type* flag = flag_value(value);
+                if (flag == NULL) {
+                    return false;
+                }
+                set(id, *flag);
+            } else if (type == OptionArgumentType::repeated) {
+                append(id, value);
+            } else {
+                set(id, Options::value_type(
+                        new OptionArgumentValue(std::string(value))));
+            }
+            return true;
+        }
+    };
+
+    /*!
+     * Replace the values passed, defaults or read from a config,
+     * with the ones of the variables of the environment passed
+     * matched by the matcher passed. It is shared by the parsers, so
+     * they read the environment the same way.
+     * \param envp - Environment, see EnvironmentMatcher::scan.
+     * \return False if an error stopped the parse.
+     */
+    template<class Schema, class ErrorReporter>
+    bool read_environment(const char* const* envp,
+                          const EnvironmentMatcher& matcher,
+                          const Schema& schema,
+                          ParsedValues& parsed,
+                          ErrorReporter& report) {
+        parsed.next_source();
+        bool go_on = true;
+        matcher.scan(envp, [&](option_id id, std::string_view value) {
+            if (go_on && !parsed.store(id, schema.get_type(id), value)) {
+                go_on = report(ParseError { invalid_option_value, -1, 0 });
+            }
+        });
+        return go_on;
+    }
+
+    /*! Handler building the values of Options. */
+    template<class Schema>
+    struct OptionsBuilder {
+        ProgramInfo&                  program_info;
+        const Schema&                 schema;
+        ParsedValues&                 parsed;
+        Options::arguments_container& arguments;
+
+        void on_program_name(const ArgumentText& name) {
+            if (program_info.program_name.empty()) {
+                program_info.program_name = name.str();
+            }
+        }
+
+        bool on_option(option_id id) {
+            if (schema.get_type(id) == OptionArgumentType::repeated) {
+                parsed.append(id, true_value() -> get_value());
+            } else {
+                parsed.set(id, true_value());
+            }
+            return true;
+        }
+
+        bool on_option(option_id id, const ArgumentText& value) {
+            if (schema.get_type(id) == OptionArgumentType::repeated) {
+                parsed.append(id, value);
+            } else {
+                parsed.set(id, Options::value_type(
+                               new OptionArgumentValue(value.str())));
+            }
+            return true;
+        }
+
+        void on_positional(const ArgumentText& value) {
+            arguments.push_back(
+                Options::value_type(new OptionArgumentValue(value.str())));
+            parsed.digest.add_argument(arguments.back() -> get_value());
+        }
+
+        void on_end() { }
+    };
+
+    /*!
+     * Evaluate the command line with the schema passed.
+     * \param schema  - Schema used to look up the names.
+     * \param handler - Handler of the options found.
+     * \param report  - Reporter of the errors found.
+     * \param stop    - Where the evaluation stops.
+     * \return The index of the first argument not evaluated.
+     */
+    template<class Schema, class Handler, class ErrorReporter>
+    int evaluate_command_line(int argc,
+                              ArgumentArray argv,
+                              const Schema& schema,
+                              Handler& handler,
+                              ErrorReporter& report,
+                              StopMode stop = stop_never) {
+        EvaluationState state(stop, argc);
+        evaluate(TokenIterator(argc, argv),
+                 TokenIterator(argc),
+                 state,
+                 schema,
+                 handler,
+                 report);
+        return state.tail;
+    }
+
+    /*!
+     * Parse the command line with the schema passed.
+     * \param program_info - Informations of the program. It is not
+     *                       changed: if its name is empty, the
+     *                       options returned are named by argv[0].
+     * \param schema       - Schema used to look up the names.
+     * \param index        - Index shared with the options returned.
+     * \param parsed       - Values of the options: defaults and the
+     *                       ones already set, e.g. by the
+     *                       environment.
+     * \param report       - Reporter of the errors found.
+     * \param stop         - Where the parse stops.
+     * \param tail         - Set to the index of the first argument not
+     *                       parsed.
+     * \return The parsed options. They are not meaningful if an error
+     *         has been reported.
+     */
+    template<class Schema, class ErrorReporter>
+    std::unique_ptr<const Options> parse_command_line(
+        int argc,
+        ArgumentArray argv,
+        const ProgramInfo& program_info,
+        const Schema& schema,
+        std::shared_ptr<const OptionIndex> index,
+        ParsedValues&& parsed,
+        ErrorReporter& report,
+        StopMode stop,
+        int& tail) {
+        Options::arguments_container args_values;
+        /* The parser may be shared: argv[0] names this parse only. */
+        ProgramInfo parse_info(program_info);
+        parsed.next_source();
+        OptionsBuilder<Schema> builder {
+            parse_info, schema, parsed, args_values };
+        tail = evaluate_command_line(
+            argc, argv, schema, builder, report, stop);
+        return std::unique_ptr<const Options>(
+            new Options(
+                parse_info,
+                std::move(index),
+                std::move(parsed.values),
+                std::move(parsed.given),
+                OptionsFingerprint {
+                    parsed.digest.digest_low(),
+                    parsed.digest.digest_high() },
+                std::move(parsed.repeated),
+                args_values.cbegin(),
+                args_values.cend()));
+    }
+}
+
+#endif
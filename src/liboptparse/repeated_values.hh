@@ -0,0 +1,211 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      repeated_values.hh
+ * \brief     Values of options given more than once.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the storage of the values of repeated options,
+ * e.g. "-I dir1 -I dir2", and the view used to read them.
+ */
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "argument_text.hh"
+#include "binding.hh"
+#include "option_index.hh"
+
+#ifndef LIBOPTPARSE_REPEATED_VALUES_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_REPEATED_VALUES_INCLUDE_GUARD_HH 1
+
+/*!
+ * \brief Contiguous read only array of the values of an option.
+ *
+ * Values are views on text owned by the Options they come from, so
+ * they live as long as it does.
+ */
+class ValueSpan {
+public:
+    /*! Default constructor. Initialize an empty array. */
+    constexpr ValueSpan() noexcept : _data(NULL), _size(0) { }
+
+    /*! Constructor with two parameters: first value and count. */
+    constexpr ValueSpan(const std::string_view* data,
+                        std::size_t size) noexcept
+        : _data(data), _size(size) { }
+
+    const std::string_view* data() const noexcept {
+        return _data;
+    }
+
+    std::size_t size() const noexcept {
+        return _size;
+    }
+
+    bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    const std::string_view* begin() const noexcept {
+        return _data;
+    }
+
+    const std::string_view* end() const noexcept {
+        return _data + _size;
+    }
+
+    /*!
+     * Gets the value in the position passed.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  position less than size().
+     */
+    std::string_view operator[](std::size_t position) const noexcept {
+        return _data[position];
+    }
+
+    /*!
+     * Convert all the values, appending them to the vector passed,
+     * e.g. into std::vector<int> or std::vector<std::string>.
+     * \return False if a value is not valid for type T: the values
+     *         before it have been appended.
+     */
+    template<class T>
+    bool convert(std::vector<T>& destination) const {
+        destination.reserve(destination.size() + _size);
+        for (std::size_t i = 0; i < _size; ++i) {
+            T value;
+            if (!_LIBOPTPARSE_::convert_value(_data[i], value)) {
+                return false;
+            }
+            destination.push_back(std::move(value));
+        }
+        return true;
+    }
+
+private:
+    const std::string_view* _data;
+    std::size_t             _size;
+};
+
+namespace _LIBOPTPARSE_ {
+    /*!
+     * \brief Values of the repeated options of a command line.
+     *
+     * Values are appended, in the order they are found, to a single
+     * buffer of text. Once all of them are known the storage is
+     * frozen: values are grouped by option id into one array of
+     * std::string_view, so the values of each option are contiguous.
+     * Nothing is allocated until the first value.
+     */
+    class RepeatedValues {
+    public:
+        /*! Default constructor. Initialize an empty storage. */
+        RepeatedValues() noexcept;
+
+        /*! Move constructor. */
+        RepeatedValues(RepeatedValues&&) = default;
+
+        /*!
+         * Append a value of the option with the id passed.
+         * \return The number of values of the option before it.
+         *
+         * <h3> CONTRACT </h3>
+         * \pre  This is not frozen.
+         */
+        std::size_t add(option_id id, const ArgumentText& value);
+
+        /*! Append a value of the option with the id passed. */
+        std::size_t add(option_id id, std::string_view value);
+
+        /*! Gets the text of the last value added. */
+        std::string_view back() const noexcept;
+
+        /*!
+         * Drop the values of the option with the id passed added so
+         * far, calling on_value with the position and the text of
+         * each of them. Their text is not reclaimed.
+         *
+         * <h3> CONTRACT </h3>
+         * \pre  This is not frozen.
+         */
+        template<class Callback>
+        void drop(option_id id, Callback on_value) {
+            if (id >= _counts.size() || _counts[id] == 0) {
+                return;
+            }
+            std::size_t position = 0;
+            for (Occurrence& occurrence : _occurrences) {
+                if (occurrence.id == id) {
+                    on_value(position++, std::string_view(
+                                 _text.data() + occurrence.offset,
+                                 occurrence.size));
+                    occurrence.id = NO_OPTION_ID;
+                }
+            }
+            _counts[id] = 0;
+        }
+
+        /*!
+         * Group the values by option id. Views on the text are taken
+         * here, so this object must not be moved anymore.
+         * \param options - Number of options.
+         */
+        void freeze(std::size_t options);
+
+        /*!
+         * Gets the values of the option with the id passed.
+         *
+         * <h3> CONTRACT </h3>
+         * \pre  This is frozen.
+         */
+        ValueSpan get(option_id id) const noexcept;
+
+    private:
+        RepeatedValues(const RepeatedValues&);
+        RepeatedValues& operator=(const RepeatedValues&);
+
+        /*!
+         * A value found, before values are grouped. Dropped values
+         * have NO_OPTION_ID as id.
+         */
+        struct Occurrence {
+            option_id   id;
+            std::size_t offset;
+            std::size_t size;
+        };
+
+        /*! Begin of the space for a value of the size passed. */
+        char* reserve(option_id id, std::size_t size);
+
+        std::vector<char>             _text;
+        std::vector<Occurrence>       _occurrences;
+        /*! Number of values by option id, cursors while freezing. */
+        std::vector<std::size_t>      _counts;
+        /*! Values, grouped by option id. */
+        std::vector<std::string_view> _values;
+        /*! Position in _values of the values of each option. */
+        std::vector<std::size_t>      _offsets;
+    };
+}
+
+#endif
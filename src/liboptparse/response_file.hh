@@ -0,0 +1,237 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      response_file.hh
+ * \brief     Expansion of @file response files.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the expansion of the arguments "@path" into the
+ * arguments written inside the file path, used to pass command lines
+ * longer than the system allows.
+ */
+
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "parse_result.hh"
+
+#ifndef LIBOPTPARSE_RESPONSE_FILE_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_RESPONSE_FILE_INCLUDE_GUARD_HH 1
+
+/*! \brief Limits of the expansion of response files. */
+struct ResponseFileLimits {
+    /*! Max number of bytes of all the files of a command line. */
+    std::size_t max_bytes;
+
+    /*!
+     * Max number of files open one inside the other: 1 allows
+     * response files in argv only.
+     */
+    int         max_depth;
+};
+
+/*!
+ * \brief Arguments of a command line with response files expanded.
+ *
+ * Each argument of argv, but the program name, beginning with '@' is
+ * replaced by the arguments written inside the file it names. Inside
+ * the file arguments are separated by spaces, tabs and newlines, and
+ * a backslash escapes the next char, like in the arguments read by
+ * the tokenizer (see ArgumentText). An argument of a file beginning
+ * with '@' is a nested response file, its path relative to the
+ * working directory.
+ *
+ * Files are mapped in memory and read in place: arguments are
+ * slices of the mappings, kept in the escaped form the tokenizer
+ * reads, so nothing is copied. It is a contiguous range of
+ * std::string_view, so it is parsed passing it to
+ * OptionParser::parse(const Range&); the mappings live as long as
+ * this object. Each argument keeps the index of the argument of argv
+ * it comes from, to map a position of the expanded command line back
+ * to argv.
+ */
+class ResponseFiles {
+public:
+    /*! Default constructor. Initialize an empty command line. */
+    ResponseFiles();
+
+    /*! Default destructor. Unmap the files. */
+    ~ResponseFiles();
+
+    /*!
+     * Expand the response files of the command line passed,
+     * replacing the arguments held by this object.
+     * \param argv   - Arguments, any array whose items
+     *                 std::string_view can be built from.
+     * \param limits - Limits of the expansion.
+     * \return The first error found, parse_ok if there is not. Its
+     *         index is the one of the argument of argv that names
+     *         the file with the error, directly or by nesting:
+     *         unreadable_response_file if a file can not be read,
+     *         response_file_too_large if files exceed max_bytes and
+     *         nested_response_file if files are nested deeper than
+     *         max_depth or a file includes itself.
+     *
+     * <h3> CONTRACT </h3>
+     * \pre  argc less than equals size of argv vector, max_depth
+     *       greater than 0.
+     * \post If no error is returned the arguments are the expanded
+     *       command line.
+     */
+    template<class Arguments>
+    ParseError expand(int argc,
+                      const Arguments& argv,
+                      const ResponseFileLimits& limits);
+
+    /*! Gets the arguments, in the tokenizer escaped form. */
+    const std::string_view* data() const noexcept {
+        return _arguments.data();
+    }
+
+    /*! Gets the number of arguments. */
+    std::size_t size() const noexcept {
+        return _arguments.size();
+    }
+
+    const std::string_view* begin() const noexcept {
+        return _arguments.data();
+    }
+
+    const std::string_view* end() const noexcept {
+        return _arguments.data() + _arguments.size();
+    }
+
+    /*!
+     * Gets the index inside argv of the argument at the position
+     * passed, or of the response file it is read from, directly or
+     * by nesting.
+     * \pre position less than size().
+     */
+    int get_origin(std::size_t position) const noexcept {
+        int origin = _origins[position];
+        return origin < 0 ? ~origin : origin;
+    }
+
+    /*!
+     * Checks if the argument at the position passed is read from a
+     * response file.
+     * \pre position less than size().
+     */
+    bool is_from_file(std::size_t position) const noexcept {
+        return _origins[position] < 0;
+    }
+
+    /*! Gets the number of bytes of the files mapped. */
+    std::size_t get_mapped_bytes() const noexcept {
+        return _bytes;
+    }
+
+    /*!
+     * Checks if a command line has response files to expand.
+     * \return True if an argument, but the program name, begins with
+     *         '@'.
+     */
+    static bool has_response_files(int argc, const char *argv[]);
+
+    /*! Same as has_response_files(int, const char*[]) for any array. */
+    template<class Arguments>
+    static bool has_response_files(int argc, const Arguments& argv);
+
+private:
+    ResponseFiles(const ResponseFiles&);
+    ResponseFiles& operator=(const ResponseFiles&);
+
+    /*! Identity of a file: device and inode. */
+    typedef std::pair<unsigned long long, unsigned long long> file_id;
+
+    /*! Checks if the argument passed names a response file. */
+    static bool is_response_file(std::string_view argument) noexcept {
+        return argument.size() > 1 && argument[0] == '@';
+    }
+
+    /*!
+     * Map the file passed and add its arguments.
+     * \param origin - Index inside argv of the argument naming the
+     *                 file, directly or by nesting.
+     */
+    ParseErrorType include(const std::string& path,
+                           const ResponseFileLimits& limits,
+                           std::vector<file_id>& open_files,
+                           int origin);
+
+    /*! Unmap the files and drop the arguments. */
+    void clear() noexcept;
+
+    /*! A file mapped in memory. */
+    struct Mapping {
+        void*       address;
+        std::size_t size;
+    };
+
+    std::vector<std::string_view> _arguments;
+    /*!
+     * Index inside argv each argument comes from, complemented (~)
+     * if the argument is read from a response file.
+     */
+    std::vector<int>              _origins;
+    std::vector<Mapping>          _mappings;
+    std::size_t                   _bytes;
+};
+
+template<class Arguments>
+ParseError ResponseFiles::expand(int argc,
+                                 const Arguments& argv,
+                                 const ResponseFileLimits& limits) {
+    assert(limits.max_depth > 0);
+    clear();
+    _arguments.reserve(argc);
+    _origins.reserve(argc);
+    std::vector<file_id> open_files;
+    for (int i = 0; i < argc; ++i) {
+        std::string_view argument(argv[i]);
+        if (i == 0 || !is_response_file(argument)) {
+            _arguments.push_back(argument);
+            _origins.push_back(i);
+            continue;
+        }
+        ParseErrorType error = include(
+            std::string(argument.substr(1)), limits, open_files, i);
+        if (error != parse_ok) {
+            return ParseError { error, i, 0 };
+        }
+    }
+    return ParseError { parse_ok, 0, 0 };
+}
+
+template<class Arguments>
+bool ResponseFiles::has_response_files(int argc, const Arguments& argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (is_response_file(std::string_view(argv[i]))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
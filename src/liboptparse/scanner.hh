@@ -0,0 +1,95 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      scanner.hh
+ * \brief     Delimiter scanner used by the tokenizer.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the routines used by the tokenizer to find the
+ * end of a name inside an argument. Long values (base64 blobs,
+ * inline json, ...) are scanned 16 or 32 bytes at a time when the
+ * CPU supports it. It is for internal use only, do not include this
+ * header in your project file.
+ */
+
+#ifndef LIBOPTPARSE_SCANNER_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_SCANNER_INCLUDE_GUARD_HH 1
+
+namespace _LIBOPTPARSE_ {
+    /*!
+     * Type of the routines used to find the next delimiter.
+     * \param begin - Pointer to the first char to scan.
+     * \param end   - Pointer to the next char after the last one to
+     *                scan.
+     * \return Pointer to the first DELIMITER in [begin, end), end if
+     *         there is not.
+     */
+    typedef const char* (*delimiter_finder)(const char* begin,
+                                            const char* end);
+
+    /*!
+     * Find the next delimiter in the range passed.
+     * DEF: A char is a DELIMITER if it is a space, an equal or a
+     *      backslash (the escape char). Minus is not a delimiter:
+     *      it is meaningful only at the begin of a name and the
+     *      tokenizer checks it before scanning.
+     *
+     * This function uses the fastest routine available on the
+     * running CPU, selected the first time it is called.
+     * \param begin - Pointer to the first char to scan.
+     * \param end   - Pointer to the next char after the last one to
+     *                scan.
+     * \return Pointer to the first delimiter in [begin, end), end if
+     *         there is not.
+     */
+    const char* find_delimiter(const char* begin, const char* end);
+
+    /*!
+     * Byte at a time version of find_delimiter, always available.
+     * See find_delimiter.
+     */
+    const char* find_delimiter_scalar(const char* begin,
+                                      const char* end);
+
+    /*!
+     * Gets the routine used by find_delimiter on the running CPU.
+     * \return A not NULL delimiter finder.
+     */
+    delimiter_finder get_delimiter_finder();
+
+    /*!
+     * Gets the name of the routine used by find_delimiter on the
+     * running CPU.
+     * \return "avx2", "sse2" or "scalar".
+     */
+    const char* get_delimiter_finder_name();
+
+    /*!
+     * Gets the routine with the name passed, if it is supported by
+     * the running CPU. Used to compare implementations.
+     * \param name - One of the names returned by
+     *               get_delimiter_finder_name.
+     * \return The routine with that name, NULL if it is unknown or
+     *         not supported.
+     */
+    delimiter_finder get_delimiter_finder(const char* name);
+}
+
+#endif
@@ -0,0 +1,111 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      shell_split.hh
+ * \brief     Shell-style splitting of a whole command string.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the splitter used to turn a command string,
+ * e.g. read from a socket, into the arguments OptionParser parses.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef LIBOPTPARSE_SHELL_SPLIT_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_SHELL_SPLIT_INCLUDE_GUARD_HH 1
+
+/*!
+ * \brief Arguments of a command string split like a shell does.
+ *
+ * Words are separated by spaces, tabs and newlines. Inside single
+ * quotes every char is literal; inside double quotes a backslash
+ * escapes only '"' and '\\'; outside quotes a backslash escapes any
+ * char.
+ *
+ * Words are kept in the escaped form read by the tokenizer (see
+ * ArgumentText): a word without quotes is a slice of the command
+ * string, backslashes included, and so is a word made of a single
+ * quoted text without spaces, '=' or backslashes. Only the other
+ * quoted words are copied, escaping the chars the tokenizer would
+ * take as delimiters, into a single buffer allocated at the first
+ * of them. It is a contiguous range of std::string_view, so it is
+ * parsed passing it to OptionParser::parse(const Range&).
+ * The command string must live as long as this object.
+ */
+class ShellSplit {
+public:
+    /*!
+     * Constructor with one parameter. Split the command passed.
+     * \param command - Command string to split.
+     * \throw std::invalid_argument if a quote is not closed.
+     */
+    explicit ShellSplit(std::string_view command);
+
+    /*! Move constructor. Slices keep referring to the command. */
+    ShellSplit(ShellSplit&&) = default;
+
+    /*! Gets the words found, in the tokenizer escaped form. */
+    const std::string_view* data() const noexcept {
+        return _words.data();
+    }
+
+    /*! Gets the number of words found. */
+    std::size_t size() const noexcept {
+        return _words.size();
+    }
+
+    const std::string_view* begin() const noexcept {
+        return _words.data();
+    }
+
+    const std::string_view* end() const noexcept {
+        return _words.data() + _words.size();
+    }
+
+    /*!
+     * Gets the number of words that have been copied to remove
+     * quotes. Used to check that plain words are not copied.
+     */
+    std::size_t copied() const noexcept {
+        return _copied;
+    }
+
+private:
+    ShellSplit(const ShellSplit&);
+    ShellSplit& operator=(const ShellSplit&);
+
+    /*! Add the quoted word passed, copying it only if needed. */
+    void add_quoted(std::string_view word);
+
+    std::vector<std::string_view> _words;
+    /*!
+     * Storage of the copied words, allocated at the first one with
+     * room for the rest of the command: it never moves.
+     */
+    std::unique_ptr<char[]>       _buffer;
+    std::size_t                   _used;
+    std::size_t                   _copied;
+};
+
+#endif
@@ -0,0 +1,257 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      static_parser.hh
+ * \brief     Parser with options fixed at compile time.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the definition of the parser whose options are
+ * described by a constexpr array of OptionSpec. Names are checked
+ * and indexed at compile time, so creating the parser does no work.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "optargs.hh"
+#include "option_index.hh"
+#include "options.hh"
+#include "parse_result.hh"
+#include "parser_priv.hpp"
+#include "program_info.hh"
+#include "static_parser_priv.hpp"
+
+#ifndef LIBOPTPARSE_STATIC_PARSER_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_STATIC_PARSER_INCLUDE_GUARD_HH 1
+
+namespace _LIBOPTPARSE_ {
+    /*!
+     * \brief Index over the tables built at compile time.
+     *
+     * Ids are the positions of the specs inside the array.
+     */
+    template<const auto& Specs>
+    class StaticOptionIndex : public OptionIndex {
+    public:
+        /*! Number of options. */
+        static constexpr std::size_t SIZE =
+            std::extent<std::remove_reference_t<decltype(Specs)>>::value;
+
+        /*! Lookup tables of the specs. */
+        static constexpr StaticTables<SIZE> TABLES =
+            build_static_tables(Specs);
+
+        constexpr StaticOptionIndex() : OptionIndex(TABLES.shorts) { }
+
+        using OptionIndex::find;
+
+        /*! Same as find(std::string_view), but not virtual. */
+        static constexpr option_id find_long(std::string_view long_name) {
+            return find_static(Specs, TABLES, long_name);
+        }
+
+        option_id find(std::string_view long_name) const noexcept override {
+            return find_long(long_name);
+        }
+
+        char get_short_name(option_id id) const noexcept override {
+            return Specs[id].short_name;
+        }
+
+        std::string_view get_long_name(
+            option_id id) const noexcept override {
+            return spec_long_name(Specs[id]);
+        }
+
+        std::size_t size() const noexcept override {
+            return SIZE;
+        }
+    };
+
+    /*!
+     * Schema of the static parser: names are looked up in the compile
+     * time tables, types are read from the specs.
+     */
+    template<const auto& Specs>
+    struct StaticSchema {
+        option_id find(char short_name) const noexcept {
+            return StaticOptionIndex<Specs>::TABLES.shorts[
+                static_cast<unsigned char>(short_name)];
+        }
+
+        option_id find(std::string_view long_name) const noexcept {
+            return StaticOptionIndex<Specs>::find_long(long_name);
+        }
+
+        OptionArgumentType get_type(option_id id) const noexcept {
+            return Specs[id].type;
+        }
+    };
+}
+
+/*!
+ * \brief Parser of a set of options fixed at compile time.
+ *
+ * Specs is a constexpr array of OptionSpec with static storage
+ * duration. Its names must follow the same rules of OptionParser
+ * (see is_valid_names utility function) and must not be repeated:
+ * otherwise the program does not compile. Options are identified by
+ * their position inside Specs and the options returned by parse are
+ * the same returned by an OptionParser with the same options added
+ * in the same order.
+ *
+ * Example:
+ *
+ *     constexpr OptionSpec specs[] = {
+ *         { 'v', "verbose", flag, "false" },
+ *         { 'o', "output", value, "a.out" }
+ *     };
+ *     StaticOptionParser<specs> parser;
+ */
+template<const auto& Specs>
+class StaticOptionParser {
+public:
+    /*! Index type of this parser. */
+    typedef _LIBOPTPARSE_::StaticOptionIndex<Specs> index_type;
+
+    static_assert(index_type::TABLES.valid_names,
+                  "invalid option names");
+    static_assert(index_type::TABLES.unique_names,
+                  "duplicate option names");
+    static_assert(index_type::TABLES.perfect,
+                  "unable to build the long names hash table");
+
+    /*! Default constructor. */
+    StaticOptionParser() : _program_info() { }
+
+    /*!
+     * Constructor with one parameter.
+     * \param program_info - Informations of the program.
+     */
+    explicit StaticOptionParser(const ProgramInfo& program_info)
+        : _program_info(program_info) { }
+
+    /*! Gets the number of options. */
+    static constexpr std::size_t size() noexcept {
+        return index_type::SIZE;
+    }
+
+    /*!
+     * Gets the id of the option with the short name passed.
+     * \return The id of the option, NO_OPTION_ID if there is not.
+     */
+    static constexpr option_id find(char short_name) noexcept {
+        return index_type::TABLES.shorts[
+            static_cast<unsigned char>(short_name)];
+    }
+
+    /*!
+     * Gets the id of the option with the long name passed.
+     * \return The id of the option, NO_OPTION_ID if there is not.
+     */
+    static constexpr option_id find(std::string_view long_name) noexcept {
+        return index_type::find_long(long_name);
+    }
+
+    /*!
+     * Same as OptionParser::parse.
+     * \throw std::out_of_range if the command line is not valid.
+     */
+    std::unique_ptr<const Options> parse(int argc, const char *argv[]) {
+        ParseResult result = try_parse(argc, argv);
+        if (!result.is_ok()) {
+            std::ostringstream message;
+            message << result.get_error();
+            throw std::out_of_range(message.str());
+        }
+        return result.get_options();
+    }
+
+    /*! Same as OptionParser::try_parse. */
+    ParseResult try_parse(int argc, const char *argv[]) {
+        _LIBOPTPARSE_::FirstErrorReporter report;
+        auto options = parse(argc, argv, report);
+        if (report.error.type != parse_ok) {
+            return ParseResult(report.error);
+        }
+        return ParseResult(std::move(options));
+    }
+
+    /*! Same as OptionParser::try_parse collecting all errors. */
+    ParseResult try_parse(int argc,
+                          const char *argv[],
+                          std::vector<ParseError>& errors) {
+        std::size_t first = errors.size();
+        _LIBOPTPARSE_::AllErrorsReporter report { errors };
+        auto options = parse(argc, argv, report);
+        if (errors.size() != first) {
+            return ParseResult(errors[first]);
+        }
+        return ParseResult(std::move(options));
+    }
+
+private:
+    template<class ErrorReporter>
+    std::unique_ptr<const Options> parse(int argc,
+                                         const char *argv[],
+                                         ErrorReporter& report) {
+        _LIBOPTPARSE_::ParsedValues parsed;
+        parsed.values.reserve(size());
+        for (const OptionSpec& spec : Specs) {
+            parsed.add_default(
+                spec.type,
+                Options::value_type(
+                    new OptionArgumentValue(
+                        spec.default_value != nullptr ?
+                        spec.default_value : "")));
+        }
+        int tail = 0;
+        /* The index is static: the options do not own it. */
+        std::shared_ptr<const _LIBOPTPARSE_::OptionIndex> index(
+            std::shared_ptr<void>(), &INDEX);
+        return _LIBOPTPARSE_::parse_command_line(
+            argc,
+            argv,
+            _program_info,
+            _LIBOPTPARSE_::StaticSchema<Specs>(),
+            std::move(index),
+            std::move(parsed),
+            report,
+            stop_never,
+            tail);
+    }
+
+    /*! Index shared by all the options parsed. */
+    static const index_type INDEX;
+
+    /*! Informations of the program. */
+    ProgramInfo _program_info;
+};
+
+template<const auto& Specs>
+const typename StaticOptionParser<Specs>::index_type
+StaticOptionParser<Specs>::INDEX;
+
+#endif
@@ -0,0 +1,241 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      static_parser_priv.hpp
+ * \brief     Compile time tables of the static parser.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the constexpr functions used to check an option
+ * schema and to build its lookup tables at compile time. Long names
+ * are found through a perfect hash built with hash and displace:
+ * names are split in buckets by a first hash, then for each bucket,
+ * the biggest first, a seed is searched so that its names land in
+ * free slots.
+ *
+ * Don't use this file directly! It is for internal use only.
+ */
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "optargs.hh"
+#include "utils.hh"
+
+#ifndef LIBOPTPARSE_STATIC_PARSER_PRIV_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_STATIC_PARSER_PRIV_INCLUDE_GUARD_HH 1
+
+namespace _LIBOPTPARSE_ {
+    /*! Max number of seeds tried for a bucket. */
+    constexpr std::uint32_t MAX_DISPLACEMENT = 1u << 16;
+
+    /*! FNV-1a hash of the name passed. */
+    constexpr std::uint64_t hash_name(std::string_view name) {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        for (char c : name) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    /*! Mix a name hash with a seed (splitmix64 finalizer). */
+    constexpr std::uint64_t mix_hash(std::uint64_t hash,
+                                     std::uint32_t seed) {
+        hash += 0x9e3779b97f4a7c15ull * (seed + 1ull);
+        hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+        hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+        return hash ^ (hash >> 31);
+    }
+
+    /*! Smallest power of two not less than n. */
+    constexpr std::size_t ceil_pow2(std::size_t n) {
+        std::size_t pow = 1;
+        while (pow < n) {
+            pow <<= 1;
+        }
+        return pow;
+    }
+
+    /*!
+     * \brief Lookup tables of a schema with N options.
+     *
+     * The slot table has at least 2N entries and the bucket table
+     * half of them, so buckets hold a couple of names on average.
+     */
+    template<std::size_t N>
+    struct StaticTables {
+        static constexpr std::size_t SLOTS = ceil_pow2(2 * N);
+        static constexpr std::size_t BUCKETS = SLOTS / 2;
+
+        /*! Id of the option for each short name. */
+        option_id     shorts[UCHAR_MAX + 1];
+
+        /*! Seed of each bucket. */
+        std::uint32_t displacements[BUCKETS];
+
+        /*! Id of the option for each slot, NO_OPTION_ID if free. */
+        option_id     longs[SLOTS];
+
+        /*! Each option has valid names. */
+        bool          valid_names;
+
+        /*! No name is used by two options. */
+        bool          unique_names;
+
+        /*! A seed has been found for each bucket. */
+        bool          perfect;
+    };
+
+    /*! Gets the long name of the spec passed, empty if it has not. */
+    constexpr std::string_view spec_long_name(const OptionSpec& spec) {
+        return spec.long_name != nullptr ?
+            std::string_view(spec.long_name) :
+            std::string_view();
+    }
+
+    /*!
+     * Build the lookup tables of the specs passed.
+     * \return The tables, check their flags before using them.
+     */
+    template<std::size_t N>
+    constexpr StaticTables<N> build_static_tables(
+        const OptionSpec (&specs)[N]) {
+        typedef StaticTables<N> tables_type;
+        tables_type tables {};
+        tables.valid_names = true;
+        tables.unique_names = true;
+        tables.perfect = true;
+        for (option_id& entry : tables.shorts) {
+            entry = NO_OPTION_ID;
+        }
+        for (option_id& entry : tables.longs) {
+            entry = NO_OPTION_ID;
+        }
+
+        std::uint64_t hashes[N] {};
+        std::size_t bucket_of[N] {};
+        std::size_t bucket_begin[tables_type::BUCKETS + 1] {};
+        for (std::size_t id = 0; id < N; ++id) {
+            char short_name = specs[id].short_name;
+            std::string_view long_name = spec_long_name(specs[id]);
+            tables.valid_names = tables.valid_names &&
+                is_valid_names(short_name, long_name);
+            if (short_name != '\0') {
+                option_id& entry =
+                    tables.shorts[static_cast<unsigned char>(short_name)];
+                tables.unique_names = tables.unique_names &&
+                    entry == NO_OPTION_ID;
+                entry = id;
+            }
+            hashes[id] = hash_name(long_name);
+            for (std::size_t other = 0;
+                 other < id && !long_name.empty();
+                 ++other) {
+                tables.unique_names = tables.unique_names &&
+                    (hashes[other] != hashes[id] ||
+                     long_name != spec_long_name(specs[other]));
+            }
+            bucket_of[id] =
+                mix_hash(hashes[id], 0) % tables_type::BUCKETS;
+            if (!long_name.empty()) {
+                ++bucket_begin[bucket_of[id] + 1];
+            }
+        }
+
+        /* Ids with a long name sorted by bucket. */
+        std::size_t max_size = 0;
+        for (std::size_t bucket = 0;
+             bucket < tables_type::BUCKETS;
+             ++bucket) {
+            std::size_t size = bucket_begin[bucket + 1];
+            max_size = size > max_size ? size : max_size;
+            bucket_begin[bucket + 1] += bucket_begin[bucket];
+        }
+        option_id members[N] {};
+        std::size_t filled[tables_type::BUCKETS] {};
+        for (std::size_t id = 0; id < N; ++id) {
+            if (!spec_long_name(specs[id]).empty()) {
+                std::size_t bucket = bucket_of[id];
+                members[bucket_begin[bucket] + filled[bucket]++] = id;
+            }
+        }
+
+        /* Repeated names would never be placed: skip them. */
+        for (std::size_t size = tables.unique_names ? max_size : 0;
+             size > 0 && tables.perfect;
+             --size) {
+            for (std::size_t bucket = 0;
+                 bucket < tables_type::BUCKETS && tables.perfect;
+                 ++bucket) {
+                std::size_t begin = bucket_begin[bucket];
+                if (bucket_begin[bucket + 1] - begin != size) {
+                    continue;
+                }
+                std::size_t slots[N] {};
+                bool placed = false;
+                for (std::uint32_t seed = 1;
+                     seed < MAX_DISPLACEMENT && !placed;
+                     ++seed) {
+                    placed = true;
+                    for (std::size_t i = 0; i < size && placed; ++i) {
+                        slots[i] =
+                            mix_hash(hashes[members[begin + i]], seed) %
+                            tables_type::SLOTS;
+                        placed = tables.longs[slots[i]] == NO_OPTION_ID;
+                        for (std::size_t j = 0; j < i && placed; ++j) {
+                            placed = slots[j] != slots[i];
+                        }
+                    }
+                    if (placed) {
+                        tables.displacements[bucket] = seed;
+                    }
+                }
+                for (std::size_t i = 0; i < size && placed; ++i) {
+                    tables.longs[slots[i]] = members[begin + i];
+                }
+                tables.perfect = placed;
+            }
+        }
+        return tables;
+    }
+
+    /*!
+     * Gets the id of the option with the long name passed.
+     * \return The id of the option, NO_OPTION_ID if there is not.
+     */
+    template<std::size_t N>
+    constexpr option_id find_static(const OptionSpec (&specs)[N],
+                                    const StaticTables<N>& tables,
+                                    std::string_view long_name) {
+        typedef StaticTables<N> tables_type;
+        std::uint64_t hash = hash_name(long_name);
+        std::size_t bucket = mix_hash(hash, 0) % tables_type::BUCKETS;
+        std::size_t slot = mix_hash(hash, tables.displacements[bucket]) %
+            tables_type::SLOTS;
+        option_id id = tables.longs[slot];
+        return id != NO_OPTION_ID &&
+            !long_name.empty() &&
+            spec_long_name(specs[id]) == long_name ? id : NO_OPTION_ID;
+    }
+}
+
+#endif
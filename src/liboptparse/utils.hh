@@ -27,7 +27,9 @@
  * project file.
  */
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 
 #include "optargs.hh"
 #include "program_info.hh"
@@ -36,6 +38,14 @@
 #define LIBOPTARG_UTILS_INCLUDE_GUARD_HH 1
 
 namespace _LIBOPTPARSE_ {
+    /*!
+     * Check if the char passed is an ASCII letter. It is the same
+     * as std::isalpha in the "C" locale, but usable at compile time.
+     */
+    constexpr bool is_alpha(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
     /*!
      * Check if the parameter passed is a valid short name.
      *
@@ -45,19 +55,46 @@ namespace _LIBOPTPARSE_ {
      * \return True id the parameter passed is a valid short name,
      *         false otherwise.
      */
-    bool is_valid_short_name(char short_name);
+    constexpr bool is_valid_short_name(char short_name) {
+        return is_alpha(short_name);
+    }
 
     /*!
      * Check if parameter passed is a valid long name.
-     * DEF: A name is a VALID LONG NAME if it is at least 2 character
-     *      length string containing only alphabetic and minus
-     *      character. It must begin with an alphabetic char.
+     * DEF: A name is a VALID LONG NAME if it is empty or it is at
+     *      least 3 characters length string containing only
+     *      alphabetic characters.
      *
      * \param long_name - Name to check.
      * \return True id the parameter passed is a valid long name,
      *         false otherwise.
      */
-    bool is_valid_long_name(const std::string& long_name);
+    constexpr bool is_valid_long_name(std::string_view long_name) {
+        bool ok = long_name.empty() || long_name.size() > 2;
+        for (std::size_t i = 0; i < long_name.size() && ok; ++i) {
+            ok = is_alpha(long_name[i]);
+        }
+        return ok;
+    }
+
+    /*!
+     * Check if parameters passed are valid names for an option.
+     * DEF: Names are VALID NAMES if the short name is a valid short
+     *      name or '\0', the long name is a valid long name and at
+     *      least one of them is given.
+     *
+     * \param short_name - Short name to check, '\0' for none.
+     * \param long_name  - Long name to check, empty for none.
+     * \return True if names are valid, false otherwise.
+     */
+    constexpr bool is_valid_names(char short_name,
+                                  std::string_view long_name) {
+        return
+            (short_name == '\0' ?
+             !long_name.empty() :
+             is_valid_short_name(short_name)) &&
+            is_valid_long_name(long_name);
+    }
 
     /*!
      * Check if parameter passed is a valid option argument. See
@@ -0,0 +1,352 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <system_error>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "liboptparse/list_value.hh"
+
+namespace {
+    /*! Byte 1 repeated in each byte of a word. */
+    const std::uint64_t ONES = 0x0101010101010101ull;
+
+    /*! Powers of ten up to the digits read at a time. */
+    const std::uint64_t POWERS[] = {
+        1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull,
+        10000000ull, 100000000ull };
+
+    /*! Powers of ten exactly represented by a double. */
+    const double EXACT_POWERS[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+        1e22 };
+
+    /*! Max digits of a value held by std::uint64_t. */
+    const unsigned MAX_DIGITS = 19;
+
+    /*! Max integer exactly represented by a double. */
+    const std::uint64_t MAX_EXACT = 1ull << 53;
+
+    /*! Gets the number of times the char passed is in the text. */
+    std::size_t count_char(const char* current,
+                           const char* end,
+                           char c) noexcept {
+        std::size_t count = 0;
+#ifdef __SSE2__
+        const __m128i needle = _mm_set1_epi8(c);
+        for (; end - current >= 16; current += 16) {
+            __m128i chunk = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(current));
+            unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+            for (; mask != 0; mask &= mask - 1) {
+                ++count;
+            }
+        }
+#endif
+        for (; current != end; ++current) {
+            count += *current == c;
+        }
+        return count;
+    }
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    /*!
+     * Read the digits beginning at the position passed, up to 8 of
+     * them, as a single word.
+     * \param value - Set to the value of the digits read.
+     * \return The number of digits read.
+     */
+    unsigned read_digits(const char* current,
+                         const char* end,
+                         std::uint64_t& value) noexcept {
+        std::uint64_t word = 0;
+        if (end - current >= 8) {
+            std::memcpy(&word, current, 8);
+        } else {
+            std::memcpy(&word, current, end - current);
+        }
+        /* Digits become bytes 0 to 9, with the high nibble clear. */
+        word ^= 0x30 * ONES;
+        std::uint64_t wrong = (word & (0xf0 * ONES)) |
+            (((word & (0x0f * ONES)) + 0x06 * ONES) & (0x10 * ONES));
+        wrong = ((wrong >> 4) + 0x7f * ONES) & (0x80 * ONES);
+        unsigned count = wrong == 0 ? 8 : __builtin_ctzll(wrong) / 8;
+        if (count == 0) {
+            value = 0;
+            return 0;
+        }
+        /* Keep the digits, as the last ones of eight with leading 0s. */
+        word <<= 8 * (8 - count);
+        word = word * 10 + (word >> 8);
+        value = (((word & 0x000000ff000000ffull) * 0x000f424000000064ull) +
+                 (((word >> 16) & 0x000000ff000000ffull) *
+                  0x0000271000000001ull)) >> 32;
+        return count;
+    }
+
+    /*!
+     * Read the item of up to 8 chars passed, whose length is known, as
+     * a single word: there is no digit to count.
+     * \return False if a char is not a digit.
+     */
+    inline bool read_short(const char* current,
+                           const char* end,
+                           std::size_t length,
+                           std::uint64_t& value) noexcept {
+        std::uint64_t word = 0;
+        if (end - current >= 8) {
+            std::memcpy(&word, current, 8);
+        } else {
+            std::memcpy(&word, current, end - current);
+        }
+        word = (word ^ 0x30 * ONES) << 8 * (8 - length);
+        std::uint64_t wrong = (word & (0xf0 * ONES)) |
+            (((word & (0x0f * ONES)) + 0x06 * ONES) & (0x10 * ONES));
+        if (wrong != 0) {
+            return false;
+        }
+        word = word * 10 + (word >> 8);
+        value = (((word & 0x000000ff000000ffull) * 0x000f424000000064ull) +
+                 (((word >> 16) & 0x000000ff000000ffull) *
+                  0x0000271000000001ull)) >> 32;
+        return true;
+    }
+#else
+    unsigned read_digits(const char* current,
+                         const char* end,
+                         std::uint64_t& value) noexcept {
+        unsigned count = 0;
+        value = 0;
+        while (count < 8 && current != end &&
+               *current >= '0' && *current <= '9') {
+            value = value * 10 + (*current++ - '0');
+            ++count;
+        }
+        return count;
+    }
+
+    inline bool read_short(const char* current,
+                           const char*,
+                           std::size_t length,
+                           std::uint64_t& value) noexcept {
+        value = 0;
+        for (const char* end = current + length; current != end; ++current) {
+            if (*current < '0' || *current > '9') {
+                return false;
+            }
+            value = value * 10 + (*current - '0');
+        }
+        return true;
+    }
+#endif
+
+    /*!
+     * Read a run of digits into the value passed, 8 at a time.
+     * \param end - End of the text, the limit of the bytes read.
+     * \return The number of digits read, more than MAX_DIGITS if
+     *         they do not fit the value.
+     */
+    inline unsigned read_number(const char*& current,
+                                const char* end,
+                                std::uint64_t& value) noexcept {
+        unsigned digits = 0;
+        std::uint64_t chunk = 0;
+        unsigned count;
+        do {
+            count = read_digits(current, end, chunk);
+            if (digits + count > MAX_DIGITS) {
+                return MAX_DIGITS + 1;
+            }
+            value = value * POWERS[count] + chunk;
+            digits += count;
+            current += count;
+        } while (count == 8);
+        return digits;
+    }
+
+    /*! Convert the whole item with std::from_chars. */
+    template<class T>
+    bool from_chars(const char* begin, const char* item_end, T& value) {
+        auto result = std::from_chars(begin, item_end, value);
+        return result.ec == std::errc() && result.ptr == item_end;
+    }
+
+    /*!
+     * Convert the integer item passed.
+     * \param end - End of the text, the limit of the bytes read.
+     */
+    inline bool convert_item(const char* current,
+                             const char* item_end,
+                             const char* end,
+                             std::int64_t& destination) {
+        const char* begin = current;
+        bool negative = current != item_end && *current == '-';
+        current += negative;
+        std::uint64_t value = 0;
+        std::size_t length = item_end - current;
+        if (length != 0 && length <= 8) {
+            if (!read_short(current, end, length, value)) {
+                return false;
+            }
+            destination = negative ?
+                -static_cast<std::int64_t>(value) :
+                static_cast<std::int64_t>(value);
+            return true;
+        }
+        unsigned digits = read_number(current, end, value);
+        if (digits == 0 || digits > MAX_DIGITS || current != item_end) {
+            return from_chars(begin, item_end, destination);
+        }
+        const std::uint64_t max =
+            static_cast<std::uint64_t>(
+                std::numeric_limits<std::int64_t>::max()) + negative;
+        if (value > max) {
+            return false;
+        }
+        destination = negative ?
+            static_cast<std::int64_t>(0 - value) :
+            static_cast<std::int64_t>(value);
+        return true;
+    }
+
+    /*!
+     * Convert the double item passed. Numbers with up to 19 digits,
+     * at most 22 of them decimals, and no exponent are converted
+     * exactly by a single division; the others by std::from_chars.
+     * \param end - End of the text, the limit of the bytes read.
+     */
+    inline bool convert_item(const char* current,
+                             const char* item_end,
+                             const char* end,
+                             double& destination) {
+        const char* begin = current;
+        bool negative = current != item_end && *current == '-';
+        current += negative;
+        std::uint64_t value = 0;
+        unsigned digits = read_number(current, end, value);
+        unsigned decimals = 0;
+        if (digits != 0 && current != item_end && *current == '.') {
+            ++current;
+            std::size_t length = item_end - current;
+            std::uint64_t fraction;
+            if (length != 0 && length <= 8 &&
+                read_short(current, end, length, fraction)) {
+                value = value * POWERS[length] + fraction;
+                decimals = length;
+                current = item_end;
+            } else {
+                decimals = read_number(current, end, value);
+            }
+            digits = decimals == 0 ? 0 : digits + decimals;
+        }
+        if (digits == 0 || digits > MAX_DIGITS || value > MAX_EXACT ||
+            decimals >= sizeof(EXACT_POWERS) / sizeof(double) ||
+            current != item_end) {
+            return from_chars(begin, item_end, destination);
+        }
+        double number = static_cast<double>(value) / EXACT_POWERS[decimals];
+        destination = negative ? -number : number;
+        return true;
+    }
+
+    /*!
+     * Call the function passed with the begin and the end of each item
+     * of the text, stopping when it returns false. Delimiters are
+     * found 16 at a time, so items do not wait for the ones before to
+     * be read to know where they begin.
+     * \return False if the function stopped.
+     */
+    template<class Function>
+    bool for_each_item(const char* begin,
+                       const char* end,
+                       char delimiter,
+                       Function function) {
+        const char* item = begin;
+        const char* block = begin;
+#ifdef __SSE2__
+        const __m128i needle = _mm_set1_epi8(delimiter);
+        for (; end - block >= 16; block += 16) {
+            unsigned mask = _mm_movemask_epi8(
+                _mm_cmpeq_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(block)),
+                    needle));
+            while (mask != 0) {
+                const char* found = block + __builtin_ctz(mask);
+                if (!function(item, found)) {
+                    return false;
+                }
+                item = found + 1;
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for (; block != end; ++block) {
+            if (*block == delimiter) {
+                if (!function(item, block)) {
+                    return false;
+                }
+                item = block + 1;
+            }
+        }
+        return function(item, end);
+    }
+
+    template<class T>
+    bool convert_items(std::string_view text,
+                       char delimiter,
+                       std::size_t size,
+                       std::vector<T>& destination) {
+        if (text.empty()) {
+            return true;
+        }
+        /* Reserved, not resized: values are not zero-filled first. */
+        destination.reserve(destination.size() + size);
+        const char* end = text.data() + text.size();
+        return for_each_item(
+            text.data(), end, delimiter,
+            [&](const char* item, const char* item_end) {
+                T value;
+                if (!convert_item(item, item_end, end, value)) {
+                    return false;
+                }
+                destination.push_back(value);
+                return true;
+            });
+    }
+}
+
+std::size_t ListValue::size() const noexcept {
+    if (_text.empty()) {
+        return 0;
+    }
+    return count_char(_text.data(), _text.data() + _text.size(),
+                      _delimiter) + 1;
+}
+
+bool ListValue::convert(std::vector<std::int64_t>& destination) const {
+    return convert_items(_text, _delimiter, size(), destination);
+}
+
+bool ListValue::convert(std::vector<double>& destination) const {
+    return convert_items(_text, _delimiter, size(), destination);
+}
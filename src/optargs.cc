@@ -16,13 +16,176 @@
  */
 
 #include <string>
-#include <sstream>
+#include <ostream>
+#include <algorithm>
 #include <cassert>
-#include <locale>
+#include <charconv>
+#include <climits>
+#include <limits>
+#include <type_traits>
 
 #include "liboptparse/utils.hh"
 #include "liboptparse/optargs.hh"
 
+namespace {
+    /*! Checks if the char passed is a space of the "C" locale. */
+    bool is_space(char c) noexcept {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    /*!
+     * Skip the leading spaces of the text passed and its sign, like
+     * the input operators do.
+     * \param negative - Set to true if the sign is '-'.
+     * \return The text after them.
+     */
+    std::string_view skip_sign(std::string_view text,
+                               bool& negative) noexcept {
+        std::size_t i = 0;
+        while (i < text.size() && is_space(text[i])) {
+            ++i;
+        }
+        negative = i < text.size() && text[i] == '-';
+        if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+            ++i;
+        }
+        return text.substr(i);
+    }
+
+    /*!
+     * Read an integer like operator>> does: int and short are read
+     * as long and clamped to their range, unsigned types take
+     * negative values modulo their range; values out of range are
+     * the nearest limit.
+     */
+    template<class T>
+    T integer_value(std::string_view text) noexcept {
+        bool negative;
+        text = skip_sign(text, negative);
+        unsigned long long magnitude = 0;
+        std::from_chars_result read = std::from_chars(
+            text.data(), text.data() + text.size(), magnitude);
+        if (read.ptr == text.data()) {
+            return 0;
+        }
+        bool overflow = read.ec == std::errc::result_out_of_range;
+        if constexpr (std::is_signed<T>::value) {
+            const unsigned long long limit =
+                static_cast<unsigned long long>(LONG_MAX) + negative;
+            long value = 0;
+            if (overflow || magnitude > limit) {
+                value = negative ? LONG_MIN : LONG_MAX;
+            } else if (negative) {
+                value = -static_cast<long>(magnitude - 1) - 1;
+            } else {
+                value = static_cast<long>(magnitude);
+            }
+            if (value < std::numeric_limits<T>::min()) {
+                return std::numeric_limits<T>::min();
+            }
+            if (value > std::numeric_limits<T>::max()) {
+                return std::numeric_limits<T>::max();
+            }
+            return static_cast<T>(value);
+        } else {
+            if (overflow || magnitude > std::numeric_limits<T>::max()) {
+                return std::numeric_limits<T>::max();
+            }
+            T value = static_cast<T>(magnitude);
+            return negative ? static_cast<T>(-value) : value;
+        }
+    }
+
+    /*!
+     * Read a floating point number like operator>> does: it takes
+     * digits, a point and an exponent, and a text ending in an
+     * exponent without digits is not valid. Values too large are the
+     * largest finite value, values too small are 0.
+     */
+    template<class T>
+    T floating_value(std::string_view text) noexcept {
+        bool negative;
+        text = skip_sign(text, negative);
+        const char* begin = text.data();
+        const char* end = begin + text.size();
+        const char* current = begin;
+        bool digits = false;
+        bool point = false;
+        bool nonzero = false;
+        /* Integer digits from the first not zero. */
+        long integer = 0;
+        /* Zeros after the point before the first digit not zero. */
+        long zeros = 0;
+        for (; current != end; ++current) {
+            if (*current == '.' && !point) {
+                point = true;
+                continue;
+            }
+            if (*current < '0' || *current > '9') {
+                break;
+            }
+            digits = true;
+            nonzero = nonzero || *current != '0';
+            if (!point) {
+                integer += nonzero;
+            } else if (!nonzero) {
+                ++zeros;
+            }
+        }
+        if (!digits) {
+            return 0;
+        }
+        /* Decimal exponent of the first digit not zero. */
+        long magnitude = integer > 0 ? integer - 1 : -zeros - 1;
+        if (current != end && (*current == 'e' || *current == 'E')) {
+            ++current;
+            bool negative_exponent = false;
+            if (current != end && (*current == '-' || *current == '+')) {
+                negative_exponent = *current == '-';
+                ++current;
+            }
+            long exponent = 0;
+            const char* exponent_begin = current;
+            for (; current != end && *current >= '0' && *current <= '9';
+                 ++current) {
+                exponent = std::min(exponent * 10 + (*current - '0'),
+                                    100000L);
+            }
+            if (current == exponent_begin) {
+                return 0;
+            }
+            magnitude += negative_exponent ? -exponent : exponent;
+        }
+        T value = 0;
+        std::from_chars_result read =
+            std::from_chars(begin, current, value);
+        if (read.ec == std::errc::result_out_of_range) {
+            value = magnitude >= 0 ? std::numeric_limits<T>::max() : 0;
+        } else if (read.ptr != current) {
+            return 0;
+        }
+        return negative ? -value : value;
+    }
+}
+
+template<class T>
+T _LIBOPTPARSE_::stream_value(std::string_view text) noexcept {
+    if constexpr (std::is_floating_point<T>::value) {
+        return floating_value<T>(text);
+    } else {
+        return integer_value<T>(text);
+    }
+}
+
+template<>
+bool _LIBOPTPARSE_::stream_value<bool>(std::string_view text) noexcept {
+    std::size_t i = 0;
+    while (i < text.size() && is_space(text[i])) {
+        ++i;
+    }
+    return text.substr(i, 4) == "true";
+}
+
 OptionArgumentValue::OptionArgumentValue()
     :_value("") { }
 
@@ -45,70 +208,32 @@ const std::string& OptionArgumentValue::get_value() const noexcept {
     return _value;
 }
 
-OptionArgumentValue::operator bool() const {
-    bool t = false;
-    if (!_value.empty()) {
-        std::stringstream ss(_value);
-        ss >> std::boolalpha >> t;
-    }
-    return t;
-}
-
-OptionArgumentValue::operator int() const {
-    int v;
-    std::stringstream ss(_value);
-    ss >> v;
-    return v;
-}
-
-OptionArgumentValue::operator short() const {
-    short v;
-    std::stringstream ss(_value);
-    ss >> v;
-    return v;
-}
-
-OptionArgumentValue::operator long() const {
-    long v;
-    std::stringstream ss(_value);
-    ss >> v;
-    return v;
+ListValue OptionArgumentValue::get_list(char delimiter) const noexcept {
+    return ListValue(_value, delimiter);
 }
 
-OptionArgumentValue::operator unsigned short() const {
-    unsigned short v;
-    std::stringstream ss(_value);
-    ss >> v;
-    return v;
-}
-
-OptionArgumentValue::operator unsigned long() const {
-    unsigned long v;
-    std::stringstream ss(_value);
-    ss >> v;
-    return v;
+OptionArgumentValue::operator bool() const {
+    return _LIBOPTPARSE_::stream_value<bool>(_value);
 }
 
-OptionArgumentValue::operator unsigned int() const {
-    unsigned int v;
-    std::stringstream ss(_value);
-    ss >> v;
-    return v;
-}
+#define LIBOPTPARSE_VALUE_CONVERSION(type)                      \
+    template type _LIBOPTPARSE_::stream_value<type>(            \
+        std::string_view text) noexcept;                        \
+                                                                \
+    OptionArgumentValue::operator type() const {                \
+        return _LIBOPTPARSE_::stream_value<type>(_value);       \
+    }
 
-OptionArgumentValue::operator float() const {
-    float v;
-    std::stringstream ss(_value);
-    ss >> v;
-    return v;
-}
+LIBOPTPARSE_VALUE_CONVERSION(int)
+LIBOPTPARSE_VALUE_CONVERSION(short)
+LIBOPTPARSE_VALUE_CONVERSION(long)
+LIBOPTPARSE_VALUE_CONVERSION(unsigned short)
+LIBOPTPARSE_VALUE_CONVERSION(unsigned long)
+LIBOPTPARSE_VALUE_CONVERSION(unsigned int)
+LIBOPTPARSE_VALUE_CONVERSION(float)
+LIBOPTPARSE_VALUE_CONVERSION(double)
 
-OptionArgumentValue::operator double() const {
-    double v;
-    std::stringstream ss(_value);
-    ss >> v;
-    return v;
-}
+#undef LIBOPTPARSE_VALUE_CONVERSION
 
 OptionArgumentValue::operator std::string() const {
     return get_value();
@@ -151,7 +276,10 @@ public:
           _help(impl._help),
           _default_value(impl._default_value),
           _metavar(impl._metavar),
-          _type(impl._type){
+          _env_name(impl._env_name),
+          _type(impl._type),
+          _id(impl._id),
+          _binder(impl._binder) {
         assert(impl.OK());    
         assert(OK());
     }
@@ -191,6 +319,14 @@ public:
         _metavar = metavar;
     }
     
+    const std::string& get_env_name() const noexcept {
+        return _env_name;
+    }
+
+    void set_env_name(const std::string& env_name) {
+        _env_name = env_name;
+    }
+
     OptionArgumentType get_type() const noexcept {
         return _type;
     }
@@ -199,10 +335,26 @@ public:
         _type = type;
     }
 
+    option_id get_id() const noexcept {
+        return _id;
+    }
+
+    void set_id(option_id id) noexcept {
+        _id = id;
+    }
+
+    const _LIBOPTPARSE_::ValueBinder* get_binder() const noexcept {
+        return _binder.get();
+    }
+
+    void set_binder(
+        std::shared_ptr<const _LIBOPTPARSE_::ValueBinder> binder) noexcept {
+        _binder = std::move(binder);
+    }
+
 private:
     bool OK() const {
-        return _LIBOPTPARSE_::is_valid_short_name(_short_name) &&
-            _LIBOPTPARSE_::is_valid_long_name(_long_name);
+        return _LIBOPTPARSE_::is_valid_names(_short_name, _long_name);
     }
 
     char               _short_name;
@@ -210,7 +362,11 @@ private:
     std::string        _help;
     std::string        _default_value;
     std::string        _metavar;
+    std::string        _env_name;
     OptionArgumentType _type = OptionArgumentType::value;
+    option_id          _id = NO_OPTION_ID;
+    /*! Immutable, so it is shared by copies. */
+    std::shared_ptr<const _LIBOPTPARSE_::ValueBinder> _binder;
 };
 
 
@@ -223,6 +379,9 @@ OptionArgument::OptionArgument(
     const std::string& long_name)
     : _pimpl(new Impl(short_name, long_name)) { }
 
+OptionArgument::OptionArgument(const std::string& long_name)
+    : _pimpl(new Impl('\0', long_name)) { }
+
 OptionArgument::OptionArgument(const OptionArgument& option_argument)
     : _pimpl(new Impl(*option_argument._pimpl)) { }
 
@@ -235,6 +394,10 @@ char OptionArgument::get_short_name() const noexcept {
     return _pimpl -> get_short_name();
 }
 
+bool OptionArgument::has_short_name() const noexcept {
+    return _pimpl -> get_short_name() != '\0';
+}
+
 const std::string& OptionArgument::get_long_name() const noexcept {
     return _pimpl -> get_long_name();
 }
@@ -270,6 +433,15 @@ OptionArgument& OptionArgument::set_metavar(
     return *this;
 }
 
+const std::string& OptionArgument::get_env_name() const noexcept {
+    return _pimpl -> get_env_name();
+}
+
+OptionArgument& OptionArgument::set_env_name(const std::string& env_name) {
+    _pimpl -> set_env_name(env_name);
+    return *this;
+}
+
 OptionArgumentType OptionArgument::get_type() const noexcept {
     return _pimpl -> get_type();
 }
@@ -280,9 +452,30 @@ OptionArgument& OptionArgument::set_type(
     return *this;
 }
 
+option_id OptionArgument::get_id() const noexcept {
+    return _pimpl -> get_id();
+}
+
+void OptionArgument::set_id(option_id id) noexcept {
+    _pimpl -> set_id(id);
+}
+
+const _LIBOPTPARSE_::ValueBinder*
+OptionArgument::get_binder() const noexcept {
+    return _pimpl -> get_binder();
+}
+
+OptionArgument& OptionArgument::set_binder(
+    std::shared_ptr<const _LIBOPTPARSE_::ValueBinder> binder) noexcept {
+    _pimpl -> set_binder(std::move(binder));
+    return *this;
+}
+
 bool operator==(const OptionArgument& first,
                 const OptionArgument& second) {
-    return first.get_short_name() == second.get_short_name();
+    return first.get_short_name() == second.get_short_name() &&
+        (first.has_short_name() ||
+         first.get_long_name() == second.get_long_name());
 }
 
 bool operator!=(const OptionArgument& first,
@@ -0,0 +1,118 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include "liboptparse/option_index.hh"
+
+_LIBOPTPARSE_::HashOptionIndex::HashOptionIndex()
+    : OptionIndex(_table) {
+    std::fill(std::begin(_table), std::end(_table), NO_OPTION_ID);
+}
+
+option_id _LIBOPTPARSE_::OptionIndex::find_upper_case(
+    std::string_view name) const noexcept {
+    if (name.empty() || !is_upper_case(name)) {
+        return NO_OPTION_ID;
+    }
+    option_id found = NO_OPTION_ID;
+    for (option_id id = 0; id < size(); ++id) {
+        if (equal_upper_case(name, get_long_name(id))) {
+            if (found != NO_OPTION_ID) {
+                return NO_OPTION_ID;
+            }
+            found = id;
+        }
+    }
+    return found;
+}
+
+_LIBOPTPARSE_::HashOptionIndex::HashOptionIndex(
+    const HashOptionIndex& index)
+    : OptionIndex(_table),
+      _longs(),
+      _uppers(),
+      _short_names(index._short_names),
+      _long_names(index._long_names) {
+    std::copy(std::begin(index._table),
+              std::end(index._table),
+              std::begin(_table));
+    for (option_id id = 0; id < _long_names.size(); ++id) {
+        if (!_long_names[id].empty()) {
+            add_long_name(id);
+        }
+    }
+}
+
+_LIBOPTPARSE_::HashOptionIndex::~HashOptionIndex() { }
+
+option_id _LIBOPTPARSE_::HashOptionIndex::add(
+    char short_name,
+    const std::string& long_name) {
+    assert(short_name != '\0' || !long_name.empty());
+    assert(short_name == '\0' || find(short_name) == NO_OPTION_ID);
+    assert(long_name.empty() || find(long_name) == NO_OPTION_ID);
+    option_id id = _short_names.size();
+    _short_names.push_back(short_name);
+    _long_names.push_back(long_name);
+    if (short_name != '\0') {
+        _table[static_cast<unsigned char>(short_name)] = id;
+    }
+    if (!long_name.empty()) {
+        add_long_name(id);
+    }
+    return id;
+}
+
+void _LIBOPTPARSE_::HashOptionIndex::add_long_name(option_id id) {
+    std::string_view long_name = _long_names[id];
+    _longs[long_name] = id;
+    auto inserted = _uppers.emplace(long_name, id);
+    if (!inserted.second) {
+        inserted.first -> second = NO_OPTION_ID;
+    }
+}
+
+option_id _LIBOPTPARSE_::HashOptionIndex::find(
+    std::string_view long_name) const noexcept {
+    auto itr = _longs.find(long_name);
+    return itr != _longs.end() ? itr -> second : NO_OPTION_ID;
+}
+
+char _LIBOPTPARSE_::HashOptionIndex::get_short_name(
+    option_id id) const noexcept {
+    return _short_names[id];
+}
+
+std::string_view _LIBOPTPARSE_::HashOptionIndex::get_long_name(
+    option_id id) const noexcept {
+    return _long_names[id];
+}
+
+std::size_t _LIBOPTPARSE_::HashOptionIndex::size() const noexcept {
+    return _short_names.size();
+}
+
+option_id _LIBOPTPARSE_::HashOptionIndex::find_upper_case(
+    std::string_view name) const noexcept {
+    if (!is_upper_case(name)) {
+        return NO_OPTION_ID;
+    }
+    auto itr = _uppers.find(name);
+    return itr != _uppers.end() ? itr -> second : NO_OPTION_ID;
+}
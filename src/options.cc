@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cassert>
+#include <climits>
 
 #include "liboptparse/options.hh"
 #include "liboptparse/program_info.hh"
@@ -7,14 +8,17 @@
 
 bool Options::Impl::OK() const noexcept {
     bool is_valid = _args != NULL &&
-        _opts != NULL &&
+        _index != NULL &&
+        _values != NULL &&
         _program_info != NULL &&
         _LIBOPTPARSE_::is_valid_program_info(*_program_info);
     if (is_valid) {
-        is_valid = std::all_of(
-            _opts -> begin(),
-            _opts -> end(),
-            [&](auto opt) { return opt.second != NULL;  });
+        is_valid = _values -> size() == _index -> size() &&
+            _given.size() == _values -> size() &&
+            std::all_of(
+                _values -> begin(),
+                _values -> end(),
+                [&](auto value) { return value != NULL;  });
         is_valid = is_valid &&
             std::all_of(
                 _args -> begin(),
@@ -25,22 +29,81 @@ bool Options::Impl::OK() const noexcept {
 }
 
 bool Options::Impl::contains_option(char key) const noexcept {
-    return _opts -> find(key) !=  _opts -> end();
+    return _index -> find(key) != NO_OPTION_ID;
+}
+
+bool Options::Impl::contains_option(
+    const std::string& key) const noexcept {
+    return _index -> find(key) != NO_OPTION_ID;
 }
 
 Options::value_type Options::Impl::at(char key) const noexcept {
-    return _opts -> at(key);
+    return (*_values)[_index -> find(key)];
+}
+
+Options::value_type Options::Impl::at(
+    const std::string& key) const noexcept {
+    return (*_values)[_index -> find(key)];
+}
+
+Options::value_type Options::Impl::at_id(option_id id) const noexcept {
+    return (*_values)[id];
+}
+
+bool Options::Impl::is_set(option_id id) const noexcept {
+    return _given[id];
 }
 
+ValueSpan Options::Impl::get_values(option_id id) const noexcept {
+    return _repeated.get(id);
+}
+
+option_id Options::Impl::find_id(char key) const noexcept {
+    return _index -> find(key);
+}
+
+option_id Options::Impl::find_id(std::string_view key) const noexcept {
+    return _index -> find(key);
+}
+
+char Options::Impl::get_short_name(option_id id) const noexcept {
+    return _index -> get_short_name(id);
+}
+
+std::string_view Options::Impl::get_long_name(
+    option_id id) const noexcept {
+    return _index -> get_long_name(id);
+}
+
+std::size_t Options::Impl::size() const noexcept {
+    return _values -> size();
+}
+
+const OptionsFingerprint&
+Options::Impl::get_fingerprint() const noexcept {
+    return _fingerprint;
+}
 
 Options::options_const_iterator
 Options::Impl::options_cbegin() const noexcept {
-    return _opts -> cbegin();
+    return options_const_iterator(_index.get(), _values.get(), 0);
 }
 
 Options::options_const_iterator
 Options::Impl::options_cend() const noexcept {
-    return _opts -> cend();
+    return options_const_iterator(_index.get(),
+                                  _values.get(),
+                                  UCHAR_MAX + 1);
+}
+
+Options::values_const_iterator
+Options::Impl::values_cbegin() const noexcept {
+    return _values -> cbegin();
+}
+
+Options::values_const_iterator
+Options::Impl::values_cend() const noexcept {
+    return _values -> cend();
 }
 
 Options::arguments_const_iterator
@@ -70,6 +133,71 @@ Options::value_type Options::operator[](char key) const noexcept {
     return at(key);
 }
 
+Options::value_type Options::at(
+    const std::string& long_name) const noexcept {
+    assert(_pimpl -> OK() && _pimpl -> contains_option(long_name));
+    auto elem = _pimpl -> at(long_name);
+    assert(_pimpl -> OK() && elem != NULL);
+    return elem;
+}
+
+Options::value_type Options::at_id(option_id id) const noexcept {
+    assert(_pimpl -> OK() && id < _pimpl -> size());
+    auto elem = _pimpl -> at_id(id);
+    assert(_pimpl -> OK() && elem != NULL);
+    return elem;
+}
+
+bool Options::is_set(option_id id) const noexcept {
+    assert(_pimpl -> OK() && id < _pimpl -> size());
+    return _pimpl -> is_set(id);
+}
+
+ValueSpan Options::get_values(option_id id) const noexcept {
+    assert(_pimpl -> OK() && id < _pimpl -> size());
+    return _pimpl -> get_values(id);
+}
+
+ValueSpan Options::get_values(char key) const noexcept {
+    assert(_pimpl -> OK() && _pimpl -> contains_option(key));
+    return _pimpl -> get_values(_pimpl -> find_id(key));
+}
+
+ValueSpan Options::get_values(const std::string& long_name) const noexcept {
+    assert(_pimpl -> OK() && _pimpl -> contains_option(long_name));
+    return _pimpl -> get_values(_pimpl -> find_id(long_name));
+}
+
+option_id Options::find_id(char key) const noexcept {
+    assert(_pimpl -> OK());
+    return _pimpl -> find_id(key);
+}
+
+option_id Options::find_id(std::string_view long_name) const noexcept {
+    assert(_pimpl -> OK());
+    return _pimpl -> find_id(long_name);
+}
+
+char Options::get_short_name(option_id id) const noexcept {
+    assert(_pimpl -> OK() && id < _pimpl -> size());
+    return _pimpl -> get_short_name(id);
+}
+
+std::string_view Options::get_long_name(option_id id) const noexcept {
+    assert(_pimpl -> OK() && id < _pimpl -> size());
+    return _pimpl -> get_long_name(id);
+}
+
+std::size_t Options::size() const noexcept {
+    assert(_pimpl -> OK());
+    return _pimpl -> size();
+}
+
+const OptionsFingerprint& Options::get_fingerprint() const noexcept {
+    assert(_pimpl -> OK());
+    return _pimpl -> get_fingerprint();
+}
+
 Options::options_const_iterator
 Options::options_cbegin() const noexcept {
     assert(_pimpl -> OK());
@@ -86,6 +214,22 @@ Options::options_cend() const noexcept {
     return itr;
 }
 
+Options::values_const_iterator
+Options::values_cbegin() const noexcept {
+    assert(_pimpl -> OK());
+    auto itr = _pimpl -> values_cbegin();
+    assert(_pimpl -> OK());
+    return itr;
+}
+
+Options::values_const_iterator
+Options::values_cend() const noexcept {
+    assert(_pimpl -> OK());
+    auto itr = _pimpl -> values_cend();
+    assert(_pimpl -> OK());
+    return itr;
+}
+
 Options::arguments_const_iterator
 Options::arguments_cbegin() const noexcept {
     assert(_pimpl -> OK());
@@ -106,3 +250,61 @@ const std::string& Options::get_program_name() const noexcept {
     assert(_pimpl -> OK());
     return _pimpl -> get_program_name();
 }
+
+Options::options_const_iterator::options_const_iterator()
+    : _index(NULL), _values(NULL), _short_name(UCHAR_MAX + 1) { }
+
+Options::options_const_iterator::options_const_iterator(
+    const _LIBOPTPARSE_::OptionIndex* index,
+    const Options::values_container* values,
+    int short_name)
+    : _index(index), _values(values), _short_name(short_name) {
+    load();
+}
+
+void Options::options_const_iterator::load() noexcept {
+    while (_short_name <= UCHAR_MAX &&
+           _index -> find(static_cast<char>(_short_name)) ==
+           NO_OPTION_ID) {
+        ++_short_name;
+    }
+    if (_short_name <= UCHAR_MAX) {
+        char short_name = static_cast<char>(_short_name);
+        _current = value_type(short_name,
+                              (*_values)[_index -> find(short_name)]);
+    }
+}
+
+Options::options_const_iterator::reference
+Options::options_const_iterator::operator*() const noexcept {
+    return _current;
+}
+
+Options::options_const_iterator::pointer
+Options::options_const_iterator::operator->() const noexcept {
+    return &_current;
+}
+
+Options::options_const_iterator&
+Options::options_const_iterator::operator++() noexcept {
+    ++_short_name;
+    load();
+    return *this;
+}
+
+Options::options_const_iterator
+Options::options_const_iterator::operator++(int) noexcept {
+    options_const_iterator copy(*this);
+    ++*this;
+    return copy;
+}
+
+bool Options::options_const_iterator::operator==(
+    const options_const_iterator& other) const noexcept {
+    return _short_name == other._short_name;
+}
+
+bool Options::options_const_iterator::operator!=(
+    const options_const_iterator& other) const noexcept {
+    return !(*this == other);
+}
@@ -0,0 +1,142 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+#include "liboptparse/config_file.hh"
+#include "liboptparse/options_holder.hh"
+#include "liboptparse/parser.hh"
+
+OptionsHolder::Snapshot::Snapshot(Snapshot&& other) noexcept
+    : _slot(other._slot), _options(other._options) {
+    other._slot = NULL;
+}
+
+OptionsHolder::Snapshot::~Snapshot() {
+    if (_slot != NULL) {
+        _slot -> epoch.store(0, std::memory_order_release);
+    }
+}
+
+OptionsHolder::Reader::Reader(Reader&& other) noexcept
+    : _holder(other._holder), _slot(other._slot) {
+    other._slot = NULL;
+}
+
+OptionsHolder::Reader::~Reader() {
+    if (_slot != NULL) {
+        _slot -> used.store(false, std::memory_order_release);
+    }
+}
+
+OptionsHolder::Snapshot OptionsHolder::Reader::read() const noexcept {
+    assert(_slot -> epoch.load(std::memory_order_relaxed) == 0);
+    /*
+     * The epoch is announced before loading the pointer: a writer
+     * that swapped it after the load sees the announcement.
+     */
+    _slot -> epoch.store(_holder -> _epoch.load());
+    return Snapshot(_slot, _holder -> _current.load());
+}
+
+OptionsHolder::OptionsHolder(std::unique_ptr<const Options> options,
+                             std::size_t max_readers)
+    : _current(options.release()),
+      _epoch(1),
+      _slots(new Slot[max_readers]),
+      _max_readers(max_readers),
+      _mutex(),
+      _retired() {
+    assert(_current.load() != NULL && max_readers > 0);
+    for (std::size_t i = 0; i < _max_readers; ++i) {
+        _slots[i].epoch.store(0, std::memory_order_relaxed);
+        _slots[i].used.store(false, std::memory_order_relaxed);
+    }
+}
+
+OptionsHolder::~OptionsHolder() {
+    for (auto& retired : _retired) {
+        delete retired.second;
+    }
+    delete _current.load();
+}
+
+OptionsHolder::Reader OptionsHolder::make_reader() const {
+    for (std::size_t i = 0; i < _max_readers; ++i) {
+        bool used = false;
+        if (_slots[i].used.compare_exchange_strong(used, true)) {
+            return Reader(this, &_slots[i]);
+        }
+    }
+    throw std::length_error("too many readers");
+}
+
+void OptionsHolder::publish(std::unique_ptr<const Options> options) {
+    assert(options != NULL);
+    std::lock_guard<std::mutex> lock(_mutex);
+    const Options* old = _current.exchange(options.release());
+    std::uint64_t epoch = _epoch.load(std::memory_order_relaxed);
+    _retired.emplace_back(epoch, old);
+    _epoch.store(epoch + 1);
+    reclaim_locked();
+}
+
+ParseError OptionsHolder::reload(OptionParser& parser,
+                                 int argc,
+                                 const char *argv[],
+                                 const std::string& config_path) {
+    ConfigFile config;
+    ParseError error = config.load(config_path);
+    if (error.type != parse_ok) {
+        return error;
+    }
+    ParseResult result = parser.try_parse(argc, argv, config);
+    if (!result.is_ok()) {
+        return result.get_error();
+    }
+    publish(result.get_options());
+    return error;
+}
+
+std::size_t OptionsHolder::reclaim() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return reclaim_locked();
+}
+
+std::size_t OptionsHolder::reclaim_locked() noexcept {
+    std::uint64_t oldest = UINT64_MAX;
+    for (std::size_t i = 0; i < _max_readers; ++i) {
+        std::uint64_t epoch = _slots[i].epoch.load();
+        if (epoch != 0) {
+            oldest = std::min(oldest, epoch);
+        }
+    }
+    /* A reader in epoch e may see the snapshots retired in e or later. */
+    auto kept = std::remove_if(
+        _retired.begin(), _retired.end(),
+        [oldest](const std::pair<std::uint64_t, const Options*>& retired) {
+            if (retired.first < oldest) {
+                delete retired.second;
+                return true;
+            }
+            return false;
+        });
+    _retired.erase(kept, _retired.end());
+    return _retired.size();
+}
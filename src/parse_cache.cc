@@ -0,0 +1,252 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "liboptparse/hasher.hh"
+#include "liboptparse/parse_cache.hh"
+
+namespace {
+    /*! Estimate of the bytes held by a value, with its control block. */
+    std::size_t value_bytes(const Options::value_type& value) {
+        if (value == NULL) {
+            return 0;
+        }
+        return sizeof(OptionArgumentValue) + 2 * sizeof(void*) +
+            value -> get_value().capacity();
+    }
+
+    /*! Estimate of the bytes held by the options passed. */
+    std::size_t options_bytes(const Options& options) {
+        std::size_t bytes = sizeof(Options) +
+            options.size() * (sizeof(Options::value_type) + 1);
+        for (auto itr = options.values_cbegin();
+             itr != options.values_cend();
+             ++itr) {
+            bytes += value_bytes(*itr);
+        }
+        for (auto itr = options.arguments_cbegin();
+             itr != options.arguments_cend();
+             ++itr) {
+            bytes += 2 * sizeof(void*) + value_bytes(*itr);
+        }
+        return bytes;
+    }
+}
+
+class ParseCache::Impl {
+public:
+    Impl(std::size_t capacity, std::size_t shards)
+        : _shards(), _mask(0), _shard_capacity(0), _bypasses(0) {
+        std::size_t count = 1;
+        while (count < shards && count < capacity) {
+            count *= 2;
+        }
+        _shards = std::vector<Shard>(count);
+        _mask = count - 1;
+        _shard_capacity = (capacity + count - 1) / count;
+    }
+
+    std::shared_ptr<const Options> lookup(std::uint64_t hash,
+                                          int argc,
+                                          const char *argv[]) {
+        Shard& shard = shard_of(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto itr = shard.index.find(hash);
+        if (itr == shard.index.end() ||
+            !same_arguments(itr -> second -> arguments, argc, argv)) {
+            ++shard.misses;
+            return std::shared_ptr<const Options>();
+        }
+        ++shard.hits;
+        shard.entries.splice(shard.entries.begin(),
+                             shard.entries,
+                             itr -> second);
+        return itr -> second -> options;
+    }
+
+    std::shared_ptr<const Options> store(
+        std::uint64_t hash,
+        int argc,
+        const char *argv[],
+        std::shared_ptr<const Options> options) {
+        std::string arguments;
+        for (int i = 0; i < argc; ++i) {
+            arguments.append(argv[i]);
+            arguments.push_back('\0');
+        }
+        std::size_t bytes = ENTRY_BYTES + arguments.capacity() +
+            options_bytes(*options);
+        Shard& shard = shard_of(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto itr = shard.index.find(hash);
+        if (itr != shard.index.end()) {
+            if (itr -> second -> arguments == arguments) {
+                return itr -> second -> options;
+            }
+            /* Hash collision: the newest command line wins. */
+            erase(shard, itr -> second);
+        }
+        if (shard.entries.size() >= _shard_capacity) {
+            erase(shard, std::prev(shard.entries.end()));
+            ++shard.evictions;
+        }
+        shard.entries.push_front(
+            Entry { hash, std::move(arguments), options, bytes });
+        shard.index.emplace(hash, shard.entries.begin());
+        shard.bytes += bytes;
+        return options;
+    }
+
+    ParseCacheStats get_stats() {
+        ParseCacheStats stats = { 0, 0, 0, 0, 0, 0 };
+        stats.bypasses = _bypasses.load(std::memory_order_relaxed);
+        for (Shard& shard : _shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            stats.hits += shard.hits;
+            stats.misses += shard.misses;
+            stats.evictions += shard.evictions;
+            stats.entries += shard.entries.size();
+            stats.bytes += shard.bytes;
+        }
+        return stats;
+    }
+
+    void count_bypass() noexcept {
+        _bypasses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void clear() {
+        for (Shard& shard : _shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.index.clear();
+            shard.entries.clear();
+            shard.bytes = 0;
+        }
+    }
+
+private:
+    /*! A cached command line. */
+    struct Entry {
+        std::uint64_t                  hash;
+        /*! Arguments, each followed by '\0'. */
+        std::string                    arguments;
+        std::shared_ptr<const Options> options;
+        std::size_t                    bytes;
+    };
+
+    typedef std::list<Entry>::iterator entry_iterator;
+
+    /*! Bytes of the list and index nodes of an entry. */
+    static constexpr std::size_t ENTRY_BYTES =
+        sizeof(Entry) + 8 * sizeof(void*);
+
+    /*! Entries with the same hash bits, on cache lines of their own. */
+    struct alignas(64) Shard {
+        std::mutex                                        mutex;
+        /*! Entries, the most recently used first. */
+        std::list<Entry>                                  entries;
+        std::unordered_map<std::uint64_t, entry_iterator> index;
+        std::uint64_t                                     hits = 0;
+        std::uint64_t                                     misses = 0;
+        std::uint64_t                                     evictions = 0;
+        std::size_t                                       bytes = 0;
+    };
+
+    Shard& shard_of(std::uint64_t hash) noexcept {
+        /* The index uses the low bits, shards the high ones. */
+        return _shards[(hash >> 48) & _mask];
+    }
+
+    static bool same_arguments(const std::string& arguments,
+                               int argc,
+                               const char *argv[]) noexcept {
+        std::size_t position = 0;
+        for (int i = 0; i < argc; ++i) {
+            std::size_t size = std::strlen(argv[i]);
+            if (arguments.size() - position < size + 1 ||
+                std::memcmp(arguments.data() + position,
+                            argv[i], size + 1) != 0) {
+                return false;
+            }
+            position += size + 1;
+        }
+        return position == arguments.size();
+    }
+
+    static void erase(Shard& shard, entry_iterator entry) {
+        shard.bytes -= entry -> bytes;
+        shard.index.erase(entry -> hash);
+        shard.entries.erase(entry);
+    }
+
+    std::vector<Shard>         _shards;
+    std::size_t                _mask;
+    std::size_t                _shard_capacity;
+    /*! Not kept by shard: bypasses have no hash. */
+    std::atomic<std::uint64_t> _bypasses;
+};
+
+ParseCache::ParseCache(std::size_t capacity, std::size_t shards)
+    : _pimpl() {
+    assert(capacity > 0 && shards > 0);
+    _pimpl.reset(new Impl(capacity, shards));
+}
+
+ParseCache::~ParseCache() { }
+
+ParseCacheStats ParseCache::get_stats() const {
+    return _pimpl -> get_stats();
+}
+
+void ParseCache::clear() {
+    _pimpl -> clear();
+}
+
+std::uint64_t ParseCache::hash_arguments(int argc,
+                                         const char *argv[]) noexcept {
+    _LIBOPTPARSE_::Hasher hasher;
+    for (int i = 0; i < argc; ++i) {
+        hasher.add(std::string_view(argv[i]));
+    }
+    return hasher.digest();
+}
+
+std::shared_ptr<const Options> ParseCache::lookup(std::uint64_t hash,
+                                                  int argc,
+                                                  const char *argv[]) {
+    return _pimpl -> lookup(hash, argc, argv);
+}
+
+void ParseCache::count_bypass() noexcept {
+    _pimpl -> count_bypass();
+}
+
+std::shared_ptr<const Options> ParseCache::store(
+    std::uint64_t hash,
+    int argc,
+    const char *argv[],
+    std::shared_ptr<const Options> options) {
+    return _pimpl -> store(hash, argc, argv, std::move(options));
+}
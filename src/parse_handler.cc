@@ -0,0 +1,35 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "liboptparse/parse_handler.hh"
+
+ParseHandler::~ParseHandler() { }
+
+void ParseHandler::on_program_name(const ArgumentText&) { }
+
+void ParseHandler::on_option(const OptionArgument&) { }
+
+void ParseHandler::on_value(const OptionArgument&,
+                            const ArgumentText&) { }
+
+void ParseHandler::on_positional(const ArgumentText&) { }
+
+void ParseHandler::on_end() { }
+
+bool ParseHandler::on_error(const ParseError&) {
+    return false;
+}
@@ -0,0 +1,144 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cassert>
+
+#include "liboptparse/parse_range.hh"
+
+namespace {
+    /*! Handler appending the items found to a vector. */
+    struct ItemCollector {
+        const std::vector<OptionArgument*>& arguments;
+        std::vector<ParsedItem>&            items;
+
+        void push(ParsedItemType type,
+                  const OptionArgument* option,
+                  const ArgumentText& value,
+                  bool has_value) {
+            items.push_back(ParsedItem {
+                    type, option, value, has_value,
+                    _LIBOPTPARSE_::NO_ERROR });
+        }
+
+        void on_program_name(const ArgumentText& name) {
+            push(parsed_program_name, NULL, name, false);
+        }
+
+        bool on_option(option_id id) {
+            push(parsed_option, arguments[id], ArgumentText(), false);
+            return true;
+        }
+
+        bool on_option(option_id id, const ArgumentText& value) {
+            push(parsed_option, arguments[id], value, true);
+            return true;
+        }
+
+        void on_positional(const ArgumentText& value) {
+            push(parsed_positional, NULL, value, false);
+        }
+
+        void on_end() { }
+
+        bool operator()(const ParseError& error) {
+            items.push_back(ParsedItem {
+                    parsed_error, NULL, ArgumentText(), false, error });
+            return true;
+        }
+    };
+}
+
+ParseRange::ParseRange(const _LIBOPTPARSE_::HashOptionIndex& index,
+                       const std::vector<OptionArgument*>& arguments,
+                       int argc,
+                       const char *argv[])
+    : _index(index), _arguments(arguments), _argc(argc), _argv(argv) { }
+
+ParseRange::const_iterator ParseRange::begin() const {
+    return const_iterator(*this);
+}
+
+ParseRange::const_iterator ParseRange::end() const {
+    return const_iterator();
+}
+
+ParseRange::const_iterator::const_iterator()
+    : _range(NULL),
+      _token(0),
+      _state(stop_never, 0),
+      _items(),
+      _next(0) { }
+
+ParseRange::const_iterator::const_iterator(const ParseRange& range)
+    : _range(&range),
+      _token(range._argc, range._argv),
+      _state(stop_never, range._argc),
+      _items(),
+      _next(0) {
+    load();
+}
+
+ParseRange::const_iterator::reference
+ParseRange::const_iterator::operator*() const noexcept {
+    assert(_range != NULL);
+    return _items[_next];
+}
+
+ParseRange::const_iterator::pointer
+ParseRange::const_iterator::operator->() const noexcept {
+    assert(_range != NULL);
+    return &_items[_next];
+}
+
+ParseRange::const_iterator& ParseRange::const_iterator::operator++() {
+    assert(_range != NULL);
+    ++_next;
+    if (_next == _items.size()) {
+        load();
+    }
+    return *this;
+}
+
+bool ParseRange::const_iterator::operator==(
+    const const_iterator& other) const noexcept {
+    return _range == NULL && other._range == NULL;
+}
+
+bool ParseRange::const_iterator::operator!=(
+    const const_iterator& other) const noexcept {
+    return !(*this == other);
+}
+
+void ParseRange::const_iterator::load() {
+    _items.clear();
+    _next = 0;
+    _LIBOPTPARSE_::TokenIterator end(_range -> _argc);
+    _LIBOPTPARSE_::RuntimeSchema schema {
+        _range -> _index, _range -> _arguments };
+    ItemCollector collector { _range -> _arguments, _items };
+    while (_items.empty() && _token != end) {
+        _LIBOPTPARSE_::evaluate_next(_token,
+                                     end,
+                                     _state,
+                                     schema,
+                                     collector,
+                                     collector);
+    }
+    if (_items.empty()) {
+        _range = NULL;
+    }
+}
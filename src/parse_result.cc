@@ -0,0 +1,102 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cassert>
+
+#include "liboptparse/parse_result.hh"
+
+const char* describe(ParseErrorType type) noexcept {
+    switch (type) {
+    case parse_ok:
+        return "no error";
+    case unknown_short_option:
+        return "unknown short option";
+    case unknown_long_option:
+        return "unknown long option";
+    case missing_option_name:
+        return "missing option name";
+    case missing_option_value:
+        return "missing option value";
+    case invalid_option_value:
+        return "invalid option value";
+    case unknown_command:
+        return "unknown command";
+    case unreadable_response_file:
+        return "unreadable response file";
+    case response_file_too_large:
+        return "response files too large";
+    case nested_response_file:
+        return "response file nested too deep";
+    case unreadable_input:
+        return "unreadable input";
+    case unreadable_config_file:
+        return "unreadable config file";
+    case invalid_config_line:
+        return "invalid config line";
+    case unknown_config_key:
+        return "unknown config key";
+    case split_response_file:
+        return "parse stopped inside response file";
+    }
+    return "unknown error";
+}
+
+std::ostream& operator<<(std::ostream& os, const ParseError& error) {
+    os << describe(error.type)
+       << " at argument " << error.index
+       << ", position " << error.position;
+    return os;
+}
+
+ParseResult::ParseResult(std::unique_ptr<const Options> options)
+    : _options(std::move(options)),
+      _error(ParseError { parse_ok, 0, 0 }),
+      _tail(ArgumentSpan { 0, NULL }) {
+    assert(_options != NULL);
+}
+
+ParseResult::ParseResult(const ParseError& error)
+    : _options(), _error(error), _tail(ArgumentSpan { 0, NULL }) {
+    assert(_error.type != parse_ok);
+}
+
+ParseResult::~ParseResult() { }
+
+bool ParseResult::is_ok() const noexcept {
+    return _error.type == parse_ok;
+}
+
+ParseResult::operator bool() const noexcept {
+    return is_ok();
+}
+
+const ParseError& ParseResult::get_error() const noexcept {
+    return _error;
+}
+
+const ArgumentSpan& ParseResult::get_tail() const noexcept {
+    return _tail;
+}
+
+ParseResult& ParseResult::set_tail(const ArgumentSpan& tail) noexcept {
+    _tail = tail;
+    return *this;
+}
+
+std::unique_ptr<const Options> ParseResult::get_options() noexcept {
+    return std::move(_options);
+}
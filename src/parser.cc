@@ -17,263 +17,387 @@
 
 
 #include <cassert>
+#include <cctype>
+#include <climits>
+#include <cstring>
 #include <iostream>
-#include <iterator>
-#include <list>
 #include <memory>
 #include <ostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
+#include <unistd.h>
+
+#include "liboptparse/argument_stream.hh"
+#include "liboptparse/config_file.hh"
+#include "liboptparse/environment.hh"
 #include "liboptparse/optargs.hh"
+#include "liboptparse/option_index.hh"
 #include "liboptparse/program_info.hh"
+#include "liboptparse/parse_handler.hh"
+#include "liboptparse/parse_result.hh"
 #include "liboptparse/parser.hh"
+#include "liboptparse/parser_priv.hpp"
+#include "liboptparse/response_file.hh"
+#include "liboptparse/scanner.hh"
 #include "liboptparse/utils.hh"
 
 namespace {
-    const std::shared_ptr<OptionArgumentValue> TRUE(
-        new OptionArgumentValue("true"));
+    /*!
+     * Handler of the parser in binding mode: values are converted
+     * into the variables the options are bound to.
+     */
+    struct BindingHandler {
+        const std::vector<OptionArgument*>& arguments;
+        void*                               object;
 
-    enum TokenType {
-        MINUS,
-        NAME
-    };
-    
-    struct Token {
-        TokenType   type;
-        std::string value;
-
-        explicit Token(TokenType token_type)
-            : type(token_type) { }
-        explicit Token(TokenType token_type,
-                       const std::string& token_value)
-            : type(token_type), value(token_value) { }
-    };
+        void on_program_name(const ArgumentText&) const { }
 
-    std::string build_name(const char buffer[], int& pos) {
-         std::ostringstream ss;
-         std::ostream_iterator<const char> out(ss);
-         while(buffer[pos] != '\0' &&
-               buffer[pos] != ' ' &&
-               buffer[pos] != '=') {
-             if(buffer[pos] == '\\') {
-                 ++pos;
-             }
-             if (buffer[pos] != '\0') {
-                 *out = buffer[pos];
-                 ++pos;
-             }
-         }
-         return ss.str();
-    }
-
-    template<class InserterIterator>
-    void tokenize(int argc,
-                  const char *argv[],
-                  InserterIterator out) {
-        for (int i = 0; i < argc; ++i) {
-            int j = 0;
-            char current = argv[i][j];
-            while(current != '\0') {
-                switch(current) {
-                case '=':
-                case ' ':
-                    current = argv[i][++j];
-                    break;
-                case '-':
-                    *out = Token(MINUS);
-                    current = argv[i][++j];
-                    break;
-                default:
-                    *out = Token(NAME, build_name(argv[i], j));
-                    current = argv[i][j];
-                }
+        bool on_option(option_id id) const {
+            return store(id, "true");
+        }
+
+        bool on_option(option_id id, const ArgumentText& value) const {
+            if (!value.has_escapes()) {
+                return store(id, value.raw());
             }
+            return store(id, value.str());
         }
-    }
 
-    template<class ForwardIterator>
-    void parse_minus(ForwardIterator& itr, ForwardIterator end) {
-        while(itr != end && itr -> type != MINUS) {
-            ++itr;
+        void on_positional(const ArgumentText&) const { }
+
+        void on_end() const { }
+
+        bool store(option_id id, std::string_view value) const {
+            const _LIBOPTPARSE_::ValueBinder* binder =
+                arguments[id] -> get_binder();
+            return binder == NULL || binder -> store(object, value);
         }
-        ++itr;
-    }
+    };
+
+    /*!
+     * Handler of the parser in event mode: events are forwarded to
+     * the user's ParseHandler.
+     */
+    struct EventForwarder {
+        const std::vector<OptionArgument*>& arguments;
+        ParseHandler&                       handler;
 
-    template<class ForwardIterator>
-    void parse_short_options(
-        ForwardIterator& itr,
-        ForwardIterator end,
-        const std::map<char, const OptionArgument*>& opt_arg,
-        std::map<char, Options::value_type>& values) {
-        while(itr != end && itr -> type != NAME) {
-            ++itr;
+        void on_program_name(const ArgumentText& name) const {
+            handler.on_program_name(name);
         }
-        if (itr == end) {
-            return;
+
+        bool on_option(option_id id) const {
+            handler.on_option(*arguments[id]);
+            return true;
         }
-        auto opt_name = itr -> value;
-        ++itr;
-                
-        if (opt_name.length() > 1) {
-            for (auto& opt : opt_name) {
-                values[opt] = TRUE;
-            }
-        } else {
-            char short_name = opt_name[0];
-            auto arg = opt_arg.at(short_name);
-            if (arg-> get_type() == OptionArgumentType::flag) {
-                values[short_name] = TRUE;
-            } else if (itr != end && itr -> type == NAME) {
-                values[short_name] = Options::value_type(
-                    new OptionArgumentValue(itr -> value));
-                ++itr;
-            } else {
-                values[short_name] = TRUE;
-            }
+
+        bool on_option(option_id id, const ArgumentText& value) const {
+            handler.on_option(*arguments[id]);
+            handler.on_value(*arguments[id], value);
+            return true;
         }
-    }
-    
-    template<class ForwardIterator>
-    void parse_long_option(
-        ForwardIterator& itr,
-        ForwardIterator end,
-        const std::map<char, const OptionArgument*>& opt_arg,
-        const std::map<std::string, char>& opt_mapping,
-        std::map<char, Options::value_type>& values) {
-        while(itr != end && itr -> type != NAME) {
-            ++itr;
+
+        void on_positional(const ArgumentText& value) const {
+            handler.on_positional(value);
+        }
+
+        void on_end() const {
+            handler.on_end();
         }
-        char short_name = opt_mapping.at(itr -> value);
-                ++itr;
-        if (itr != end && itr -> type == NAME) {
-            auto arg = opt_arg.at(short_name);
-            if(arg -> get_type() == OptionArgumentType::flag) {
-                values[short_name] = TRUE;
-            } else {
-                values[short_name] = Options::value_type(
-                    new OptionArgumentValue(itr -> value));
-                ++itr;
+    };
+
+    /*! Reporter forwarding errors to the user's ParseHandler. */
+    struct EventErrorReporter {
+        ParseHandler& handler;
+        ParseError    error;
+
+        bool operator()(const ParseError& found) {
+            if (error.type == parse_ok) {
+                error = found;
             }
+            return handler.on_error(found);
         }
-    }
-    
-    template<class ForwardIterator, class ArgsInserterIterator>
-    void evaluate(
-        ForwardIterator begin,
-        ForwardIterator end,
-        ProgramInfo& program_info,
-        const std::map<char, const OptionArgument*>& opt_arg,
-        const std::map<std::string, char>& opt_mapping,
-        std::map<char, Options::value_type>& values,
-        ArgsInserterIterator args_inserter_iterator) {
-        auto itr = begin;
-        bool is_program_name = true;
-        while(itr != end) {
-            switch(itr -> type) {
-            case MINUS:
-                parse_minus(itr, end);
-                if (itr -> type == MINUS) {
-                    parse_long_option(
-                        itr, end, opt_arg, opt_mapping, values);
-                } else {
-                    parse_short_options(itr, end, opt_arg, values);
-                }
-                break;
-            case NAME:
-                if (!is_program_name) {
-                    args_inserter_iterator = Options::value_type(
-                        new OptionArgumentValue(itr -> value));
-                } else {
-                    is_program_name = false;
-                    if (program_info.program_name.empty()) {
-                        program_info.program_name = itr -> value;
-                    }
-                }
-                ++itr;
-                break;
-            }           
+    };
+}
+
+const Options::value_type& _LIBOPTPARSE_::true_value() {
+    static const Options::value_type value(
+        new OptionArgumentValue("true"));
+    return value;
+}
+
+const Options::value_type& _LIBOPTPARSE_::false_value() {
+    static const Options::value_type value(
+        new OptionArgumentValue("false"));
+    return value;
+}
+
+const Options::value_type* _LIBOPTPARSE_::flag_value(
+    std::string_view text) noexcept {
+    static const char* const names[] = {
+        "true", "yes", "1", "false", "no", "0" };
+    for (std::size_t i = 0; i < 6; ++i) {
+        std::string_view name(names[i]);
+        bool equal = text.size() == name.size();
+        for (std::size_t c = 0; equal && c < name.size(); ++c) {
+            equal = std::tolower(static_cast<unsigned char>(text[c])) ==
+                name[c];
+        }
+        if (equal) {
+            return i < 3 ? &true_value() : &false_value();
         }
     }
-
+    return NULL;
 }
 
 class OptionParser::Impl {
 public:
     Impl()
         : _option_arguments(new OptionParser::container()),
-          _program_info(new ProgramInfo()) { }
+          _arguments(),
+          _index(new _LIBOPTPARSE_::HashOptionIndex()),
+          _program_info(new ProgramInfo()),
+          _response_limits(ResponseFileLimits { 0, 0 }),
+          _env_prefix() { }
 
     explicit Impl(const ProgramInfo& program_info)
         : _option_arguments(new OptionParser::container()),
-          _program_info(new ProgramInfo(program_info)) { }
+          _arguments(),
+          _index(new _LIBOPTPARSE_::HashOptionIndex()),
+          _program_info(new ProgramInfo(program_info)),
+          _response_limits(ResponseFileLimits { 0, 0 }),
+          _env_prefix() { }
 
     explicit Impl(const Impl& impl)
         : _option_arguments(new OptionParser::container(
                                 impl._option_arguments -> begin(),
                                 impl._option_arguments -> end())),
-          _program_info(new ProgramInfo(*impl._program_info)) { }
+          _arguments(impl._arguments),
+          _index(impl._index),
+          _program_info(new ProgramInfo(*impl._program_info)),
+          _response_limits(impl._response_limits),
+          _env_prefix(impl._env_prefix) { }
 
     explicit Impl(Impl&& impl)
         : _option_arguments(impl._option_arguments.release()),
-          _program_info(impl._program_info) {
+          _arguments(std::move(impl._arguments)),
+          _index(impl._index),
+          _program_info(impl._program_info),
+          _response_limits(impl._response_limits),
+          _env_prefix(std::move(impl._env_prefix)) {
     }
 
     OptionArgument& add(const OptionArgument& argument) {
-        std::shared_ptr<OptionArgument> ptr(
-            new OptionArgument(argument));
-        _option_arguments -> push_back(ptr);
-        return *ptr;
+        return insert(std::shared_ptr<OptionArgument>(
+                          new OptionArgument(argument)));
     }
 
     OptionArgument& add(char short_name) {
-        std::shared_ptr<OptionArgument> ptr(
-            new OptionArgument(short_name));
-        _option_arguments -> push_back(ptr);
-        return *ptr;
+        return insert(std::shared_ptr<OptionArgument>(
+                          new OptionArgument(short_name)));
+    }
+
+    OptionArgument& add(const std::string& long_name) {
+        return insert(std::shared_ptr<OptionArgument>(
+                          new OptionArgument(long_name)));
     }
 
     OptionArgument& add(char short_name,
                         const std::string& long_name) {
-        std::shared_ptr<OptionArgument> ptr(new OptionArgument(
-                                            short_name,
-                                            long_name));
-        _option_arguments -> push_back(ptr);
-        return *ptr;
-    }
-
-    std::unique_ptr<const Options> parse(
-        int argc, const char *argv[]) {
-        Options::options_container opts_values;
-        Options::arguments_container args_values;
-        std::map<char, const OptionArgument*> arguments;
-        std::map<std::string, char> opt_mapping;
-        std::list<Token> tokens;
-        for(auto option_arg : *_option_arguments) {
-            arguments[option_arg -> get_short_name()] =
-                option_arg.get();
-            opt_mapping[option_arg -> get_long_name()] =
-                option_arg -> get_short_name();
-            opts_values[option_arg -> get_short_name()] =
-                Options::value_type(
-                    new OptionArgumentValue(
-                        option_arg -> get_default_value()));
-        }    
-        tokenize(argc, argv, std::back_inserter(tokens));
-        evaluate(tokens.begin(),
-                 tokens.end(),
-                 *_program_info,
-                 arguments,
-                 opt_mapping,
-                 opts_values,
-                 std::back_inserter(args_values));
-        return std::unique_ptr<const Options>(
-            new Options(
-                *_program_info,
-                opts_values.cbegin(),
-                opts_values.cend(),
-                args_values.cbegin(),
-                args_values.cend()));
+        return insert(std::shared_ptr<OptionArgument>(
+                          new OptionArgument(short_name, long_name)));
+    }
+
+    ParseResult try_parse(int argc,
+                          const char *argv[],
+                          StopMode stop = stop_never,
+                          const ConfigFile* config = NULL) {
+        if (!has_response_files(argc, argv)) {
+            _LIBOPTPARSE_::FirstErrorReporter report;
+            int tail = argc;
+            auto options = parse(argc, argv, report, stop, tail, config);
+            if (report.error.type != parse_ok) {
+                return ParseResult(report.error);
+            }
+            ParseResult result(std::move(options));
+            result.set_tail(ArgumentSpan { argc - tail, argv + tail });
+            return result;
+        }
+        ResponseFiles files;
+        ParseError error = files.expand(argc, argv, _response_limits);
+        if (error.type != parse_ok) {
+            return ParseResult(error);
+        }
+        _LIBOPTPARSE_::FirstErrorReporter report;
+        int size = static_cast<int>(files.size());
+        int tail = size;
+        auto options = parse(size, files.data(), report, stop, tail,
+                             config);
+        if (report.error.type != parse_ok) {
+            return ParseResult(report.error);
+        }
+        /* The tail is the caller's argv, response files not expanded. */
+        if (tail < size && files.is_from_file(tail)) {
+            return ParseResult(ParseError {
+                    split_response_file, files.get_origin(tail), 0 });
+        }
+        int rest = tail < size ? files.get_origin(tail) : argc;
+        ParseResult result(std::move(options));
+        result.set_tail(ArgumentSpan { argc - rest, argv + rest });
+        return result;
+    }
+
+    ParseResult try_parse_array(int argc,
+                                _LIBOPTPARSE_::ArgumentArray arguments) {
+        _LIBOPTPARSE_::FirstErrorReporter report;
+        int tail = argc;
+        std::unique_ptr<const Options> options;
+        if (has_response_files(argc, arguments)) {
+            ResponseFiles files;
+            ParseError error = files.expand(argc, arguments,
+                                            _response_limits);
+            if (error.type != parse_ok) {
+                return ParseResult(error);
+            }
+            options = parse(static_cast<int>(files.size()), files.data(),
+                            report, stop_never, tail);
+        } else {
+            options = parse(argc, arguments, report, stop_never, tail);
+        }
+        if (report.error.type != parse_ok) {
+            return ParseResult(report.error);
+        }
+        return ParseResult(std::move(options));
+    }
+
+    ParseResult try_parse(int argc,
+                          const char *argv[],
+                          std::vector<ParseError>& errors) {
+        std::size_t first = errors.size();
+        _LIBOPTPARSE_::AllErrorsReporter report { errors };
+        int tail = argc;
+        std::unique_ptr<const Options> options;
+        if (has_response_files(argc, argv)) {
+            ResponseFiles files;
+            ParseError error = files.expand(argc, argv, _response_limits);
+            if (error.type != parse_ok) {
+                errors.push_back(error);
+                return ParseResult(error);
+            }
+            options = parse(static_cast<int>(files.size()), files.data(),
+                            report, stop_never, tail);
+        } else {
+            options = parse(argc, argv, report, stop_never, tail);
+        }
+        if (errors.size() != first) {
+            return ParseResult(errors[first]);
+        }
+        return ParseResult(std::move(options));
+    }
+
+    void set_response_files(const ResponseFileLimits& limits) noexcept {
+        _response_limits = limits;
+    }
+
+    void set_env_prefix(const std::string& prefix) {
+        _env_prefix = prefix;
+    }
+
+    const ResponseFileLimits& get_response_files() const noexcept {
+        return _response_limits;
+    }
+
+    const std::string& get_env_prefix() const noexcept {
+        return _env_prefix;
+    }
+
+    bool reads_environment() const noexcept {
+        if (!_env_prefix.empty()) {
+            return true;
+        }
+        for (auto option_arg : _arguments) {
+            if (!option_arg -> get_env_name().empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<class ErrorReporter>
+    void parse_into(void* object,
+                    int argc,
+                    const char *argv[],
+                    ErrorReporter& report) {
+        BindingHandler handler { _arguments, object };
+        _LIBOPTPARSE_::evaluate_command_line(
+            argc,
+            argv,
+            _LIBOPTPARSE_::RuntimeSchema { *_index, _arguments },
+            handler,
+            report);
+    }
+
+    ParseRange parse_lazily(int argc, const char *argv[]) const {
+        return ParseRange(*_index, _arguments, argc, argv);
+    }
+
+    ParseError parse_events(int argc,
+                            const char *argv[],
+                            ParseHandler& handler) {
+        EventForwarder forwarder { _arguments, handler };
+        EventErrorReporter report { handler, _LIBOPTPARSE_::NO_ERROR };
+        _LIBOPTPARSE_::evaluate_command_line(
+            argc,
+            argv,
+            _LIBOPTPARSE_::RuntimeSchema { *_index, _arguments },
+            forwarder,
+            report);
+        return report.error;
+    }
+
+    ParseError parse_stream(int fd,
+                            ParseHandler& handler,
+                            std::size_t chunk_size) {
+        EventForwarder forwarder { _arguments, handler };
+        EventErrorReporter report { handler, _LIBOPTPARSE_::NO_ERROR };
+        _LIBOPTPARSE_::ArgumentStream stream(fd, chunk_size);
+        _LIBOPTPARSE_::ArgumentArray arguments(
+            &stream, &_LIBOPTPARSE_::ArgumentStream::read);
+        /* The length is not known: the stream ends the arguments. */
+        _LIBOPTPARSE_::EvaluationState state(stop_never, INT_MAX);
+        state.is_program_name = false;
+        _LIBOPTPARSE_::evaluate(
+            _LIBOPTPARSE_::TokenIterator(INT_MAX, arguments),
+            _LIBOPTPARSE_::TokenIterator(INT_MAX),
+            state,
+            _LIBOPTPARSE_::RuntimeSchema { *_index, _arguments },
+            forwarder,
+            report);
+        if (stream.failed()) {
+            report(ParseError { unreadable_input, stream.count(), 0 });
+        }
+        return report.error;
+    }
+
+    /*!
+     * Checks if the options are bound to variables or to members of
+     * the type passed.
+     */
+    bool is_bindable(const std::type_info* type) const noexcept {
+        bool ok = true;
+        for (auto itr = _arguments.cbegin();
+             itr != _arguments.cend() && ok;
+             ++itr) {
+            const _LIBOPTPARSE_::ValueBinder* binder =
+                (*itr) -> get_binder();
+            ok = binder == NULL ||
+                binder -> get_object_type() == NULL ||
+                (type != NULL && *binder -> get_object_type() == *type);
+        }
+        return ok;
     }
 
     OptionParser::const_iterator cbegin() {
@@ -286,23 +410,166 @@ public:
 
     /*!
      * Assertion method used to check if this parser is valid or not.
+     * Each argument is checked once, when it is added, and the index
+     * rejects repeated names, so it is enough to check that all the
+     * arguments are indexed: it takes constant time.
      * \return True if this parser is valid, false otherwise.
      */
-    bool OK() const noexcept {    
-        for (auto& opt_arg : *_option_arguments) {
-            _LIBOPTPARSE_::is_valid_opt_arg(*opt_arg);
-        }
-        return true;
+    bool OK() const noexcept {
+        return _index != NULL &&
+            _program_info != NULL &&
+            _arguments.size() == _index -> size() &&
+            _arguments.size() == _option_arguments -> size();
     }
 
 private:
-    
+    /*!
+     * Give an id to the argument passed and add it. The index is
+     * shared with the options returned by parse, so it is copied
+     * before changing it if they are still alive.
+     */
+    OptionArgument& insert(std::shared_ptr<OptionArgument> argument) {
+        check_not_contained(*argument);
+        if (_index.use_count() > 1) {
+            _index.reset(new _LIBOPTPARSE_::HashOptionIndex(*_index));
+        }
+        argument -> set_id(_index -> add(argument -> get_short_name(),
+                                         argument -> get_long_name()));
+        _option_arguments -> push_back(argument);
+        _arguments.push_back(argument.get());
+        return *argument;
+    }
+
+    /*!
+     * Throws invalid_argument if a name of the argument passed is
+     * already used by an other argument.
+     */
+    void check_not_contained(const OptionArgument& argument) const {
+        if (argument.has_short_name() &&
+            _index -> find(argument.get_short_name()) != NO_OPTION_ID) {
+            throw std::invalid_argument(
+                std::string("duplicate short option: ") +
+                argument.get_short_name());
+        }
+        if (!argument.get_long_name().empty() &&
+            _index -> find(argument.get_long_name()) != NO_OPTION_ID) {
+            throw std::invalid_argument(
+                "duplicate long option: " + argument.get_long_name());
+        }
+    }
+
+    template<class ErrorReporter>
+    std::unique_ptr<const Options> parse(int argc,
+                                         _LIBOPTPARSE_::ArgumentArray argv,
+                                         ErrorReporter& report,
+                                         StopMode stop,
+                                         int& tail,
+                                         const ConfigFile* config = NULL) {
+        _LIBOPTPARSE_::ParsedValues parsed;
+        parsed.values.reserve(_arguments.size());
+        for(auto option_arg : _arguments) {
+            parsed.add_default(
+                option_arg -> get_type(),
+                Options::value_type(
+                    new OptionArgumentValue(
+                        option_arg -> get_default_value())));
+        }
+        if ((config != NULL && !read_config(*config, parsed, report)) ||
+            !read_environment(parsed, report)) {
+            return std::unique_ptr<const Options>();
+        }
+        return _LIBOPTPARSE_::parse_command_line(
+            argc,
+            argv,
+            *_program_info,
+            _LIBOPTPARSE_::RuntimeSchema { *_index, _arguments },
+            _index,
+            std::move(parsed),
+            report,
+            stop,
+            tail);
+    }
+
     /*! Pointer to the option argument list. */
     std::unique_ptr<container>   _option_arguments;
 
+    /*! Option arguments indexed by id. */
+    std::vector<OptionArgument*> _arguments;
+
+    /*! Index from option names to ids. */
+    std::shared_ptr<_LIBOPTPARSE_::HashOptionIndex> _index;
+
     /*! Pointer to the program informations.  */
     std::shared_ptr<ProgramInfo> _program_info;
 
+    /*! Limits of response files, max_depth is 0 if disabled. */
+    ResponseFileLimits           _response_limits;
+
+    /*! Prefix of the variables matched by long name. */
+    std::string                  _env_prefix;
+
+    template<class Arguments>
+    bool has_response_files(int argc, const Arguments& argv) const {
+        return _response_limits.max_depth > 0 &&
+            ResponseFiles::has_response_files(argc, argv);
+    }
+
+    /*!
+     * Replace the default values passed with the ones of the config
+     * passed.
+     * \return False if an error stopped the parse.
+     */
+    template<class ErrorReporter>
+    bool read_config(const ConfigFile& config,
+                     _LIBOPTPARSE_::ParsedValues& parsed,
+                     ErrorReporter& report) const {
+        for (const ConfigEntry& entry : config) {
+            option_id id = _index -> find(entry.key);
+            if (id == NO_OPTION_ID) {
+                if (!report(ParseError {
+                            unknown_config_key, entry.line, 0 })) {
+                    return false;
+                }
+                continue;
+            }
+            if (!store(parsed, id, entry.value) &&
+                !report(ParseError {
+                        invalid_option_value, entry.line, 0 })) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*!
+     * Replace the values passed, defaults or read from the config,
+     * with the ones found in the environment.
+     * \return False if an error stopped the parse.
+     */
+    template<class ErrorReporter>
+    bool read_environment(_LIBOPTPARSE_::ParsedValues& parsed,
+                          ErrorReporter& report) const {
+        _LIBOPTPARSE_::EnvironmentMatcher matcher(*_index, _env_prefix);
+        for (auto option_arg : _arguments) {
+            if (!option_arg -> get_env_name().empty()) {
+                matcher.add(option_arg -> get_env_name(),
+                            option_arg -> get_id());
+            }
+        }
+        return _LIBOPTPARSE_::read_environment(
+            environ,
+            matcher,
+            _LIBOPTPARSE_::RuntimeSchema { *_index, _arguments },
+            parsed,
+            report);
+    }
+
+    bool store(_LIBOPTPARSE_::ParsedValues& parsed,
+               option_id id,
+               std::string_view value) const {
+        return parsed.store(id, _arguments[id] -> get_type(), value);
+    }
+
 };
 
 
@@ -339,6 +606,16 @@ OptionArgument& OptionParser::add(char short_name) {
     return added;
 }
 
+OptionArgument& OptionParser::add(const std::string& long_name) {
+    assert(_pimpl -> OK() &&
+           _LIBOPTPARSE_::is_valid_names('\0', long_name));
+    OptionArgument& added = _pimpl -> add(long_name);
+    assert(_pimpl -> OK() &&
+           _LIBOPTPARSE_::is_valid_opt_arg(added) &&
+           added.get_long_name() == long_name);
+    return added;
+}
+
 OptionArgument& OptionParser::add(char short_name,
                                   const std::string& long_name) {
     assert(_pimpl -> OK() &&
@@ -370,8 +647,154 @@ OptionParser::const_iterator OptionParser::cend() {
 std::unique_ptr<const Options> OptionParser::parse(
     int argc, const char *argv[]) {
     assert(_pimpl -> OK());
-    std::unique_ptr<const Options> options =
-        _pimpl -> parse(argc, argv);
+    ParseResult result = _pimpl -> try_parse(argc, argv);
+    assert(_pimpl -> OK());
+    if (!result.is_ok()) {
+        std::ostringstream message;
+        message << result.get_error();
+        throw std::out_of_range(message.str());
+    }
+    return result.get_options();
+}
+
+ParseResult OptionParser::try_parse(int argc, const char *argv[]) {
+    assert(_pimpl -> OK());
+    ParseResult result = _pimpl -> try_parse(argc, argv);
+    assert(_pimpl -> OK());
+    return result;
+}
+
+ParseResult OptionParser::try_parse(int argc,
+                                    const char *argv[],
+                                    StopMode stop) {
+    assert(_pimpl -> OK());
+    ParseResult result = _pimpl -> try_parse(argc, argv, stop);
+    assert(_pimpl -> OK());
+    return result;
+}
+
+std::unique_ptr<const Options> OptionParser::parse(
+    int argc, const char *argv[], const ConfigFile& config) {
+    assert(_pimpl -> OK());
+    ParseResult result = _pimpl -> try_parse(argc, argv, stop_never,
+                                             &config);
+    assert(_pimpl -> OK());
+    if (!result.is_ok()) {
+        std::ostringstream message;
+        message << result.get_error();
+        throw std::out_of_range(message.str());
+    }
+    return result.get_options();
+}
+
+ParseResult OptionParser::try_parse(int argc,
+                                    const char *argv[],
+                                    const ConfigFile& config) {
+    assert(_pimpl -> OK());
+    ParseResult result = _pimpl -> try_parse(argc, argv, stop_never,
+                                             &config);
+    assert(_pimpl -> OK());
+    return result;
+}
+
+ParseResult OptionParser::try_parse(int argc,
+                                    const char *argv[],
+                                    std::vector<ParseError>& errors) {
+    assert(_pimpl -> OK());
+    ParseResult result = _pimpl -> try_parse(argc, argv, errors);
+    assert(_pimpl -> OK());
+    return result;
+}
+
+ParseResult OptionParser::try_parse_array(
+    int argc, _LIBOPTPARSE_::ArgumentArray arguments) {
+    assert(_pimpl -> OK());
+    ParseResult result = _pimpl -> try_parse_array(argc, arguments);
+    assert(_pimpl -> OK());
+    return result;
+}
+
+OptionParser& OptionParser::set_response_files(
+    const ResponseFileLimits& limits) {
+    assert(_pimpl -> OK() && limits.max_depth >= 0);
+    _pimpl -> set_response_files(limits);
+    assert(_pimpl -> OK());
+    return *this;
+}
+
+OptionParser& OptionParser::set_env_prefix(const std::string& prefix) {
+    assert(_pimpl -> OK());
+    _pimpl -> set_env_prefix(prefix);
+    assert(_pimpl -> OK());
+    return *this;
+}
+
+const ResponseFileLimits& OptionParser::get_response_files() const
+    noexcept {
+    return _pimpl -> get_response_files();
+}
+
+const std::string& OptionParser::get_env_prefix() const noexcept {
+    return _pimpl -> get_env_prefix();
+}
+
+bool OptionParser::reads_environment() const noexcept {
+    return _pimpl -> reads_environment();
+}
+
+ParseError OptionParser::try_parse_into(int argc, const char *argv[]) {
+    return parse_into(NULL, NULL, argc, argv, NULL);
+}
+
+ParseError OptionParser::try_parse_into(int argc,
+                                        const char *argv[],
+                                        std::vector<ParseError>& errors) {
+    return parse_into(NULL, NULL, argc, argv, &errors);
+}
+
+ParseError OptionParser::parse_into(void* object,
+                                    const std::type_info* type,
+                                    int argc,
+                                    const char *argv[],
+                                    std::vector<ParseError>* errors) {
+    assert(_pimpl -> OK() && _pimpl -> is_bindable(type));
+    ParseError error = { parse_ok, 0, 0 };
+    if (errors == NULL) {
+        _LIBOPTPARSE_::FirstErrorReporter report;
+        _pimpl -> parse_into(object, argc, argv, report);
+        error = report.error;
+    } else {
+        std::size_t first = errors -> size();
+        _LIBOPTPARSE_::AllErrorsReporter report { *errors };
+        _pimpl -> parse_into(object, argc, argv, report);
+        if (errors -> size() != first) {
+            error = (*errors)[first];
+        }
+    }
+    assert(_pimpl -> OK());
+    return error;
+}
+
+ParseError OptionParser::parse_events(int argc,
+                                      const char *argv[],
+                                      ParseHandler& handler) {
+    assert(_pimpl -> OK());
+    ParseError error = _pimpl -> parse_events(argc, argv, handler);
+    assert(_pimpl -> OK());
+    return error;
+}
+
+ParseError OptionParser::parse_stream(int fd,
+                                      ParseHandler& handler,
+                                      std::size_t chunk_size) {
+    assert(_pimpl -> OK() && chunk_size > 0);
+    ParseError error = _pimpl -> parse_stream(fd, handler, chunk_size);
+    assert(_pimpl -> OK());
+    return error;
+}
+
+ParseRange OptionParser::parse_lazily(int argc,
+                                      const char *argv[]) const {
     assert(_pimpl -> OK());
-    return options;
+    return _pimpl -> parse_lazily(argc, argv);
 }
@@ -0,0 +1,90 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include "liboptparse/repeated_values.hh"
+
+_LIBOPTPARSE_::RepeatedValues::RepeatedValues() noexcept
+    : _text(), _occurrences(), _counts(), _values(), _offsets() { }
+
+char* _LIBOPTPARSE_::RepeatedValues::reserve(option_id id,
+                                             std::size_t size) {
+    assert(_offsets.empty());
+    if (id >= _counts.size()) {
+        _counts.resize(id + 1, 0);
+    }
+    std::size_t offset = _text.size();
+    _text.resize(offset + size);
+    _occurrences.push_back(Occurrence { id, offset, size });
+    return _text.data() + offset;
+}
+
+std::size_t _LIBOPTPARSE_::RepeatedValues::add(option_id id,
+                                               const ArgumentText& value) {
+    if (!value.has_escapes()) {
+        return add(id, value.raw());
+    }
+    std::size_t size = value.size();
+    value.copy(reserve(id, size), size);
+    return _counts[id]++;
+}
+
+std::size_t _LIBOPTPARSE_::RepeatedValues::add(option_id id,
+                                               std::string_view value) {
+    std::memcpy(reserve(id, value.size()), value.data(), value.size());
+    return _counts[id]++;
+}
+
+std::string_view _LIBOPTPARSE_::RepeatedValues::back() const noexcept {
+    assert(!_occurrences.empty());
+    const Occurrence& last = _occurrences.back();
+    return std::string_view(_text.data() + last.offset, last.size);
+}
+
+void _LIBOPTPARSE_::RepeatedValues::freeze(std::size_t options) {
+    assert(_counts.size() <= options);
+    if (_occurrences.empty()) {
+        return;
+    }
+    _counts.resize(options, 0);
+    _offsets.assign(options + 1, 0);
+    for (option_id id = 0; id < options; ++id) {
+        _offsets[id + 1] = _offsets[id] + _counts[id];
+        _counts[id] = _offsets[id];
+    }
+    _values.resize(_offsets[options]);
+    for (const Occurrence& occurrence : _occurrences) {
+        if (occurrence.id == NO_OPTION_ID) {
+            continue;
+        }
+        _values[_counts[occurrence.id]++] = std::string_view(
+            _text.data() + occurrence.offset, occurrence.size);
+    }
+    _occurrences = std::vector<Occurrence>();
+    _counts = std::vector<std::size_t>();
+}
+
+ValueSpan _LIBOPTPARSE_::RepeatedValues::get(
+    option_id id) const noexcept {
+    if (_offsets.empty()) {
+        return ValueSpan();
+    }
+    return ValueSpan(_values.data() + _offsets[id],
+                     _offsets[id + 1] - _offsets[id]);
+}
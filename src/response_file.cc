@@ -0,0 +1,136 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "liboptparse/argument_text.hh"
+#include "liboptparse/response_file.hh"
+
+namespace {
+    bool is_blank(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+}
+
+ResponseFiles::ResponseFiles()
+    : _arguments(), _origins(), _mappings(), _bytes(0) { }
+
+ResponseFiles::~ResponseFiles() {
+    clear();
+}
+
+bool ResponseFiles::has_response_files(int argc, const char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '@' && argv[i][1] != '\0') {
+            return true;
+        }
+    }
+    return false;
+}
+
+ParseErrorType ResponseFiles::include(const std::string& path,
+                                      const ResponseFileLimits& limits,
+                                      std::vector<file_id>& open_files,
+                                      int origin) {
+    if (open_files.size() >= static_cast<std::size_t>(limits.max_depth)) {
+        return nested_response_file;
+    }
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return unreadable_response_file;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        return unreadable_response_file;
+    }
+    file_id id(info.st_dev, info.st_ino);
+    if (std::find(open_files.begin(), open_files.end(), id) !=
+        open_files.end()) {
+        ::close(fd);
+        return nested_response_file;
+    }
+    std::size_t size = static_cast<std::size_t>(info.st_size);
+    if (size > limits.max_bytes - _bytes) {
+        ::close(fd);
+        return response_file_too_large;
+    }
+    if (size == 0) {
+        ::close(fd);
+        return parse_ok;
+    }
+    void* address = ::mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return unreadable_response_file;
+    }
+    ::madvise(address, size, MADV_SEQUENTIAL);
+    _mappings.push_back(Mapping { address, size });
+    _bytes += size;
+
+    open_files.push_back(id);
+    const char* current = static_cast<const char*>(address);
+    const char* end = current + size;
+    while (true) {
+        while (current != end && is_blank(*current)) {
+            ++current;
+        }
+        if (current == end) {
+            break;
+        }
+        const char* begin = current;
+        bool escaped = false;
+        while (current != end && !is_blank(*current)) {
+            if (*current == '\\') {
+                escaped = true;
+                if (current + 1 != end) {
+                    ++current;
+                }
+            }
+            ++current;
+        }
+        std::string_view argument(begin, current - begin);
+        if (!is_response_file(argument)) {
+            _arguments.push_back(argument);
+            _origins.push_back(~origin);
+            continue;
+        }
+        ArgumentText nested(argument.substr(1), escaped);
+        ParseErrorType error = include(
+            nested.str(), limits, open_files, origin);
+        if (error != parse_ok) {
+            return error;
+        }
+    }
+    open_files.pop_back();
+    return parse_ok;
+}
+
+void ResponseFiles::clear() noexcept {
+    for (auto& mapping : _mappings) {
+        ::munmap(mapping.address, mapping.size);
+    }
+    _mappings.clear();
+    _arguments.clear();
+    _origins.clear();
+    _bytes = 0;
+}
@@ -0,0 +1,150 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include "liboptparse/scanner.hh"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LIBOPTPARSE_HAVE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    inline bool is_delimiter(char c) {
+        return c == ' ' || c == '=' || c == '\\';
+    }
+
+#ifdef LIBOPTPARSE_HAVE_X86_SIMD
+
+    __attribute__((target("sse2")))
+    const char* find_delimiter_sse2(const char* begin,
+                                    const char* end) {
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i equal = _mm_set1_epi8('=');
+        const __m128i escape = _mm_set1_epi8('\\');
+        while (end - begin >= 16) {
+            __m128i chunk = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(begin));
+            __m128i found = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+                             _mm_cmpeq_epi8(chunk, equal)),
+                _mm_cmpeq_epi8(chunk, escape));
+            int mask = _mm_movemask_epi8(found);
+            if (mask != 0) {
+                return begin + __builtin_ctz(mask);
+            }
+            begin += 16;
+        }
+        return _LIBOPTPARSE_::find_delimiter_scalar(begin, end);
+    }
+
+    __attribute__((target("avx2")))
+    const char* find_delimiter_avx2(const char* begin,
+                                    const char* end) {
+        const __m256i space = _mm256_set1_epi8(' ');
+        const __m256i equal = _mm256_set1_epi8('=');
+        const __m256i escape = _mm256_set1_epi8('\\');
+        while (end - begin >= 32) {
+            __m256i chunk = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(begin));
+            __m256i found = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space),
+                                _mm256_cmpeq_epi8(chunk, equal)),
+                _mm256_cmpeq_epi8(chunk, escape));
+            unsigned int mask = static_cast<unsigned int>(
+                _mm256_movemask_epi8(found));
+            if (mask != 0) {
+                return begin + __builtin_ctz(mask);
+            }
+            begin += 32;
+        }
+        return find_delimiter_sse2(begin, end);
+    }
+
+    bool cpu_supports(const char* name) {
+        __builtin_cpu_init();
+        if (std::strcmp(name, "avx2") == 0) {
+            return __builtin_cpu_supports("avx2");
+        }
+        if (std::strcmp(name, "sse2") == 0) {
+            return __builtin_cpu_supports("sse2");
+        }
+        return false;
+    }
+
+#endif
+
+    _LIBOPTPARSE_::delimiter_finder select_delimiter_finder() {
+        _LIBOPTPARSE_::delimiter_finder finder =
+            _LIBOPTPARSE_::get_delimiter_finder("avx2");
+        if (finder == NULL) {
+            finder = _LIBOPTPARSE_::get_delimiter_finder("sse2");
+        }
+        if (finder == NULL) {
+            finder = _LIBOPTPARSE_::find_delimiter_scalar;
+        }
+        return finder;
+    }
+}
+
+const char* _LIBOPTPARSE_::find_delimiter_scalar(const char* begin,
+                                                 const char* end) {
+    while (begin != end && !is_delimiter(*begin)) {
+        ++begin;
+    }
+    return begin;
+}
+
+_LIBOPTPARSE_::delimiter_finder _LIBOPTPARSE_::get_delimiter_finder() {
+    static const delimiter_finder finder = select_delimiter_finder();
+    return finder;
+}
+
+const char* _LIBOPTPARSE_::get_delimiter_finder_name() {
+    delimiter_finder finder = get_delimiter_finder();
+    const char* name = "scalar";
+#ifdef LIBOPTPARSE_HAVE_X86_SIMD
+    if (finder == find_delimiter_avx2) {
+        name = "avx2";
+    } else if (finder == find_delimiter_sse2) {
+        name = "sse2";
+    }
+#endif
+    return name;
+}
+
+_LIBOPTPARSE_::delimiter_finder
+_LIBOPTPARSE_::get_delimiter_finder(const char* name) {
+    delimiter_finder finder = NULL;
+    if (std::strcmp(name, "scalar") == 0) {
+        finder = find_delimiter_scalar;
+    }
+#ifdef LIBOPTPARSE_HAVE_X86_SIMD
+    if (std::strcmp(name, "sse2") == 0 && cpu_supports(name)) {
+        finder = find_delimiter_sse2;
+    } else if (std::strcmp(name, "avx2") == 0 && cpu_supports(name)) {
+        finder = find_delimiter_avx2;
+    }
+#endif
+    return finder;
+}
+
+const char* _LIBOPTPARSE_::find_delimiter(const char* begin,
+                                          const char* end) {
+    return get_delimiter_finder()(begin, end);
+}
@@ -0,0 +1,168 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "liboptparse/shell_split.hh"
+
+namespace {
+    /*! Classes of the chars of a command string. */
+    enum CharClass : unsigned char {
+        PLAIN = 0,
+        BLANK = 1,
+        BACKSLASH = 2,
+        QUOTE = 3
+    };
+
+    struct CharClasses {
+        unsigned char table[256];
+
+        constexpr CharClasses() : table() {
+            table[(unsigned char) ' '] = BLANK;
+            table[(unsigned char) '\t'] = BLANK;
+            table[(unsigned char) '\n'] = BLANK;
+            table[(unsigned char) '\r'] = BLANK;
+            table[(unsigned char) '\\'] = BACKSLASH;
+            table[(unsigned char) '\''] = QUOTE;
+            table[(unsigned char) '"'] = QUOTE;
+        }
+    };
+
+    constexpr CharClasses CLASSES;
+
+    unsigned char class_of(char c) {
+        return CLASSES.table[static_cast<unsigned char>(c)];
+    }
+
+    /*! Chars the tokenizer takes as delimiters (see find_delimiter). */
+    bool is_delimiter(char c) {
+        return c == ' ' || c == '=' || c == '\\';
+    }
+
+    /*!
+     * Gets the position of the quote closing the quoted text
+     * beginning at the position passed.
+     * \throw std::invalid_argument if it is not closed.
+     */
+    std::size_t find_closing(std::string_view command, std::size_t open) {
+        char quote = command[open];
+        std::size_t i = open + 1;
+        while (i < command.size() && command[i] != quote) {
+            if (quote == '"' && command[i] == '\\') {
+                ++i;
+            }
+            ++i;
+        }
+        if (i >= command.size()) {
+            throw std::invalid_argument(
+                "unclosed quote at position " + std::to_string(open));
+        }
+        return i;
+    }
+}
+
+ShellSplit::ShellSplit(std::string_view command)
+    : _words(), _buffer(), _used(0), _copied(0) {
+    const std::size_t size = command.size();
+    std::size_t i = 0;
+    while (true) {
+        while (i < size && class_of(command[i]) == BLANK) {
+            ++i;
+        }
+        if (i == size) {
+            break;
+        }
+        std::size_t begin = i;
+        bool quoted = false;
+        while (i < size) {
+            unsigned char type = class_of(command[i]);
+            if (type == PLAIN) {
+                ++i;
+            } else if (type == BLANK) {
+                break;
+            } else if (type == BACKSLASH) {
+                i = std::min(i + 2, size);
+            } else {
+                quoted = true;
+                i = find_closing(command, i) + 1;
+            }
+        }
+        std::string_view word = command.substr(begin, i - begin);
+        if (quoted) {
+            if (_buffer == NULL) {
+                /* Escapes at most double the rest of the command. */
+                _buffer.reset(new char[2 * (size - begin)]);
+            }
+            add_quoted(word);
+        } else {
+            _words.push_back(word);
+        }
+    }
+}
+
+void ShellSplit::add_quoted(std::string_view word) {
+    /* A single quoted text needing no escapes is sliced. */
+    char quote = word.front();
+    if ((quote == '\'' || quote == '"') &&
+        word.size() >= 2 &&
+        word.find(quote, 1) == word.size() - 1) {
+        std::string_view text = word.substr(1, word.size() - 2);
+        bool plain = true;
+        for (char c : text) {
+            plain = plain && !is_delimiter(c);
+        }
+        if (plain) {
+            _words.push_back(text);
+            return;
+        }
+    }
+    char* copy = _buffer.get() + _used;
+    std::size_t length = 0;
+    char open = '\0';
+    for (std::size_t i = 0; i < word.size(); ++i) {
+        char c = word[i];
+        if (open == '\0') {
+            if (c == '\'' || c == '"') {
+                open = c;
+                continue;
+            }
+            /* Unquoted escapes are already in the tokenizer form. */
+            copy[length++] = c;
+            if (c == '\\' && i + 1 < word.size()) {
+                copy[length++] = word[++i];
+            }
+            continue;
+        }
+        if (c == open) {
+            open = '\0';
+            continue;
+        }
+        if (open == '"' && c == '\\' && i + 1 < word.size() &&
+            (word[i + 1] == '"' || word[i + 1] == '\\')) {
+            c = word[++i];
+        }
+        if (is_delimiter(c)) {
+            copy[length++] = '\\';
+        }
+        copy[length++] = c;
+    }
+    _used += length;
+    ++_copied;
+    _words.push_back(std::string_view(copy, length));
+}
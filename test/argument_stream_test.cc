@@ -0,0 +1,73 @@
+#include "../src/liboptparse/argument_stream.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstdio>
+#include <string>
+
+#include <unistd.h>
+
+using _LIBOPTPARSE_::ArgumentStream;
+
+TEST_GROUP(ArgumentStream) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A stream of arguments split by small chunks
+ * WHEN read them
+ * THEN each argument is whole, empty ones included, and the last one
+ *      may miss its '\0'.
+ */
+TEST(ArgumentStream, Test_01) {
+    const char input[] = "first\0\0a_long_argument\0last";
+    int fds[2];
+    CHECK_EQUAL(0, pipe(fds));
+    CHECK_EQUAL((long) sizeof(input) - 1,
+                (long) write(fds[1], input, sizeof(input) - 1));
+    close(fds[1]);
+    ArgumentStream stream(fds[0], 3);
+    CHECK_TRUE(stream.next() == "first");
+    std::string_view empty = stream.next();
+    CHECK_TRUE(empty.data() != NULL && empty.empty());
+    CHECK_TRUE(stream.next() == "a_long_argument");
+    CHECK_TRUE(stream.next() == "last");
+    CHECK_TRUE(stream.next().data() == NULL);
+    CHECK_TRUE(stream.next().data() == NULL);
+    CHECK_EQUAL(4, stream.count());
+    CHECK_FALSE(stream.failed());
+    close(fds[0]);
+}
+
+/**
+ * HAVE A large stream of short arguments
+ * WHEN read them
+ * THEN the buffer does not grow with the number of arguments.
+ */
+TEST(ArgumentStream, Test_02) {
+    FILE* file = tmpfile();
+    std::string chunk;
+    for (int i = 0; i < 1000; ++i) {
+        chunk += "--option" + std::to_string(i) + '\0';
+    }
+    for (int i = 0; i < 100; ++i) {
+        CHECK_EQUAL(chunk.size(),
+                    std::fwrite(chunk.data(), 1, chunk.size(), file));
+    }
+    std::fflush(file);
+    std::rewind(file);
+    ArgumentStream stream(fileno(file), 256);
+    std::size_t bytes = 0;
+    for (std::string_view argument = stream.next();
+         argument.data() != NULL;
+         argument = stream.next()) {
+        bytes += argument.size() + 1;
+    }
+    CHECK_EQUAL(100 * chunk.size(), bytes);
+    CHECK_EQUAL(100000, stream.count());
+    CHECK_EQUAL(256, stream.capacity());
+    std::fclose(file);
+}
@@ -0,0 +1,46 @@
+#include "../src/liboptparse/argument_text.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <sstream>
+#include <string>
+
+TEST_GROUP(ArgumentText) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A text without escapes
+ * WHEN read it
+ * THEN it is the same of the raw text.
+ */
+TEST(ArgumentText, Test_01) {
+    ArgumentText text(std::string_view("reply"), false);
+    CHECK_EQUAL((std::size_t)5, text.size());
+    CHECK_EQUAL(std::string("reply"), text.str());
+    CHECK_TRUE(text == "reply");
+    CHECK_TRUE(text != "repl");
+}
+
+/**
+ * HAVE A text with escapes
+ * WHEN read it
+ * THEN escapes are removed.
+ */
+TEST(ArgumentText, Test_02) {
+    ArgumentText text(std::string_view("a\\ b\\=c\\"), true);
+    char buffer[8];
+    CHECK_EQUAL((std::size_t)5, text.size());
+    CHECK_EQUAL(std::string("a b=c"), text.str());
+    CHECK_EQUAL((std::size_t)5, text.copy(buffer, sizeof(buffer)));
+    CHECK_EQUAL(std::string("a b=c"), std::string(buffer, 5));
+    CHECK_EQUAL((std::size_t)2, text.copy(buffer, 2));
+    CHECK_TRUE(text == "a b=c");
+    CHECK_TRUE(text != "a b=");
+    std::ostringstream os;
+    os << text;
+    CHECK_EQUAL(std::string("a b=c"), os.str());
+}
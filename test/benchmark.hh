@@ -0,0 +1,103 @@
+/* liboptparse is a library used to handle command line options.
+ * Copyright (C) 2020 Guybrush aka Gabriele Labita
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file      benchmark.hh
+ * \brief     Minimal benchmark harness.
+ * \copyright GNU Public License.
+ * \author    Gabriele Labita
+ *            <gabriele.labita@linux.it>
+ *
+ * This file contains the few helpers used by the optparse_bench
+ * program. It is built on demand with "make optparse_bench" inside
+ * the test directory and it is not part of the test suite.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+#ifndef LIBOPTPARSE_BENCHMARK_INCLUDE_GUARD_HH
+#define LIBOPTPARSE_BENCHMARK_INCLUDE_GUARD_HH 1
+
+namespace bench {
+    /*! Type of a benchmark function. */
+    typedef void (*function)();
+
+    /*!
+     * Register a benchmark to run. Use BENCHMARK macro instead.
+     */
+    struct Registration {
+        Registration(const char* group,
+                     const char* name,
+                     function body);
+    };
+
+    /*!
+     * Avoid the compiler to optimize away the computation of the
+     * value passed.
+     */
+    template<class T>
+    inline void keep(const T& value) {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    /*!
+     * Run the body passed iterations times and print the time spent
+     * for each iteration. When bytes is not 0 it prints the
+     * throughput too.
+     * \param label      - Label to print.
+     * \param iterations - Number of times to run body.
+     * \param bytes      - Bytes processed by each iteration.
+     * \param body       - Callable to measure.
+     * \return Seconds spent for each iteration.
+     */
+    template<class Body>
+    double measure(const char* label,
+                   std::size_t iterations,
+                   std::size_t bytes,
+                   Body body) {
+        body();
+        auto begin = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            body();
+        }
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - begin;
+        double seconds = elapsed.count() / iterations;
+        if (bytes != 0) {
+            std::printf("  %-40s %12.1f ns/op %8.2f GB/s\n",
+                        label,
+                        seconds * 1e9,
+                        bytes / seconds / 1e9);
+        } else {
+            std::printf("  %-40s %12.1f ns/op\n",
+                        label,
+                        seconds * 1e9);
+        }
+        return seconds;
+    }
+}
+
+/*! Define and register a benchmark. */
+#define BENCHMARK(group, name)                                  \
+    static void bench_##group##_##name();                       \
+    static bench::Registration bench_registration_##group##_##name( \
+        #group, #name, bench_##group##_##name);                 \
+    static void bench_##group##_##name()
+
+#endif
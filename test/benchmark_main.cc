@@ -0,0 +1,41 @@
+#include "benchmark.hh"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+    struct Entry {
+        const char*     group;
+        const char*     name;
+        bench::function body;
+    };
+
+    std::vector<Entry>& registry() {
+        static std::vector<Entry> entries;
+        return entries;
+    }
+}
+
+bench::Registration::Registration(const char* group,
+                                  const char* name,
+                                  function body) {
+    registry().push_back(Entry { group, name, body });
+}
+
+/*
+ * Usage: optparse_bench [GROUP]...
+ * Run all benchmarks, or only the ones of the groups passed.
+ */
+int main(int argc, char** argv) {
+    for (auto& entry : registry()) {
+        bool selected = argc == 1;
+        for (int i = 1; i < argc && !selected; ++i) {
+            selected = std::strcmp(argv[i], entry.group) == 0;
+        }
+        if (selected) {
+            std::printf("%s.%s\n", entry.group, entry.name);
+            entry.body();
+        }
+    }
+    return 0;
+}
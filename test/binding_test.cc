@@ -0,0 +1,53 @@
+#include "../src/liboptparse/binding.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <string>
+
+TEST_GROUP(Binding) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A valid text for each supported type
+ * WHEN convert it
+ * THEN the destination gets the value.
+ */
+TEST(Binding, Test_01) {
+    bool flag = false;
+    int number = 0;
+    unsigned long size = 0;
+    double ratio = 0;
+    std::string text;
+    CHECK_TRUE(_LIBOPTPARSE_::convert_value("true", flag));
+    CHECK_TRUE(_LIBOPTPARSE_::convert_value("-42", number));
+    CHECK_TRUE(_LIBOPTPARSE_::convert_value("4096", size));
+    CHECK_TRUE(_LIBOPTPARSE_::convert_value("0.5", ratio));
+    CHECK_TRUE(_LIBOPTPARSE_::convert_value("out.txt", text));
+    CHECK_TRUE(flag);
+    CHECK_EQUAL(-42, number);
+    CHECK_EQUAL(4096ul, size);
+    CHECK_EQUAL(0.5, ratio);
+    CHECK_EQUAL(std::string("out.txt"), text);
+}
+
+/**
+ * HAVE A text not valid for the destination type
+ * WHEN convert it
+ * THEN conversion fails and the destination is untouched.
+ */
+TEST(Binding, Test_02) {
+    bool flag = false;
+    int number = 7;
+    unsigned short port = 80;
+    CHECK_FALSE(_LIBOPTPARSE_::convert_value("yes", flag));
+    CHECK_FALSE(_LIBOPTPARSE_::convert_value("12abc", number));
+    CHECK_FALSE(_LIBOPTPARSE_::convert_value("", number));
+    CHECK_FALSE(_LIBOPTPARSE_::convert_value("70000", port));
+    CHECK_FALSE(flag);
+    CHECK_EQUAL(7, number);
+    CHECK_EQUAL(80, port);
+}
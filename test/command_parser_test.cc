@@ -0,0 +1,106 @@
+#include "../src/liboptparse/command_parser.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace {
+    /* Command parser with "add" and "commit", counting the builds. */
+    void make_commands(CommandParser& parser, int& builds) {
+        parser.get_global_parser().add('v', "verbose").set_type(flag);
+        parser.add("add", [&builds](OptionParser& add) {
+                ++builds;
+                add.add('f', "force").set_type(flag);
+            });
+        parser.add("commit", [&builds](OptionParser& commit) {
+                ++builds;
+                commit.add('m', "message");
+            });
+    }
+}
+
+TEST_GROUP(CommandParser) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A command parser with subcommands
+ * WHEN parse a command line with global and subcommand options
+ * THEN only the parser of the subcommand used is built.
+ */
+TEST(CommandParser, Test_01) {
+    CommandParser parser;
+    int builds = 0;
+    make_commands(parser, builds);
+    CHECK_EQUAL(2, parser.size());
+    CHECK_EQUAL(0, builds);
+    const char* argv[] = { "prog", "-v", "commit", "-m", "fix", "-v" };
+    CommandResult result = parser.try_parse(6, argv);
+    CHECK_FALSE(result.is_ok());
+    CHECK_EQUAL(unknown_short_option, result.get_error().type);
+    CHECK_EQUAL(5, result.get_error().index);
+    CommandResult ok = parser.try_parse(5, argv);
+    CHECK_TRUE(ok.is_ok());
+    CHECK_TRUE(ok.get_command() == "commit");
+    CHECK_TRUE((bool) *ok.get_global_options() -> at("verbose"));
+    CHECK_EQUAL("fix", (std::string) *ok.get_options() -> at('m'));
+    CHECK_EQUAL(1, builds);
+    CHECK_TRUE(parser.is_built("commit"));
+    CHECK_FALSE(parser.is_built("add"));
+}
+
+/**
+ * HAVE A command parser with subcommands
+ * WHEN parse an unknown subcommand or no subcommand
+ * THEN the first is an unknown_command error, the second has no
+ *      subcommand.
+ */
+TEST(CommandParser, Test_02) {
+    CommandParser parser;
+    int builds = 0;
+    make_commands(parser, builds);
+    const char* argv[] = { "prog", "-v", "push" };
+    CommandResult unknown = parser.try_parse(3, argv);
+    CHECK_FALSE(unknown.is_ok());
+    CHECK_EQUAL(unknown_command, unknown.get_error().type);
+    CHECK_EQUAL(2, unknown.get_error().index);
+    CommandResult none = parser.try_parse(2, argv);
+    CHECK_TRUE(none.is_ok());
+    CHECK_TRUE(none.get_command().empty());
+    CHECK_TRUE(none.get_options() == NULL);
+    CHECK_EQUAL(0, builds);
+    CHECK_TRUE(parser.find("push") == NULL);
+}
+
+/**
+ * HAVE A command parser with many subcommands
+ * WHEN add a repeated name and find each subcommand
+ * THEN the repeated name is rejected and each one is found.
+ */
+TEST(CommandParser, Test_03) {
+    CommandParser parser;
+    for (int i = 0; i < 100; ++i) {
+        parser.add("cmd" + std::to_string(i), [i](OptionParser& sub) {
+                sub.add("ident").set_default_value(std::to_string(i));
+            });
+    }
+    bool thrown = false;
+    try {
+        parser.add("cmd42", [](OptionParser&) { });
+    } catch (std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK_TRUE(thrown);
+    CHECK_EQUAL(100, parser.size());
+    for (int i = 0; i < 100; ++i) {
+        OptionParser* sub = parser.find("cmd" + std::to_string(i));
+        CHECK_TRUE(sub != NULL);
+        const char* argv[] = { "cmd" };
+        CHECK_EQUAL(std::to_string(i),
+                    (std::string) *sub -> parse(1, argv) -> at("ident"));
+    }
+}
@@ -0,0 +1,62 @@
+#include "../src/liboptparse/command_parser.hh"
+#include "benchmark.hh"
+#include <string>
+#include <vector>
+
+namespace {
+    const int COMMANDS = 100;
+    const int OPTIONS = 20;
+
+    /* Options of a typical subcommand: "opta", "optb"... */
+    void add_options(OptionParser& parser) {
+        for (int i = 0; i < OPTIONS; ++i) {
+            parser.add(std::string("opt") + char('a' + i))
+                .set_default_value("0");
+        }
+        parser.add('f', "force").set_type(flag);
+    }
+}
+
+/*
+ * Startup of a program with 100 subcommands: build every parser up
+ * front, or register factories and build only the one used.
+ */
+BENCHMARK(Commands, startup) {
+    std::vector<std::string> names;
+    for (int i = 0; i < COMMANDS; ++i) {
+        names.push_back("command-" + std::to_string(i));
+    }
+    const char* argv[] = { "prog", "command-42", "--optd", "7" };
+    bench::measure("eager: build 100 parsers", 200, 0, [&]() {
+            std::vector<OptionParser> parsers(COMMANDS);
+            for (auto& parser : parsers) {
+                add_options(parser);
+            }
+            bench::keep(parsers[42].parse(4 - 1, argv + 1));
+        });
+    bench::measure("lazy: register 100 factories", 200, 0, [&]() {
+            CommandParser parser;
+            for (auto& name : names) {
+                parser.add(name, add_options);
+            }
+            bench::keep(parser.try_parse(4, argv));
+        });
+}
+
+/* Dispatch of the subcommand name through the hash table. */
+BENCHMARK(Commands, dispatch) {
+    CommandParser parser;
+    std::vector<std::string> names;
+    for (int i = 0; i < COMMANDS; ++i) {
+        names.push_back("command-" + std::to_string(i));
+        parser.add(names.back(), add_options);
+    }
+    for (auto& name : names) {
+        parser.find(name);
+    }
+    std::size_t next = 0;
+    bench::measure("find a built subcommand", 1000000, 0, [&]() {
+            bench::keep(parser.find(names[next]));
+            next = (next + 1) % COMMANDS;
+        });
+}
@@ -0,0 +1,68 @@
+#include "../src/liboptparse/compiled_parser.hh"
+#include "../src/liboptparse/parser.hh"
+#include "benchmark.hh"
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+    /* Long names are letters only: write the number in base 26. */
+    std::string option_name(int i) {
+        std::string name = "opt";
+        for (int digit = 0; digit < 4; ++digit, i /= 26) {
+            name += static_cast<char>('a' + i % 26);
+        }
+        return name;
+    }
+
+    void add_options(OptionParser& parser,
+                     const std::vector<std::string>& names) {
+        for (const std::string& name : names) {
+            parser.add(name)
+                .set_default_value("0")
+                .set_help("help text of the option " + name);
+        }
+    }
+}
+
+/*
+ * Startup of a tool with 5k options, up to its first parse: adding
+ * the options at runtime, or opening their compiled image embedded
+ * in memory or mapped from a file.
+ */
+BENCHMARK(CompiledParser, startup_5k_options) {
+    const int count = 5000;
+    std::vector<std::string> names;
+    for (int i = 0; i < count; ++i) {
+        names.push_back(option_name(i));
+    }
+    const char* argv[] = { "prog", "--optbaaa=1", "file" };
+    bench::measure("runtime registration", 20, 0, [&]() {
+            OptionParser parser;
+            add_options(parser, names);
+            bench::keep(parser.try_parse(3, argv).is_ok());
+        });
+    OptionParser parser;
+    add_options(parser, names);
+    std::vector<std::uint64_t> image(CompiledParser::image_size(parser) / 8);
+    CompiledParser::write_image(parser, image.data());
+    bench::measure("compiled image in memory", 20, 0, [&]() {
+            CompiledParser compiled(image.data(), image.size() * 8);
+            bench::keep(compiled.try_parse(3, argv).is_ok());
+        });
+    bench::measure("compiled image in memory, open only", 20, 0, [&]() {
+            CompiledParser compiled(image.data(), image.size() * 8);
+            bench::keep(compiled.find("optbaaa"));
+        });
+    char path[] = "/tmp/optparse_benchXXXXXX";
+    close(mkstemp(path));
+    CompiledParser::save(parser, path);
+    bench::measure("compiled image mapped from file", 20, 0, [&]() {
+            CompiledParser compiled{std::string(path)};
+            bench::keep(compiled.try_parse(3, argv).is_ok());
+        });
+    unlink(path);
+}
@@ -0,0 +1,209 @@
+#include "../src/liboptparse/compiled_parser.hh"
+#include "../src/liboptparse/parser.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+    void add_options(OptionParser& parser) {
+        parser.add('t', "threads")
+            .set_default_value("1")
+            .set_help("number of threads")
+            .set_metavar("N")
+            .set_env_name("TOOL_THREADS");
+        parser.add('v', "verbose").set_type(flag);
+        parser.add("output").set_default_value("a.out");
+        parser.add('q');
+    }
+}
+
+TEST_GROUP(CompiledParser) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A parser compiled into an image in memory
+ * WHEN open the image
+ * THEN attributes and ids of the options are the same.
+ */
+TEST(CompiledParser, Test_01) {
+    OptionParser parser;
+    add_options(parser);
+    std::vector<std::uint64_t> image(CompiledParser::image_size(parser) / 8);
+    CompiledParser::write_image(parser, image.data());
+    CompiledParser compiled(image.data(), image.size() * 8);
+    CHECK_EQUAL(4, (int) compiled.size());
+    CHECK_EQUAL(0, (int) compiled.find('t'));
+    CHECK_EQUAL(0, (int) compiled.find("threads"));
+    CHECK_EQUAL(2, (int) compiled.find("output"));
+    CHECK_EQUAL(3, (int) compiled.find('q'));
+    CHECK_EQUAL(NO_OPTION_ID, compiled.find("quiet"));
+    CHECK_EQUAL(NO_OPTION_ID, compiled.find('o'));
+    CHECK_EQUAL(std::string("number of threads"),
+                std::string(compiled.get_help(0)));
+    CHECK_EQUAL(std::string("N"), std::string(compiled.get_metavar(0)));
+    CHECK_EQUAL(std::string("TOOL_THREADS"),
+                std::string(compiled.get_env_name(0)));
+    CHECK_EQUAL(std::string("a.out"),
+                std::string(compiled.get_default_value(2)));
+    CHECK_EQUAL(flag, compiled.get_type(1));
+    CHECK_EQUAL('\0', compiled.get_short_name(2));
+    CHECK_TRUE(compiled.get_long_name(3).empty());
+}
+
+/**
+ * HAVE A parser saved into a file
+ * WHEN parse with the parser mapping the file
+ * THEN options are the same of the original parser, fingerprint
+ *      included, and they outlive the compiled parser.
+ */
+TEST(CompiledParser, Test_02) {
+    OptionParser parser;
+    add_options(parser);
+    char path[] = "/tmp/optparse_testXXXXXX";
+    close(mkstemp(path));
+    CompiledParser::save(parser, path);
+    const char* argv[] = { "prg", "-v", "--threads=4", "--output=b.out",
+                           "file" };
+    std::unique_ptr<const Options> options;
+    {
+        CompiledParser compiled{std::string(path)};
+        options = compiled.parse(5, argv);
+    }
+    unlink(path);
+    auto expected = parser.parse(5, argv);
+    CHECK_EQUAL(expected -> size(), options -> size());
+    for (option_id id = 0; id < options -> size(); ++id) {
+        CHECK_EQUAL(expected -> at_id(id) -> get_value(),
+                    options -> at_id(id) -> get_value());
+        CHECK_EQUAL(expected -> is_set(id), options -> is_set(id));
+    }
+    CHECK_TRUE(expected -> get_fingerprint() ==
+               options -> get_fingerprint());
+    CHECK_EQUAL(std::string("4"), options -> at("threads") -> get_value());
+    CHECK_EQUAL(std::string("file"),
+                (*options -> arguments_cbegin()) -> get_value());
+    CHECK_EQUAL(std::string("prg"), options -> get_program_name());
+}
+
+/**
+ * HAVE A image
+ * WHEN open it truncated, corrupted or missing, and parse wrong
+ *      command lines
+ * THEN the image is rejected and errors are the ones of OptionParser.
+ */
+TEST(CompiledParser, Test_03) {
+    OptionParser parser;
+    add_options(parser);
+    std::vector<std::uint64_t> image(CompiledParser::image_size(parser) / 8);
+    CompiledParser::write_image(parser, image.data());
+    CHECK_THROWS(std::invalid_argument,
+                 CompiledParser(image.data(), image.size() * 8 - 8));
+    std::vector<std::uint64_t> corrupted(image);
+    corrupted[0] ^= 1;
+    CHECK_THROWS(std::invalid_argument,
+                 CompiledParser(corrupted.data(), corrupted.size() * 8));
+    CHECK_THROWS(std::invalid_argument,
+                 CompiledParser(std::string("/nonexistent/schema")));
+    CompiledParser compiled(image.data(), image.size() * 8);
+    const char* argv[] = { "prg", "-x", "--threads" };
+    std::vector<ParseError> errors;
+    ParseResult result = compiled.try_parse(3, argv, errors);
+    CHECK_FALSE(result.is_ok());
+    CHECK_EQUAL(2, (int) errors.size());
+    CHECK_EQUAL(unknown_short_option, errors[0].type);
+    CHECK_EQUAL(missing_option_value, errors[1].type);
+    CHECK_THROWS(std::out_of_range, compiled.parse(3, argv));
+}
+
+/**
+ * HAVE A parser with an env prefix and response files enabled,
+ *      compiled into an image
+ * WHEN parse with variables set, declared and prefixed, and a
+ *      response file
+ * THEN the compiled parser gives the same options of the original
+ *      parser.
+ */
+TEST(CompiledParser, Test_04) {
+    OptionParser parser;
+    add_options(parser);
+    parser.set_env_prefix("OPTTEST_");
+    parser.set_response_files(ResponseFileLimits { 1024, 2 });
+    std::vector<std::uint64_t> image(CompiledParser::image_size(parser) / 8);
+    CompiledParser::write_image(parser, image.data());
+    CompiledParser compiled(image.data(), image.size() * 8);
+    char path[] = "/tmp/optparse_testXXXXXX";
+    int fd = mkstemp(path);
+    const std::string content = "-v file\n";
+    CHECK_EQUAL((long) content.size(),
+                (long) write(fd, content.data(), content.size()));
+    close(fd);
+    std::string response = std::string("@") + path;
+    const char* argv[] = { "prg", response.c_str() };
+    setenv("TOOL_THREADS", "6", 1);
+    setenv("OPTTEST_OUTPUT", "b.out", 1);
+    auto expected = parser.parse(2, argv);
+    auto options = compiled.parse(2, argv);
+    unsetenv("TOOL_THREADS");
+    unsetenv("OPTTEST_OUTPUT");
+    unlink(path);
+    CHECK_EQUAL(std::string("6"), options -> at("threads") -> get_value());
+    CHECK_EQUAL(std::string("b.out"), options -> at("output") -> get_value());
+    CHECK_TRUE((bool) *options -> at('v'));
+    CHECK_EQUAL(1, (int) std::distance(options -> arguments_cbegin(),
+                                       options -> arguments_cend()));
+    CHECK_TRUE(expected -> get_fingerprint() ==
+               options -> get_fingerprint());
+}
+
+/**
+ * HAVE A parser with an environment prefix, long names with upper
+ *      case chars and two long names differing only by case,
+ *      compiled into an image
+ * WHEN parse with the variables of the long names in upper case and
+ *      with flags set to a boolean and to a wrong value
+ * THEN options take the same values the parser gives, the
+ *      ambiguous ones keep their default and wrong flags are
+ *      invalid_option_value.
+ */
+TEST(CompiledParser, Test_05) {
+    OptionParser parser;
+    parser.set_env_prefix("OPTTEST_");
+    parser.add('o', "outputFile").set_default_value("a.out");
+    parser.add('m', "maxJobs").set_default_value("1");
+    parser.add('x', "maxjobs").set_default_value("2");
+    parser.add('v', "verbose").set_type(flag);
+    std::vector<std::uint64_t> image(CompiledParser::image_size(parser) / 8);
+    CompiledParser::write_image(parser, image.data());
+    CompiledParser compiled(image.data(), image.size() * 8);
+    const char* argv[] = { "prg" };
+    setenv("OPTTEST_OUTPUTFILE", "b.out", 1);
+    setenv("OPTTEST_MAXJOBS", "8", 1);
+    setenv("OPTTEST_VERBOSE", "1", 1);
+    auto expected = parser.parse(1, argv);
+    auto options = compiled.parse(1, argv);
+    setenv("OPTTEST_VERBOSE", "on", 1);
+    ParseResult wrong = compiled.try_parse(1, argv);
+    unsetenv("OPTTEST_OUTPUTFILE");
+    unsetenv("OPTTEST_MAXJOBS");
+    unsetenv("OPTTEST_VERBOSE");
+    CHECK_EQUAL(std::string("b.out"), options -> at('o') -> get_value());
+    CHECK_EQUAL(std::string("1"), options -> at('m') -> get_value());
+    CHECK_EQUAL(std::string("2"), options -> at('x') -> get_value());
+    CHECK_EQUAL(std::string("true"), options -> at('v') -> get_value());
+    CHECK_TRUE(expected -> get_fingerprint() ==
+               options -> get_fingerprint());
+    CHECK_EQUAL(invalid_option_value, wrong.get_error().type);
+    CHECK_EQUAL(-1, wrong.get_error().index);
+}
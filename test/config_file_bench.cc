@@ -0,0 +1,68 @@
+#include "../src/liboptparse/config_file.hh"
+#include "../src/liboptparse/parser.hh"
+#include "benchmark.hh"
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+    /* Long names are letters only: write the number in base 26. */
+    std::string key_name(int i) {
+        std::string name = "key";
+        for (int digit = 0; digit < 4; ++digit, i /= 26) {
+            name += static_cast<char>('a' + i % 26);
+        }
+        return name;
+    }
+}
+
+/*
+ * Load a config file of 10k keys: mapped and sliced in place, or
+ * read line by line through iostreams; then the whole parse of a
+ * short command line merging it.
+ */
+BENCHMARK(ConfigFile, load_10k_keys) {
+    const int keys = 10000;
+    char path[] = "/tmp/optparse_benchXXXXXX";
+    int fd = mkstemp(path);
+    std::string content;
+    OptionParser parser;
+    for (int i = 0; i < keys; ++i) {
+        std::string name = key_name(i);
+        content += name + " = value number " + std::to_string(i) + "\n";
+        parser.add(name);
+    }
+    if (write(fd, content.data(), content.size()) < 0) {
+        content.clear();
+    }
+    close(fd);
+    bench::measure("mmap, entries in place", 200, content.size(), [&]() {
+            ConfigFile config;
+            config.load(path);
+            bench::keep(config.size());
+        });
+    bench::measure("iostreams, entries copied", 200, content.size(),
+                   [&]() {
+            std::ifstream in(path);
+            std::vector<std::pair<std::string, std::string>> entries;
+            std::string line;
+            while (std::getline(in, line)) {
+                std::size_t equal = line.find('=');
+                entries.emplace_back(line.substr(0, equal - 1),
+                                     line.substr(equal + 2));
+            }
+            bench::keep(entries.size());
+        });
+    ConfigFile config;
+    config.load(path);
+    const char* argv[] = { "prog", "--keyaaaa=cli" };
+    bench::measure("parse merging the config", 200, content.size(),
+                   [&]() {
+            bench::keep(parser.try_parse(2, argv, config).is_ok());
+        });
+    unlink(path);
+}
@@ -0,0 +1,113 @@
+#include "../src/liboptparse/config_file.hh"
+#include "../src/liboptparse/parser.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstdlib>
+#include <string>
+
+#include <unistd.h>
+
+namespace {
+    /* Write a temporary file, removed by the destructor. */
+    struct TempFile {
+        std::string path;
+
+        explicit TempFile(const std::string& content) {
+            char name[] = "/tmp/optparse_testXXXXXX";
+            int fd = mkstemp(name);
+            CHECK_TRUE(fd >= 0);
+            CHECK_EQUAL((long) content.size(),
+                        (long) write(fd, content.data(), content.size()));
+            close(fd);
+            path = name;
+        }
+
+        ~TempFile() {
+            unlink(path.c_str());
+        }
+    };
+}
+
+TEST_GROUP(ConfigFile) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A config file with comments, blank lines and spaces
+ * WHEN load it
+ * THEN entries are the trimmed keys and values, with their lines.
+ */
+TEST(ConfigFile, Test_01) {
+    TempFile file("# settings\n\n  threads = 4\r\noutput=a b.txt  \n"
+                  "\tempty =\nlast=x=y");
+    ConfigFile config;
+    ParseError error = config.load(file.path);
+    CHECK_EQUAL(parse_ok, error.type);
+    CHECK_EQUAL(4, (int) config.size());
+    CHECK_EQUAL(std::string("threads"), std::string(config.data()[0].key));
+    CHECK_EQUAL(std::string("4"), std::string(config.data()[0].value));
+    CHECK_EQUAL(3, config.data()[0].line);
+    CHECK_EQUAL(std::string("a b.txt"),
+                std::string(config.data()[1].value));
+    CHECK_EQUAL(std::string("empty"), std::string(config.data()[2].key));
+    CHECK_TRUE(config.data()[2].value.empty());
+    CHECK_EQUAL(std::string("x=y"), std::string(config.data()[3].value));
+    CHECK_EQUAL(6, config.data()[3].line);
+}
+
+/**
+ * HAVE A config file with a line without '=' and a missing file
+ * WHEN load them
+ * THEN errors report the line and the file, leaving no entries.
+ */
+TEST(ConfigFile, Test_02) {
+    TempFile file("threads = 4\n\n  verbose\n");
+    ConfigFile config;
+    ParseError error = config.load(file.path);
+    CHECK_EQUAL(invalid_config_line, error.type);
+    CHECK_EQUAL(3, error.index);
+    CHECK_EQUAL(2, error.position);
+    CHECK_EQUAL(0, (int) config.size());
+    error = config.load(file.path + ".missing");
+    CHECK_EQUAL(unreadable_config_file, error.type);
+}
+
+/**
+ * HAVE A parser, a config file and an environment variable
+ * WHEN parse a command line with the config
+ * THEN command line overrides environment, which overrides config,
+ *      which overrides defaults; unknown keys are errors.
+ */
+TEST(ConfigFile, Test_03) {
+    TempFile file("threads = 2\nlevel = 1\noutput = cfg.txt\n"
+                  "verbose = true\nlevel = 5\n");
+    OptionParser parser;
+    parser.add('t', "threads");
+    parser.add('l', "level").set_env_name("OPTTEST_CONFIG_LEVEL");
+    parser.add('o', "output").set_default_value("a.out");
+    parser.add('v', "verbose").set_type(flag);
+    parser.add('m', "mode").set_default_value("fast");
+    ConfigFile config;
+    CHECK_EQUAL(parse_ok, config.load(file.path).type);
+    setenv("OPTTEST_CONFIG_LEVEL", "7", 1);
+    const char* argv[] = { "prg", "-t", "8" };
+    auto options = parser.parse(3, argv, config);
+    unsetenv("OPTTEST_CONFIG_LEVEL");
+    CHECK_EQUAL(std::string("8"), options -> at("threads") -> get_value());
+    CHECK_EQUAL(std::string("7"), options -> at("level") -> get_value());
+    CHECK_EQUAL(std::string("cfg.txt"),
+                options -> at("output") -> get_value());
+    CHECK_TRUE((bool) *options -> at("verbose"));
+    CHECK_EQUAL(std::string("fast"), options -> at("mode") -> get_value());
+
+    TempFile unknown("threads = 2\n# comment\nthread = 3\n");
+    CHECK_EQUAL(parse_ok, config.load(unknown.path).type);
+    ParseResult result = parser.try_parse(1, argv, config);
+    CHECK_EQUAL(unknown_config_key, result.get_error().type);
+    CHECK_EQUAL(3, result.get_error().index);
+    CHECK_THROWS(std::out_of_range, parser.parse(1, argv, config));
+}
@@ -0,0 +1,35 @@
+#include "../src/liboptparse/parser.hh"
+#include "benchmark.hh"
+#include <stdexcept>
+
+namespace {
+    void add_options(OptionParser& parser) {
+        parser.add('r', "reply");
+        parser.add('v', "verbose").set_type(OptionArgumentType::flag);
+    }
+}
+
+/*
+ * Reject a command line with an unknown long option through the
+ * throwing and the not throwing entry points. The valid command
+ * line is the baseline.
+ */
+BENCHMARK(Errors, reject_unknown_option) {
+    OptionParser parser;
+    add_options(parser);
+    const char *valid[] = { "program_name", "-v", "--reply=42" };
+    const char *invalid[] = { "program_name", "-v", "--answer=42" };
+    bench::measure("parse valid", 100000, 0, [&]() {
+            bench::keep(parser.parse(3, valid));
+        });
+    bench::measure("parse invalid (exception)", 100000, 0, [&]() {
+            try {
+                bench::keep(parser.parse(3, invalid));
+            } catch (const std::out_of_range& e) {
+                bench::keep(e);
+            }
+        });
+    bench::measure("try_parse invalid", 100000, 0, [&]() {
+            bench::keep(parser.try_parse(3, invalid));
+        });
+}
@@ -0,0 +1,65 @@
+#include "../src/liboptparse/parser.hh"
+#include "benchmark.hh"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    /* Number of allocations made by the program. */
+    std::size_t allocations = 0;
+
+    /* Handler counting the options, as a verbosity counter does. */
+    class CountingHandler : public ParseHandler {
+    public:
+        std::size_t options = 0;
+
+        void on_option(const OptionArgument&) override {
+            ++options;
+        }
+    };
+}
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    void* pointer = std::malloc(size != 0 ? size : 1);
+    if (pointer == NULL) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+/*
+ * Parse the same command line building Options and notifying
+ * events, counting the allocations of each parse.
+ */
+BENCHMARK(Events, parse_events) {
+    OptionParser parser;
+    parser.add('v', "verbose").set_type(OptionArgumentType::flag);
+    parser.add('r', "reply");
+    parser.add('o', "output");
+    const char *argv[] = { "program_name", "-vvv", "--reply=42",
+                           "-o", "out.txt", "file1", "file2" };
+    CountingHandler handler;
+    std::size_t before = allocations;
+    bench::keep(parser.parse(7, argv));
+    std::printf("  allocations by parse:        %zu\n",
+                allocations - before);
+    before = allocations;
+    bench::keep(parser.parse_events(7, argv, handler));
+    std::printf("  allocations by parse_events: %zu\n",
+                allocations - before);
+    bench::measure("parse", 100000, 0, [&]() {
+            bench::keep(parser.parse(7, argv));
+        });
+    bench::measure("parse_events", 100000, 0, [&]() {
+            bench::keep(parser.parse_events(7, argv, handler));
+        });
+}
@@ -0,0 +1,229 @@
+#include "../src/liboptparse/flat_options.hh"
+#include "../src/liboptparse/parser.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+    std::unique_ptr<const Options> parse_sample() {
+        OptionParser parser;
+        parser.add('t', "threads").set_default_value("1");
+        parser.add('o', "output").set_default_value("a.out");
+        parser.add('v', "verbose").set_type(flag);
+        parser.add('r', "ratio");
+        parser.add('q');
+        const char* argv[] = { "server", "-v", "--threads=8", "in.txt",
+                               "-r", "0.5", "last" };
+        return parser.parse(7, argv);
+    }
+}
+
+TEST_GROUP(FlatOptions) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A parsed options
+ * WHEN write their image and open it
+ * THEN values, names, typed values and arguments are the same.
+ */
+TEST(FlatOptions, Test_01) {
+    auto options = parse_sample();
+    std::vector<std::uint64_t> buffer(
+        FlatOptions::image_size(*options) / 8);
+    FlatOptions::write_image(*options, buffer.data());
+    FlatOptions flat(buffer.data(), buffer.size() * 8);
+    CHECK_EQUAL(options -> size(), flat.size());
+    CHECK_EQUAL(8, (int) *flat.at("threads"));
+    CHECK_EQUAL(8L, (long) *flat.at('t'));
+    CHECK_EQUAL(0.5, (double) *flat.at("ratio"));
+    CHECK_TRUE((bool) *flat.at('v'));
+    CHECK_EQUAL(std::string("a.out"), (std::string) *flat.at('o'));
+    CHECK_TRUE(flat.at('q') -> get_value().empty());
+    CHECK_TRUE(flat.is_set(flat.find_id("threads")));
+    CHECK_FALSE(flat.is_set(flat.find_id("output")));
+    CHECK_EQUAL(options -> find_id("ratio"), flat.find_id("ratio"));
+    CHECK_EQUAL(NO_OPTION_ID, flat.find_id("missing"));
+    CHECK_EQUAL(NO_OPTION_ID, flat.find_id('x'));
+    CHECK_EQUAL(2, (int) flat.arguments_size());
+    CHECK_EQUAL(std::string("in.txt"), std::string(flat.get_argument(0)));
+    CHECK_EQUAL(std::string("last"), std::string(flat.get_argument(1)));
+    CHECK_EQUAL(std::string("server"),
+                std::string(flat.get_program_name()));
+}
+
+/**
+ * HAVE A image written in shared memory before fork
+ * WHEN the child reads it and the image is moved by the parent
+ * THEN both read the same values: the image has no pointers.
+ */
+TEST(FlatOptions, Test_02) {
+    auto options = parse_sample();
+    std::size_t size = FlatOptions::image_size(*options);
+    void* shared = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    CHECK_TRUE(shared != MAP_FAILED);
+    FlatOptions::write_image(*options, shared);
+    mprotect(shared, size, PROT_READ);
+    pid_t child = fork();
+    if (child == 0) {
+        FlatOptions flat(shared, size);
+        _exit((int) *flat.at("threads") == 8 &&
+              flat.get_argument(1) == "last" ? 0 : 1);
+    }
+    int status = -1;
+    waitpid(child, &status, 0);
+    CHECK_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    std::vector<std::uint64_t> moved(size / 8);
+    std::memcpy(moved.data(), shared, size);
+    munmap(shared, size);
+    FlatOptions flat(moved.data(), size);
+    CHECK_EQUAL(std::string("a.out"),
+                std::string(flat.at("output") -> get_value()));
+}
+
+/**
+ * HAVE A image
+ * WHEN open it truncated or corrupted
+ * THEN the image is rejected.
+ */
+TEST(FlatOptions, Test_03) {
+    auto options = parse_sample();
+    std::vector<std::uint64_t> buffer(
+        FlatOptions::image_size(*options) / 8);
+    FlatOptions::write_image(*options, buffer.data());
+    CHECK_THROWS(std::invalid_argument,
+                 FlatOptions(buffer.data(), buffer.size() * 8 - 8));
+    CHECK_THROWS(std::invalid_argument, FlatOptions(buffer.data(), 16));
+    std::vector<std::uint64_t> corrupted(buffer);
+    corrupted[0] ^= 1;
+    CHECK_THROWS(std::invalid_argument,
+                 FlatOptions(corrupted.data(), corrupted.size() * 8));
+    corrupted = buffer;
+    /* Offset of the program name beyond the image. */
+    reinterpret_cast<std::uint32_t*>(corrupted.data())[8] = 1u << 30;
+    CHECK_THROWS(std::invalid_argument,
+                 FlatOptions(corrupted.data(), corrupted.size() * 8));
+}
+
+/**
+ * HAVE A parsed options with texts that are not whole numbers:
+ *      trailing chars, leading spaces or '+', exponents and words
+ * WHEN convert their values from the options and from their image
+ * THEN each typed value is the same.
+ */
+TEST(FlatOptions, Test_04) {
+    const char* texts[] = {
+        "42abc", " 7", "+5", "-3", "1e3", "2.5x", "abc", "", "true",
+        "1", "70000", "-1" };
+    const int size = sizeof(texts) / sizeof(texts[0]);
+    OptionParser parser;
+    std::vector<std::string> names;
+    for (int i = 0; i < size; ++i) {
+        names.push_back("value" + std::string(1, 'a' + i));
+        parser.add(names.back()).set_default_value(texts[i]);
+    }
+    const char* argv[] = { "prg" };
+    auto options = parser.parse(1, argv);
+    std::vector<std::uint64_t> buffer(
+        FlatOptions::image_size(*options) / 8);
+    FlatOptions::write_image(*options, buffer.data());
+    FlatOptions flat(buffer.data(), buffer.size() * 8);
+    for (const std::string& name : names) {
+        auto value = options -> at(name);
+        FlatValue flat_value = *flat.at(name);
+        CHECK_EQUAL((bool) *value, (bool) flat_value);
+        CHECK_EQUAL((int) *value, (int) flat_value);
+        CHECK_EQUAL((short) *value, (short) flat_value);
+        CHECK_EQUAL((long) *value, (long) flat_value);
+        CHECK_EQUAL((unsigned short) *value, (unsigned short) flat_value);
+        CHECK_EQUAL((unsigned long) *value, (unsigned long) flat_value);
+        CHECK_EQUAL((unsigned int) *value, (unsigned int) flat_value);
+        CHECK_EQUAL((float) *value, (float) flat_value);
+        CHECK_EQUAL((double) *value, (double) flat_value);
+    }
+    CHECK_EQUAL(42, (int) *flat.at("valuea"));
+    CHECK_EQUAL(7, (int) *flat.at("valueb"));
+    CHECK_EQUAL(5, (int) *flat.at("valuec"));
+}
+
+/**
+ * HAVE A parsed options with a repeated option given twice
+ * WHEN write their image and open it
+ * THEN its values are read from the image in order and converted,
+ *      an option not repeated has none.
+ */
+TEST(FlatOptions, Test_05) {
+    OptionParser parser;
+    parser.add('I', "include").set_type(repeated);
+    parser.add('n', "number").set_type(repeated);
+    parser.add('t', "threads").set_default_value("1");
+    const char* argv[] = { "prg", "-I", "a", "-n", "4", "-I", "b",
+                           "--number=5" };
+    auto options = parser.parse(8, argv);
+    std::vector<std::uint64_t> buffer(
+        FlatOptions::image_size(*options) / 8);
+    FlatOptions::write_image(*options, buffer.data());
+    FlatOptions flat(buffer.data(), buffer.size() * 8);
+    FlatValueSpan includes = flat.get_values('I');
+    CHECK_EQUAL(2, (int) includes.size());
+    CHECK_EQUAL(std::string("a"), std::string(includes[0]));
+    CHECK_EQUAL(std::string("b"), std::string(includes[1]));
+    std::vector<int> numbers;
+    CHECK_TRUE(flat.get_values("number").convert(numbers));
+    CHECK_EQUAL(2, (int) numbers.size());
+    CHECK_EQUAL(4, numbers[0]);
+    CHECK_EQUAL(5, numbers[1]);
+    CHECK_TRUE(flat.get_values('t').empty());
+}
+
+/**
+ * HAVE A parsed options with texts read by the stream rules
+ * WHEN convert their values from the options and from their image
+ * THEN both give the values the standard input operator gives.
+ */
+TEST(FlatOptions, Test_06) {
+    OptionParser parser;
+    parser.add("trailing").set_default_value("42abc");
+    parser.add("plus").set_default_value(" +7");
+    parser.add("negative").set_default_value("-1");
+    parser.add("large").set_default_value("70000");
+    parser.add("exponent").set_default_value("1e3");
+    parser.add("empty").set_default_value("1e");
+    parser.add("boolean").set_default_value(" true");
+    const char* argv[] = { "prg" };
+    auto options = parser.parse(1, argv);
+    std::vector<std::uint64_t> buffer(
+        FlatOptions::image_size(*options) / 8);
+    FlatOptions::write_image(*options, buffer.data());
+    FlatOptions flat(buffer.data(), buffer.size() * 8);
+    CHECK_EQUAL(42, (int) *options -> at("trailing"));
+    CHECK_EQUAL(42, (int) *flat.at("trailing"));
+    CHECK_EQUAL(7L, (long) *options -> at("plus"));
+    CHECK_EQUAL(7L, (long) *flat.at("plus"));
+    CHECK_EQUAL(7.0, (double) *options -> at("plus"));
+    CHECK_EQUAL(7.0, (double) *flat.at("plus"));
+    CHECK_EQUAL(65535, (int) (unsigned short) *options -> at("negative"));
+    CHECK_EQUAL(65535, (int) (unsigned short) *flat.at("negative"));
+    CHECK_EQUAL(32767, (int) (short) *options -> at("large"));
+    CHECK_EQUAL(32767, (int) (short) *flat.at("large"));
+    CHECK_EQUAL(1, (int) *options -> at("exponent"));
+    CHECK_EQUAL(1, (int) *flat.at("exponent"));
+    CHECK_EQUAL(1000.0, (double) *options -> at("exponent"));
+    CHECK_EQUAL(1000.0, (double) *flat.at("exponent"));
+    CHECK_EQUAL(0.0, (double) *options -> at("empty"));
+    CHECK_EQUAL(0.0, (double) *flat.at("empty"));
+    CHECK_TRUE((bool) *options -> at("boolean"));
+    CHECK_TRUE((bool) *flat.at("boolean"));
+}
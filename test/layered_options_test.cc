@@ -0,0 +1,113 @@
+#include "../src/liboptparse/layered_options.hh"
+#include "../src/liboptparse/parser.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <memory>
+#include <string>
+
+namespace {
+    void add_options(OptionParser& parser) {
+        parser.add('t', "threads").set_default_value("1");
+        parser.add('o', "output").set_default_value("a.out");
+        parser.add('v', "verbose").set_type(flag);
+        parser.add('l', "level").set_default_value("0");
+    }
+}
+
+TEST_GROUP(LayeredOptions) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A parser
+ * WHEN parse a command line
+ * THEN only the options given are set, the others hold defaults.
+ */
+TEST(LayeredOptions, Test_01) {
+    OptionParser parser;
+    add_options(parser);
+    const char* argv[] = { "prg", "-v", "--level=3" };
+    auto options = parser.parse(3, argv);
+    CHECK_FALSE(options -> is_set(options -> find_id("threads")));
+    CHECK_FALSE(options -> is_set(options -> find_id('o')));
+    CHECK_TRUE(options -> is_set(options -> find_id('v')));
+    CHECK_TRUE(options -> is_set(options -> find_id("level")));
+    CHECK_EQUAL(NO_OPTION_ID, options -> find_id("missing"));
+}
+
+/**
+ * HAVE A base layer and layers parsed from other sources
+ * WHEN look up the options through the layered view
+ * THEN each value comes from the highest layer that set it, or from
+ *      the base.
+ */
+TEST(LayeredOptions, Test_02) {
+    OptionParser parser;
+    add_options(parser);
+    const char* site_argv[] = { "prg", "--threads=4", "--output=site" };
+    const char* env_argv[] = { "prg", "--threads=8" };
+    const char* cli_argv[] = { "prg", "-l", "2" };
+    LayeredOptions options(parser.parse(3, site_argv));
+    options.push(parser.parse(2, env_argv)).push(parser.parse(3, cli_argv));
+    CHECK_EQUAL(3, (int) options.layers());
+    CHECK_EQUAL(std::string("8"), options.at("threads") -> get_value());
+    CHECK_EQUAL(1, (int) options.find_layer(0));
+    CHECK_EQUAL(std::string("site"), options.at('o') -> get_value());
+    CHECK_EQUAL(0, (int) options.find_layer(1));
+    CHECK_EQUAL(std::string("2"), options.at("level") -> get_value());
+    CHECK_EQUAL(2, (int) options.find_layer(3));
+    CHECK_FALSE(options.is_set(2));
+    CHECK_FALSE((bool) *options.at('v'));
+}
+
+/**
+ * HAVE A base layer shared by two views
+ * WHEN push a different top layer on each view
+ * THEN views see their own top and the base is shared, not copied.
+ */
+TEST(LayeredOptions, Test_03) {
+    OptionParser parser;
+    add_options(parser);
+    const char* site_argv[] = { "prg", "--output=site" };
+    const char* first_argv[] = { "prg", "-t", "2" };
+    const char* second_argv[] = { "prg", "-v" };
+    std::shared_ptr<const Options> site(parser.parse(2, site_argv));
+    LayeredOptions first(site);
+    first.push(parser.parse(3, first_argv));
+    LayeredOptions second(site);
+    second.push(parser.parse(2, second_argv));
+    CHECK_EQUAL(3, (int) site.use_count());
+    CHECK_EQUAL(std::string("2"), first.at('t') -> get_value());
+    CHECK_EQUAL(std::string("1"), second.at('t') -> get_value());
+    CHECK_TRUE((bool) *second.at("verbose"));
+    CHECK_TRUE(first.at('o') == second.at('o'));
+}
+
+/**
+ * HAVE A base layer and a top layer both giving a repeated option
+ * WHEN get the values of the repeated options
+ * THEN the values come from the highest layer that set the option,
+ *      they are not merged with the ones below.
+ */
+TEST(LayeredOptions, Test_04) {
+    OptionParser parser;
+    add_options(parser);
+    parser.add('I', "include").set_type(repeated);
+    parser.add('D', "define").set_type(repeated);
+    const char* base_argv[] = { "prg", "-I", "x", "-D", "NDEBUG" };
+    const char* top_argv[] = { "prg", "-I", "a", "-I", "b" };
+    LayeredOptions options(parser.parse(5, base_argv));
+    options.push(parser.parse(5, top_argv));
+    ValueSpan includes = options.get_values('I');
+    CHECK_EQUAL(2, (int) includes.size());
+    CHECK_EQUAL(std::string("a"), std::string(includes[0]));
+    CHECK_EQUAL(std::string("b"), std::string(includes[1]));
+    ValueSpan defines = options.get_values("define");
+    CHECK_EQUAL(1, (int) defines.size());
+    CHECK_EQUAL(std::string("NDEBUG"), std::string(defines[0]));
+    CHECK_TRUE(options.get_values("threads").empty());
+}
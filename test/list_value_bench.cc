@@ -0,0 +1,76 @@
+#include "../src/liboptparse/list_value.hh"
+#include "benchmark.hh"
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+    /* Comma separated list of count integers of up to digits digits. */
+    std::string make_integers(std::size_t count, std::int64_t limit) {
+        std::string text;
+        std::uint64_t value = 88172645463325252ull;
+        for (std::size_t i = 0; i < count; ++i) {
+            value ^= value << 13;
+            value ^= value >> 7;
+            value ^= value << 17;
+            text += (i == 0 ? "" : ",") +
+                std::to_string(static_cast<std::int64_t>(value % limit));
+        }
+        return text;
+    }
+
+    /* Comma separated list of count doubles with 3 decimals. */
+    std::string make_doubles(std::size_t count) {
+        std::string text;
+        for (std::size_t i = 0; i < count; ++i) {
+            text += (i == 0 ? "" : ",") + std::to_string(i * 7 % 100000) +
+                "." + std::to_string(100 + i % 900);
+        }
+        return text;
+    }
+
+    /* Split with memchr and convert each item with std::from_chars. */
+    template<class T>
+    bool from_chars_loop(const std::string& text, std::vector<T>& values) {
+        const char* current = text.data();
+        const char* end = current + text.size();
+        while (current < end) {
+            const char* found = static_cast<const char*>(
+                std::memchr(current, ',', end - current));
+            const char* item_end = found != NULL ? found : end;
+            T value;
+            auto result = std::from_chars(current, item_end, value);
+            if (result.ec != std::errc() || result.ptr != item_end) {
+                return false;
+            }
+            values.push_back(value);
+            current = item_end + 1;
+        }
+        return true;
+    }
+
+    template<class T>
+    void compare(const char* name, const std::string& text) {
+        std::string label = std::string(name) + ", from_chars loop";
+        bench::measure(label.c_str(), 20, text.size(), [&]() {
+                std::vector<T> values;
+                bench::keep(from_chars_loop(text, values));
+            });
+        label = std::string(name) + ", ListValue";
+        bench::measure(label.c_str(), 20, text.size(), [&]() {
+                std::vector<T> values;
+                bench::keep(ListValue(text).convert(values));
+            });
+    }
+}
+
+/* Lists of a million ids as a single option value: throughput. */
+BENCHMARK(ListValue, million_items) {
+    const std::size_t count = 1000000;
+    compare<std::int64_t>("ids < 10^6", make_integers(count, 1000000));
+    compare<std::int64_t>("ids < 10^15",
+                          make_integers(count, 1000000000000000ll));
+    compare<double>("doubles", make_doubles(count));
+}
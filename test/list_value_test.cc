@@ -0,0 +1,99 @@
+#include "../src/liboptparse/list_value.hh"
+#include "../src/liboptparse/parser.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+TEST_GROUP(ListValue) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A parser with a list option
+ * WHEN parse a command line with a long list of integers
+ * THEN items are all converted in order, with their count, whatever
+ *      their number of digits and sign.
+ */
+TEST(ListValue, Test_01) {
+    OptionParser parser;
+    parser.add("ids");
+    std::string ids;
+    std::vector<std::int64_t> expected;
+    std::int64_t value = 1;
+    for (int i = 0; i < 2000; ++i) {
+        value = value * 7 % 1000000000000007ll;
+        expected.push_back(i % 3 == 1 ? -(value >> (i % 50)) : value);
+        ids += (i == 0 ? "" : ",") + std::to_string(expected.back());
+    }
+    std::string argument = "--ids=" + ids;
+    const char* argv[] = { "prg", argument.c_str() };
+    auto options = parser.parse(2, argv);
+    ListValue list = options -> at("ids") -> get_list();
+    CHECK_EQUAL(expected.size(), list.size());
+    std::vector<std::int64_t> converted;
+    CHECK_TRUE(list.convert(converted));
+    CHECK_TRUE(expected == converted);
+    std::vector<std::int64_t> limits;
+    CHECK_TRUE(ListValue("9223372036854775807;-9223372036854775808;"
+                         "00000000000000000000042;0", ';')
+               .convert(limits));
+    CHECK_EQUAL(4, (int) limits.size());
+    CHECK_TRUE(std::numeric_limits<std::int64_t>::max() == limits[0]);
+    CHECK_TRUE(std::numeric_limits<std::int64_t>::min() == limits[1]);
+    CHECK_EQUAL(42, (int) limits[2]);
+    CHECK_EQUAL(0, (int) ListValue("").size());
+    CHECK_TRUE(ListValue("").convert(limits));
+    CHECK_EQUAL(4, (int) limits.size());
+}
+
+/**
+ * HAVE A list of doubles, with decimals, exponents and signs
+ * WHEN convert it
+ * THEN each item is the double nearest to its text.
+ */
+TEST(ListValue, Test_02) {
+    const char* items[] = {
+        "0.1", "-2.5", "3", "12345678.87654321", "1e-5", "-0.0",
+        "6.02214076e23", "0.0000000000000000000000001", "inf",
+        "123456789012345678901234567890" };
+    std::string text;
+    for (const char* item : items) {
+        text += (text.empty() ? "" : "|") + std::string(item);
+    }
+    std::vector<double> converted;
+    CHECK_TRUE(ListValue(text, '|').convert(converted));
+    CHECK_EQUAL(10, (int) converted.size());
+    for (std::size_t i = 0; i < converted.size(); ++i) {
+        CHECK_TRUE(std::stod(items[i]) == converted[i]);
+    }
+    CHECK_TRUE(std::signbit(converted[5]));
+}
+
+/**
+ * HAVE A lists with items not valid
+ * WHEN convert them
+ * THEN conversion stops at the first one, keeping the items before.
+ */
+TEST(ListValue, Test_03) {
+    const char* wrong[] = {
+        "1,2,,4", "1,2,", "1, 2", "+1", "1,2a", "99999999999999999999",
+        "-", "9223372036854775808", "1.5" };
+    for (const char* text : wrong) {
+        std::vector<std::int64_t> converted;
+        CHECK_FALSE(ListValue(text).convert(converted));
+    }
+    std::vector<std::int64_t> converted;
+    CHECK_FALSE(ListValue("7,8,x,9").convert(converted));
+    CHECK_EQUAL(2, (int) converted.size());
+    std::vector<double> numbers;
+    CHECK_FALSE(ListValue("1.5,2.5e,3").convert(numbers));
+    CHECK_FALSE(ListValue("1.5,-,2").convert(numbers));
+}
@@ -359,3 +359,27 @@ TEST(OptionArgumentTest, Test_11) {
     OptionArgument option_arg2('a');
     CHECK_EQUAL(option_arg1 != option_arg2, false);
 }
+
+/**
+ * HAVE An option argument with only the long name
+ * WHEN check its names
+ * THEN it has no short name.
+ */
+TEST(OptionArgumentTest, Test_12) {
+    OptionArgument option_arg("reply");
+    CHECK_FALSE(option_arg.has_short_name());
+    CHECK_EQUAL(option_arg.get_long_name(), "reply");
+    CHECK_EQUAL(option_arg.get_id(), NO_OPTION_ID);
+}
+
+/**
+ * HAVE Two option arguments with only the long name
+ * WHEN compare them
+ * THEN they are equals only if long names are equals.
+ */
+TEST(OptionArgumentTest, Test_13) {
+    OptionArgument reply("reply");
+    OptionArgument answer("answer");
+    CHECK_EQUAL(reply != answer, true);
+    CHECK_EQUAL(reply == OptionArgument("reply"), true);
+}
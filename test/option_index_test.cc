@@ -0,0 +1,70 @@
+#include "../src/liboptparse/option_index.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+TEST_GROUP(OptionIndex) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A new index
+ * WHEN add options
+ * THEN they are found by short and long names.
+ */
+TEST(OptionIndex, Test_01) {
+    _LIBOPTPARSE_::HashOptionIndex index;
+    option_id r = index.add('r', "reply");
+    option_id v = index.add('\0', "verbose");
+    CHECK_EQUAL((option_id)0, r);
+    CHECK_EQUAL((option_id)1, v);
+    CHECK_EQUAL(r, index.find('r'));
+    CHECK_EQUAL(r, index.find(std::string_view("reply")));
+    CHECK_EQUAL(v, index.find(std::string_view("verbose")));
+    CHECK_EQUAL((std::size_t)2, index.size());
+}
+
+/**
+ * HAVE A new index
+ * WHEN look for names not added
+ * THEN NO_OPTION_ID is returned.
+ */
+TEST(OptionIndex, Test_02) {
+    _LIBOPTPARSE_::HashOptionIndex index;
+    index.add('\0', "verbose");
+    CHECK_EQUAL(NO_OPTION_ID, index.find('\0'));
+    CHECK_EQUAL(NO_OPTION_ID, index.find('v'));
+    CHECK_EQUAL(NO_OPTION_ID, index.find(std::string_view("reply")));
+}
+
+/**
+ * HAVE A index with long names with upper case chars and two long
+ *      names differing only by case
+ * WHEN look for long names in upper case, also in a copy
+ * THEN names are found but the ambiguous ones and the names with
+ *      lower case chars.
+ */
+TEST(OptionIndex, Test_03) {
+    _LIBOPTPARSE_::HashOptionIndex index;
+    option_id output = index.add('o', "outputFile");
+    index.add('m', "maxJobs");
+    index.add('x', "maxjobs");
+    option_id dry = index.add('n', "dry-run");
+    _LIBOPTPARSE_::HashOptionIndex copy(index);
+    for (const _LIBOPTPARSE_::OptionIndex* found : {
+             static_cast<const _LIBOPTPARSE_::OptionIndex*>(&index),
+             static_cast<const _LIBOPTPARSE_::OptionIndex*>(&copy) }) {
+        CHECK_EQUAL(output, found -> find_upper_case("OUTPUTFILE"));
+        CHECK_EQUAL(dry, found -> find_upper_case("DRY-RUN"));
+        CHECK_EQUAL(NO_OPTION_ID, found -> find_upper_case("MAXJOBS"));
+        CHECK_EQUAL(NO_OPTION_ID, found -> find_upper_case("outputFile"));
+        CHECK_EQUAL(NO_OPTION_ID, found -> find_upper_case("OUTPUT"));
+        CHECK_EQUAL(NO_OPTION_ID, found -> find_upper_case(""));
+        CHECK_EQUAL(output,
+                    found -> OptionIndex::find_upper_case("OUTPUTFILE"));
+        CHECK_EQUAL(NO_OPTION_ID,
+                    found -> OptionIndex::find_upper_case("MAXJOBS"));
+    }
+}
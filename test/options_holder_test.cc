@@ -0,0 +1,143 @@
+#include "../src/liboptparse/options_holder.hh"
+#include "../src/liboptparse/parser.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+    /* Options whose two values are both the generation passed. */
+    std::unique_ptr<const Options> generation(OptionParser& parser,
+                                              int number) {
+        std::string first = "--first=" + std::to_string(number);
+        std::string second = "--second=" + std::to_string(number);
+        const char* argv[] = { "prg", first.c_str(), second.c_str() };
+        return parser.parse(3, argv);
+    }
+}
+
+TEST_GROUP(OptionsHolder) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A holder with a reader
+ * WHEN publish new options while a snapshot is alive
+ * THEN the snapshot keeps the old options, which are deleted once it
+ *      is destroyed, and next reads get the new ones.
+ */
+TEST(OptionsHolder, Test_01) {
+    OptionParser parser;
+    parser.add("first");
+    parser.add("second");
+    OptionsHolder holder(generation(parser, 0), 2);
+    OptionsHolder::Reader reader = holder.make_reader();
+    {
+        OptionsHolder::Snapshot snapshot = reader.read();
+        holder.publish(generation(parser, 1));
+        CHECK_EQUAL(1, (int) holder.reclaim());
+        CHECK_EQUAL(std::string("0"), snapshot -> at("first") -> get_value());
+    }
+    CHECK_EQUAL(0, (int) holder.reclaim());
+    OptionsHolder::Snapshot snapshot = reader.read();
+    CHECK_EQUAL(std::string("1"), (*snapshot).at("second") -> get_value());
+    OptionsHolder::Reader other = holder.make_reader();
+    CHECK_THROWS(std::length_error, holder.make_reader());
+}
+
+/**
+ * HAVE A holder and a config file
+ * WHEN reload it with a valid and with a wrong config
+ * THEN options are replaced only by the valid one.
+ */
+TEST(OptionsHolder, Test_02) {
+    OptionParser parser;
+    parser.add("first");
+    parser.add("second");
+    char path[] = "/tmp/optparse_testXXXXXX";
+    int fd = mkstemp(path);
+    const std::string content = "first = 5\nsecond = 6\n";
+    CHECK_EQUAL((long) content.size(),
+                (long) write(fd, content.data(), content.size()));
+    close(fd);
+    OptionsHolder holder(generation(parser, 0));
+    OptionsHolder::Reader reader = holder.make_reader();
+    const char* argv[] = { "prg", "--second=7" };
+    CHECK_EQUAL(parse_ok, holder.reload(parser, 2, argv, path).type);
+    {
+        OptionsHolder::Snapshot snapshot = reader.read();
+        CHECK_EQUAL(std::string("5"),
+                    snapshot -> at("first") -> get_value());
+        CHECK_EQUAL(std::string("7"),
+                    snapshot -> at("second") -> get_value());
+    }
+    const char* wrong[] = { "prg", "--third" };
+    CHECK_EQUAL(unknown_long_option,
+                holder.reload(parser, 2, wrong, path).type);
+    unlink(path);
+    CHECK_EQUAL(unreadable_config_file,
+                holder.reload(parser, 2, argv, path).type);
+    OptionsHolder::Snapshot snapshot = reader.read();
+    CHECK_EQUAL(std::string("5"), snapshot -> at("first") -> get_value());
+}
+
+/**
+ * HAVE A holder read by several threads
+ * WHEN a thread publishes new options while the others read
+ * THEN each snapshot read is consistent and generations never go
+ *      back for a reader; old snapshots are all reclaimed at the end.
+ */
+TEST(OptionsHolder, Test_03) {
+    OptionParser parser;
+    parser.add("first");
+    parser.add("second");
+    const int readers = 4;
+    const int generations = 2000;
+    OptionsHolder holder(generation(parser, 0), readers);
+    std::atomic<bool> done(false);
+    std::atomic<int> failures(0);
+    std::atomic<long> reads(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < readers; ++i) {
+        threads.emplace_back([&holder, &done, &failures, &reads]() {
+            OptionsHolder::Reader reader = holder.make_reader();
+            int last = 0;
+            long count = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                OptionsHolder::Snapshot options = reader.read();
+                int first = std::stoi(options -> at("first") -> get_value());
+                int second =
+                    std::stoi(options -> at("second") -> get_value());
+                if (first != second || first < last) {
+                    ++failures;
+                }
+                last = first;
+                ++count;
+            }
+            reads += count;
+        });
+    }
+    for (int i = 1; i <= generations; ++i) {
+        holder.publish(generation(parser, i));
+    }
+    done = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK_EQUAL(0, failures.load());
+    CHECK_TRUE(reads.load() > 0);
+    CHECK_EQUAL(0, (int) holder.reclaim());
+    OptionsHolder::Reader reader = holder.make_reader();
+    CHECK_EQUAL(std::string("2000"),
+                reader.read() -> at("first") -> get_value());
+}
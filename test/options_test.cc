@@ -43,3 +43,46 @@ TEST(Options, Test_02) {
                     container.cend());
     CHECK_TRUE(options['r'] == opt_value);
 }
+
+/**
+ * HAVE A new option object from an existing map
+ * WHEN iterate over its options
+ * THEN pairs are the same of the map.
+ */
+TEST(Options, Test_03) {
+    ProgramInfo program_info("program_info");
+    Options::options_container container;
+    container['r'] = Options::value_type(new OptionArgumentValue("42"));
+    container['a'] = Options::value_type(new OptionArgumentValue("1"));
+    Options options(program_info,
+                    container.cbegin(),
+                    container.cend());
+    auto expected = container.cbegin();
+    for (auto itr = options.options_cbegin();
+         itr != options.options_cend();
+         ++itr, ++expected) {
+        CHECK_EQUAL(expected -> first, itr -> first);
+        CHECK_TRUE(expected -> second == itr -> second);
+    }
+    CHECK_TRUE(expected == container.cend());
+}
+
+/**
+ * HAVE A new option object from an existing map
+ * WHEN gets values by id
+ * THEN ids follow the short names order.
+ */
+TEST(Options, Test_04) {
+    ProgramInfo program_info("program_info");
+    Options::options_container container;
+    Options::value_type r(new OptionArgumentValue("42"));
+    Options::value_type a(new OptionArgumentValue("1"));
+    container['r'] = r;
+    container['a'] = a;
+    Options options(program_info,
+                    container.cbegin(),
+                    container.cend());
+    CHECK_EQUAL((std::size_t)2, options.size());
+    CHECK_TRUE(options.at_id(0) == a);
+    CHECK_TRUE(options.at_id(1) == r);
+}
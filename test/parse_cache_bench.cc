@@ -0,0 +1,72 @@
+#include "../src/liboptparse/parse_cache.hh"
+#include "../src/liboptparse/parser.hh"
+#include "benchmark.hh"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+    /* Command lines of a service: count distinct ones, 12 arguments. */
+    std::vector<std::vector<std::string> > command_lines(int count) {
+        std::vector<std::vector<std::string> > lines(count);
+        for (int i = 0; i < count; ++i) {
+            lines[i] = { "service", "-v", "--threads=" + std::to_string(i),
+                         "--output=/var/log/service.log", "--retries=3",
+                         "--timeout=30", "input-a", "input-b", "input-c",
+                         "input-d", "input-e", "input-f" };
+        }
+        return lines;
+    }
+
+    std::vector<const char*> pointers(const std::vector<std::string>& line) {
+        std::vector<const char*> argv;
+        for (const std::string& argument : line) {
+            argv.push_back(argument.c_str());
+        }
+        return argv;
+    }
+}
+
+/*
+ * A service parsing 256 distinct command lines over and over: plain
+ * parses, cache hits and cache misses, with a cache too small to
+ * hold them all.
+ */
+BENCHMARK(ParseCache, hit_and_miss) {
+    const int count = 256;
+    OptionParser parser;
+    parser.add('v', "verbose").set_type(flag);
+    parser.add('t', "threads");
+    parser.add('o', "output");
+    parser.add('r', "retries");
+    parser.add("timeout");
+    std::vector<std::vector<std::string> > lines = command_lines(count);
+    std::vector<std::vector<const char*> > argvs;
+    for (const auto& line : lines) {
+        argvs.push_back(pointers(line));
+    }
+    const int argc = static_cast<int>(argvs[0].size());
+    bench::measure("no cache, 256 parses", 200, 0, [&]() {
+            for (auto& argv : argvs) {
+                bench::keep(parser.try_parse(argc, argv.data()).is_ok());
+            }
+        });
+    ParseCache hits(4 * count);
+    bench::measure("cache hits, 256 parses", 200, 0, [&]() {
+            for (auto& argv : argvs) {
+                bench::keep(hits.parse(parser, argc, argv.data()));
+            }
+        });
+    ParseCache misses(count / 2);
+    bench::measure("cache misses, 256 parses", 200, 0, [&]() {
+            for (auto& argv : argvs) {
+                bench::keep(misses.parse(parser, argc, argv.data()));
+            }
+        });
+    ParseCacheStats stats = hits.get_stats();
+    std::printf("  hit rate %.3f, %zu entries, %zu bytes\n",
+                stats.hit_rate(), stats.entries, stats.bytes);
+    stats = misses.get_stats();
+    std::printf("  hit rate %.3f, %zu entries, %zu bytes\n",
+                stats.hit_rate(), stats.entries, stats.bytes);
+}
@@ -0,0 +1,194 @@
+#include "../src/liboptparse/parse_cache.hh"
+#include "../src/liboptparse/parser.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+TEST_GROUP(ParseCache) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A cache and a parser
+ * WHEN parse the same command line twice and an other one once
+ * THEN the second parse shares the options of the first, the other
+ *      one gets its own, and stats count two misses and a hit.
+ */
+TEST(ParseCache, Test_01) {
+    OptionParser parser;
+    parser.add('t', "threads");
+    parser.add('v', "verbose").set_type(flag);
+    ParseCache cache(64);
+    const char* argv[] = { "prg", "-v", "--threads=4", "file" };
+    const char* other[] = { "prg", "-v", "--threads=44", "file" };
+    std::shared_ptr<const Options> first = cache.parse(parser, 4, argv);
+    std::shared_ptr<const Options> second = cache.parse(parser, 4, argv);
+    std::shared_ptr<const Options> third = cache.parse(parser, 4, other);
+    CHECK_TRUE(first != NULL);
+    CHECK_TRUE(first == second);
+    CHECK_TRUE(third != first);
+    CHECK_EQUAL(std::string("4"), second -> at("threads") -> get_value());
+    CHECK_EQUAL(std::string("44"), third -> at("threads") -> get_value());
+    ParseCacheStats stats = cache.get_stats();
+    CHECK_EQUAL(1, (int) stats.hits);
+    CHECK_EQUAL(2, (int) stats.misses);
+    CHECK_EQUAL(2, (int) stats.entries);
+    CHECK_TRUE(stats.bytes > 0);
+    DOUBLES_EQUAL(1.0 / 3, stats.hit_rate(), 1e-9);
+    cache.clear();
+    CHECK_EQUAL(0, (int) cache.get_stats().entries);
+    CHECK_EQUAL(0, (int) cache.get_stats().bytes);
+}
+
+/**
+ * HAVE A cache of one shard holding two command lines
+ * WHEN parse three different ones, reusing the first in between
+ * THEN the least recently used one is evicted and parsed again.
+ */
+TEST(ParseCache, Test_02) {
+    OptionParser parser;
+    parser.add('t', "threads");
+    ParseCache cache(2, 1);
+    const char* one[] = { "prg", "--threads=1" };
+    const char* two[] = { "prg", "--threads=2" };
+    const char* three[] = { "prg", "--threads=3" };
+    std::shared_ptr<const Options> first = cache.parse(parser, 2, one);
+    cache.parse(parser, 2, two);
+    CHECK_TRUE(cache.parse(parser, 2, one) == first);
+    cache.parse(parser, 2, three);
+    ParseCacheStats stats = cache.get_stats();
+    CHECK_EQUAL(2, (int) stats.entries);
+    CHECK_EQUAL(1, (int) stats.evictions);
+    CHECK_TRUE(cache.parse(parser, 2, one) == first);
+    cache.parse(parser, 2, two);
+    stats = cache.get_stats();
+    CHECK_EQUAL(2, (int) stats.hits);
+    CHECK_EQUAL(4, (int) stats.misses);
+    CHECK_EQUAL(2, (int) stats.evictions);
+}
+
+/**
+ * HAVE A cold cache used by several threads
+ * WHEN they parse the same few command lines, one of them wrong
+ * THEN all get the same options named by argv[0] for the same
+ *      command line, the wrong one reports its error each time and
+ *      is never cached.
+ */
+TEST(ParseCache, Test_03) {
+    OptionParser parser;
+    parser.add('t', "threads");
+    ParseCache cache(16, 4);
+    const int threads = 4;
+    const int rounds = 500;
+    std::vector<std::string> values = { "1", "2", "3" };
+    std::atomic<int> failures(0);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back([&]() {
+            for (int round = 0; round < rounds; ++round) {
+                std::size_t which = round % values.size();
+                std::string argument = "--threads=" + values[which];
+                const char* argv[] = { "prg", argument.c_str() };
+                std::shared_ptr<const Options> options =
+                    cache.parse(parser, 2, argv);
+                if (options == NULL ||
+                    options -> get_program_name() != "prg" ||
+                    options -> at("threads") -> get_value() !=
+                    values[which]) {
+                    ++failures;
+                }
+                const char* wrong[] = { "prg", "--unknown" };
+                ParseError error = ParseError { parse_ok, 0, 0 };
+                if (cache.parse(parser, 2, wrong, &error) != NULL ||
+                    error.type != unknown_long_option) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    CHECK_EQUAL(0, failures.load());
+    for (const std::string& value : values) {
+        std::string argument = "--threads=" + value;
+        const char* argv[] = { "prg", argument.c_str() };
+        CHECK(cache.parse(parser, 2, argv) ==
+              cache.parse(parser, 2, argv));
+    }
+    ParseCacheStats stats = cache.get_stats();
+    CHECK_EQUAL(3, (int) stats.entries);
+    CHECK_EQUAL(threads * rounds * 2 + 6,
+                (int) (stats.hits + stats.misses));
+    CHECK(stats.misses >= 3 + threads * rounds);
+}
+
+/**
+ * HAVE A cache and a parser reading the environment
+ * WHEN parse the same command line changing a variable in between
+ * THEN each parse reads the variable, none is cached.
+ */
+TEST(ParseCache, Test_04) {
+    OptionParser parser;
+    parser.set_env_prefix("OPTTEST_");
+    parser.add('t', "threads").set_default_value("1");
+    ParseCache cache(64);
+    const char* argv[] = { "prg" };
+    setenv("OPTTEST_THREADS", "4", 1);
+    std::shared_ptr<const Options> first = cache.parse(parser, 1, argv);
+    setenv("OPTTEST_THREADS", "16", 1);
+    std::shared_ptr<const Options> second = cache.parse(parser, 1, argv);
+    unsetenv("OPTTEST_THREADS");
+    CHECK_EQUAL(std::string("4"), first -> at("threads") -> get_value());
+    CHECK_EQUAL(std::string("16"), second -> at("threads") -> get_value());
+    ParseCacheStats stats = cache.get_stats();
+    CHECK_EQUAL(2, (int) stats.bypasses);
+    CHECK_EQUAL(0, (int) stats.hits + (int) stats.misses);
+    CHECK_EQUAL(0, (int) stats.entries);
+}
+
+/**
+ * HAVE A cache and a parser expanding response files
+ * WHEN parse a command line naming a response file changing the
+ *      file in between, and one naming none twice
+ * THEN the first is parsed each time, the second is cached.
+ */
+TEST(ParseCache, Test_05) {
+    OptionParser parser;
+    parser.set_response_files(ResponseFileLimits { 1024, 1 });
+    parser.add('t', "threads").set_default_value("1");
+    ParseCache cache(64);
+    char path[] = "/tmp/optparse_testXXXXXX";
+    close(mkstemp(path));
+    std::string response = std::string("@") + path;
+    const char* argv[] = { "prg", response.c_str() };
+    const char* plain[] = { "prg", "--threads=2" };
+    std::string values[] = { "--threads=4", "--threads=16" };
+    for (const std::string& content : values) {
+        FILE* file = fopen(path, "w");
+        fputs(content.c_str(), file);
+        fclose(file);
+        std::shared_ptr<const Options> options =
+            cache.parse(parser, 2, argv);
+        CHECK_EQUAL(content.substr(10),
+                    options -> at("threads") -> get_value());
+    }
+    unlink(path);
+    CHECK_TRUE(cache.parse(parser, 2, plain) ==
+               cache.parse(parser, 2, plain));
+    ParseCacheStats stats = cache.get_stats();
+    CHECK_EQUAL(2, (int) stats.bypasses);
+    CHECK_EQUAL(1, (int) stats.hits);
+    CHECK_EQUAL(1, (int) stats.entries);
+}
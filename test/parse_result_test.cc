@@ -0,0 +1,56 @@
+#include "../src/liboptparse/parse_result.hh"
+#include "../src/liboptparse/options.hh"
+#include <sstream>
+#include <string>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+TEST_GROUP(ParseResult) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A result created with options
+ * WHEN check it
+ * THEN it is ok and options can be taken once.
+ */
+TEST(ParseResult, Test_01) {
+    ProgramInfo program_info("program_name");
+    Options::options_container container;
+    ParseResult result(std::unique_ptr<const Options>(
+                           new Options(program_info,
+                                       container.cbegin(),
+                                       container.cend())));
+    CHECK_TRUE(result.is_ok());
+    CHECK_TRUE(result.get_error().type == parse_ok);
+    CHECK_TRUE(result.get_options() != NULL);
+    CHECK_TRUE(result.get_options() == NULL);
+}
+
+/**
+ * HAVE A result created with an error
+ * WHEN check it
+ * THEN it is not ok, it has no options and the error is the same.
+ */
+TEST(ParseResult, Test_02) {
+    ParseResult result(ParseError { unknown_long_option, 2, 3 });
+    CHECK_FALSE(result);
+    CHECK_TRUE(result.get_options() == NULL);
+    CHECK_TRUE(result.get_error().type == unknown_long_option);
+    CHECK_EQUAL(2, result.get_error().index);
+    CHECK_EQUAL(3, result.get_error().position);
+}
+
+/**
+ * HAVE An error
+ * WHEN put it in a stream
+ * THEN description and position are written.
+ */
+TEST(ParseResult, Test_03) {
+    std::ostringstream ss;
+    ss << ParseError { unknown_short_option, 1, 2 };
+    CHECK_EQUAL(ss.str(), "unknown short option at argument 1, position 2");
+}
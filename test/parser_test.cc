@@ -2,8 +2,12 @@
 #include "../src/liboptparse/optargs.hh"
 #include "../src/liboptparse/program_info.hh"
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <algorithm>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
 #include <CppUTest/TestHarness.h>
 #include <CppUTestExt/MockSupport.h>
 
@@ -54,13 +58,13 @@ TEST(OptionParser, Test_03) {
 }
 
 /**
- * HAVE A new parser with an option
+ * HAVE A new parser with a flag
  * WHEN parse argumnents
  * THEN That option to be true.
  */
 TEST(OptionParser, Test_04) {
     OptionParser parser;
-    parser.add('a' );
+    parser.add('a' ).set_type(flag);
     const char *argv[] = { "program_name", "-a" };
     auto options = parser.parse(2, argv);
     bool answer = *(options -> at('a'));
@@ -244,3 +248,942 @@ TEST(OptionParser, Test_16) {
     auto options = parser.parse(3, argv);
     CHECK_EQUAL(options -> get_program_name(), "program");
 }
+
+/**
+ * HAVE A new parser with an option
+ * WHEN try to parse an unknown short option
+ * THEN the error reports its kind and argument index.
+ */
+TEST(OptionParser, Test_17) {
+    OptionParser parser;
+    parser.add('r', "reply");
+    const char *argv[] = { "program_name", "-r", "42", "-x" };
+    auto result = parser.try_parse(4, argv);
+    CHECK_FALSE(result.is_ok());
+    CHECK_TRUE(result.get_error().type == unknown_short_option);
+    CHECK_EQUAL(3, result.get_error().index);
+    CHECK_EQUAL(1, result.get_error().position);
+}
+
+/**
+ * HAVE A new parser with some options
+ * WHEN try to parse grouped short options with an unknown one
+ * THEN the error points to the unknown option.
+ */
+TEST(OptionParser, Test_18) {
+    OptionParser parser;
+    parser.add('a');
+    parser.add('b');
+    const char *argv[] = { "program_name", "-abx" };
+    auto result = parser.try_parse(2, argv);
+    CHECK_TRUE(result.get_error().type == unknown_short_option);
+    CHECK_EQUAL(1, result.get_error().index);
+    CHECK_EQUAL(3, result.get_error().position);
+}
+
+/**
+ * HAVE A new parser with an option
+ * WHEN try to parse an unknown long option
+ * THEN the error reports its kind and argument index.
+ */
+TEST(OptionParser, Test_19) {
+    OptionParser parser;
+    parser.add('r', "reply");
+    const char *argv[] = { "program_name", "--answer=42" };
+    auto result = parser.try_parse(2, argv);
+    CHECK_TRUE(result.get_error().type == unknown_long_option);
+    CHECK_EQUAL(1, result.get_error().index);
+    CHECK_EQUAL(2, result.get_error().position);
+}
+
+/**
+ * HAVE A new parser with an option
+ * WHEN try to parse a "--" without a name
+ * THEN a missing option name error is returned.
+ */
+TEST(OptionParser, Test_20) {
+    OptionParser parser;
+    parser.add('r', "reply");
+    const char *argv[] = { "program_name", "--" };
+    auto result = parser.try_parse(2, argv);
+    CHECK_TRUE(result.get_error().type == missing_option_name);
+    CHECK_EQUAL(1, result.get_error().index);
+}
+
+/**
+ * HAVE A new parser with an option
+ * WHEN try to parse valid arguments
+ * THEN the result contains the options.
+ */
+TEST(OptionParser, Test_21) {
+    OptionParser parser;
+    parser.add('r', "reply");
+    const char *argv[] = { "program_name", "--reply", "42" };
+    auto result = parser.try_parse(3, argv);
+    CHECK_TRUE(result.is_ok());
+    auto options = result.get_options();
+    CHECK_EQUAL((std::string)*options -> at('r'), "42");
+}
+
+/**
+ * HAVE A new parser with an option
+ * WHEN parse an unknown option
+ * THEN out_of_range is thrown.
+ */
+TEST(OptionParser, Test_22) {
+    OptionParser parser;
+    parser.add('r', "reply");
+    const char *argv[] = { "program_name", "--answer" };
+    bool thrown = false;
+    try {
+        parser.parse(2, argv);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    CHECK_TRUE(thrown);
+}
+
+/**
+ * HAVE A new parser with some options
+ * WHEN try to parse collecting all errors
+ * THEN each error is reported in order.
+ */
+TEST(OptionParser, Test_23) {
+    OptionParser parser;
+    parser.add('a');
+    parser.add('r', "reply");
+    const char *argv[] = {
+        "program_name", "-x", "-ayz", "--answer=42", "--reply" };
+    std::vector<ParseError> errors;
+    auto result = parser.try_parse(5, argv, errors);
+    CHECK_FALSE(result.is_ok());
+    CHECK_EQUAL(5, (int)errors.size());
+    CHECK_TRUE(errors[0].type == unknown_short_option);
+    CHECK_EQUAL(1, errors[0].index);
+    CHECK_TRUE(errors[1].type == unknown_short_option);
+    CHECK_EQUAL(2, errors[1].position);
+    CHECK_TRUE(errors[2].type == unknown_short_option);
+    CHECK_EQUAL(3, errors[2].position);
+    CHECK_TRUE(errors[3].type == unknown_long_option);
+    CHECK_EQUAL(3, errors[3].index);
+    CHECK_TRUE(errors[4].type == missing_option_value);
+    CHECK_EQUAL(4, errors[4].index);
+    CHECK_TRUE(result.get_error().type == errors[0].type);
+}
+
+/**
+ * HAVE A new parser with an option and a flag
+ * WHEN try to parse the option without value, in long or short
+ *      format, at the end or followed by the flag
+ * THEN a missing option value error is reported for each of them.
+ */
+TEST(OptionParser, Test_24) {
+    OptionParser parser;
+    parser.add('r', "reply");
+    parser.add('v', "verbose").set_type(flag);
+    const char *argv[] = { "program_name", "--reply" };
+    std::vector<ParseError> errors;
+    auto result = parser.try_parse(2, argv, errors);
+    CHECK_EQUAL(1, (int)errors.size());
+    CHECK_TRUE(errors[0].type == missing_option_value);
+    CHECK_EQUAL(1, errors[0].index);
+    const char *short_argv[] = { "program_name", "-r" };
+    errors.clear();
+    CHECK_FALSE(parser.try_parse(2, short_argv, errors).is_ok());
+    CHECK_EQUAL(1, (int)errors.size());
+    CHECK_TRUE(errors[0].type == missing_option_value);
+    CHECK_EQUAL(1, errors[0].index);
+    const char *followed_argv[] = {
+        "program_name", "-r", "-v", "--reply", "--verbose" };
+    errors.clear();
+    auto followed = parser.try_parse(5, followed_argv, errors);
+    CHECK_EQUAL(2, (int)errors.size());
+    CHECK_TRUE(errors[0].type == missing_option_value);
+    CHECK_EQUAL(1, errors[0].index);
+    CHECK_TRUE(errors[1].type == missing_option_value);
+    CHECK_EQUAL(3, errors[1].index);
+    CHECK_TRUE(followed.get_error().type == missing_option_value);
+    CHECK_TRUE(parser.try_parse(2, short_argv).get_error().type ==
+               missing_option_value);
+}
+
+/**
+ * HAVE A new parser with a flag
+ * WHEN parse the flag in long format as last argument
+ * THEN the flag is true.
+ */
+TEST(OptionParser, Test_25) {
+    OptionParser parser;
+    parser.add('v', "verbose").set_type(OptionArgumentType::flag);
+    const char *argv[] = { "program_name", "--verbose" };
+    auto options = parser.parse(2, argv);
+    CHECK_TRUE((bool)*options -> at('v'));
+}
+
+/**
+ * HAVE A new parser with an option
+ * WHEN try to parse valid arguments collecting all errors
+ * THEN there are no errors and the result contains the options.
+ */
+TEST(OptionParser, Test_26) {
+    OptionParser parser;
+    parser.add('r', "reply");
+    const char *argv[] = { "program_name", "-r", "42" };
+    std::vector<ParseError> errors;
+    auto result = parser.try_parse(3, argv, errors);
+    CHECK_TRUE(result.is_ok());
+    CHECK_TRUE(errors.empty());
+}
+
+/**
+ * HAVE A new parser
+ * WHEN add some options
+ * THEN each option gets the next dense id.
+ */
+TEST(OptionParser, Test_27) {
+    OptionParser parser;
+    option_id a = parser.add('a').get_id();
+    option_id r = parser.add('r', "reply").get_id();
+    option_id v = parser.add("verbose").get_id();
+    CHECK_EQUAL((option_id)0, a);
+    CHECK_EQUAL((option_id)1, r);
+    CHECK_EQUAL((option_id)2, v);
+}
+
+/**
+ * HAVE A new parser with a long only option
+ * WHEN parse arguments with that option
+ * THEN value is found by long name and by id.
+ */
+TEST(OptionParser, Test_28) {
+    OptionParser parser;
+    parser.add('a');
+    option_id id = parser.add("reply").get_id();
+    const char *argv[] = { "program_name", "--reply=42" };
+    auto options = parser.parse(2, argv);
+    CHECK_EQUAL((std::string)*options -> at("reply"), "42");
+    CHECK_EQUAL((std::string)*options -> at_id(id), "42");
+    CHECK_EQUAL((std::size_t)2, options -> size());
+}
+
+/**
+ * HAVE A new parser with more options than letters
+ * WHEN parse arguments with some of them
+ * THEN each value is found by its id.
+ */
+TEST(OptionParser, Test_29) {
+    OptionParser parser;
+    std::vector<option_id> ids;
+    for (int i = 0; i < 100; ++i) {
+        std::string name = "opt";
+        for (int n = i; n > 0; n /= 26) {
+            name.push_back('a' + n % 26);
+        }
+        ids.push_back(parser.add(name).set_default_value(name).get_id());
+    }
+    const char *argv[] = { "program_name", "--optbb", "42" };
+    auto options = parser.parse(3, argv);
+    CHECK_EQUAL((std::string)*options -> at_id(ids[27]), "42");
+    CHECK_EQUAL((std::string)*options -> at_id(ids[99]), "optvd");
+}
+
+/**
+ * HAVE A parser already used to parse
+ * WHEN add an option and parse again
+ * THEN old options are not changed.
+ */
+TEST(OptionParser, Test_30) {
+    OptionParser parser;
+    parser.add('a', "alpha").set_type(flag);
+    const char *argv[] = { "program_name", "-a" };
+    auto first = parser.parse(2, argv);
+    parser.add('b', "beta");
+    auto second = parser.parse(2, argv);
+    CHECK_EQUAL((std::size_t)1, first -> size());
+    CHECK_EQUAL((std::size_t)2, second -> size());
+    CHECK_TRUE((bool)*first -> at("alpha"));
+}
+
+/**
+ * HAVE A new parser with some options
+ * WHEN iterate parsed options
+ * THEN short named options are visited in short name order.
+ */
+TEST(OptionParser, Test_31) {
+    OptionParser parser;
+    parser.add('r', "reply");
+    parser.add("verbose");
+    parser.add('a');
+    const char *argv[] = { "program_name", "-r", "42" };
+    auto options = parser.parse(3, argv);
+    std::string names;
+    for (auto itr = options -> options_cbegin();
+         itr != options -> options_cend();
+         ++itr) {
+        names.push_back(itr -> first);
+    }
+    CHECK_EQUAL(names, "ar");
+    CHECK_EQUAL(3, (int)std::distance(options -> values_cbegin(),
+                                      options -> values_cend()));
+}
+
+/**
+ * HAVE A new parser with an option
+ * WHEN add an option with the same short name
+ * THEN invalid_argument is thrown and the parser is not changed.
+ */
+TEST(OptionParser, Test_32) {
+    OptionParser parser;
+    parser.add('r', "reply");
+    bool thrown = false;
+    try {
+        parser.add('r', "answer");
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK_TRUE(thrown);
+    CHECK_EQUAL(1, (int)std::distance(parser.cbegin(), parser.cend()));
+}
+
+/**
+ * HAVE A new parser with an option
+ * WHEN add an option with the same long name
+ * THEN invalid_argument is thrown.
+ */
+TEST(OptionParser, Test_33) {
+    OptionParser parser;
+    parser.add('r', "reply");
+    bool thrown = false;
+    try {
+        parser.add("reply");
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK_TRUE(thrown);
+    option_id id = parser.add('a', "answer").get_id();
+    CHECK_EQUAL((option_id)1, id);
+}
+
+/**
+ * HAVE A parser with options bound to variables
+ * WHEN parse into them
+ * THEN variables get the converted values and the others keep
+ *      their value.
+ */
+TEST(OptionParser, Test_34) {
+    int jobs = 1;
+    bool verbose = false;
+    std::string output = "a.out";
+    OptionParser parser;
+    parser.add('j', "jobs").bind(&jobs);
+    parser.add('v', "verbose").set_type(flag).bind(&verbose);
+    parser.add('o', "output").bind(&output);
+    const char* argv[] = { "prog", "-j", "8", "--verbose", "file" };
+    ParseError error = parser.try_parse_into(5, argv);
+    CHECK_EQUAL(parse_ok, error.type);
+    CHECK_EQUAL(8, jobs);
+    CHECK_TRUE(verbose);
+    CHECK_EQUAL(std::string("a.out"), output);
+}
+
+/**
+ * HAVE A parser with options bound to members of a struct
+ * WHEN parse into an object
+ * THEN members of the object get the converted values.
+ */
+TEST(OptionParser, Test_35) {
+    struct Config {
+        int         jobs = 1;
+        double      ratio = 0;
+        std::string output;
+    };
+    OptionParser parser;
+    parser.add('j', "jobs").bind(&Config::jobs);
+    parser.add("ratio").bind(&Config::ratio);
+    parser.add('o', "output").bind(&Config::output);
+    const char* argv[] = { "prog", "--ratio=0.25", "-o", "out.txt" };
+    Config config;
+    ParseError error = parser.try_parse_into(config, 4, argv);
+    CHECK_EQUAL(parse_ok, error.type);
+    CHECK_EQUAL(1, config.jobs);
+    CHECK_EQUAL(0.25, config.ratio);
+    CHECK_EQUAL(std::string("out.txt"), config.output);
+}
+
+/**
+ * HAVE A parser with options bound to variables
+ * WHEN parse values not valid for their types
+ * THEN invalid_option_value errors are reported with the position
+ *      of the values.
+ */
+TEST(OptionParser, Test_36) {
+    int jobs = 1;
+    unsigned int port = 80;
+    OptionParser parser;
+    parser.add('j', "jobs").bind(&jobs);
+    parser.add("port").bind(&port);
+    const char* argv[] = { "prog", "-j", "many", "--port=99999999999" };
+    std::vector<ParseError> errors;
+    ParseError error = parser.try_parse_into(4, argv, errors);
+    CHECK_EQUAL(invalid_option_value, error.type);
+    CHECK_EQUAL((std::size_t)2, errors.size());
+    CHECK_EQUAL(2, errors[0].index);
+    CHECK_EQUAL(0, errors[0].position);
+    CHECK_EQUAL(3, errors[1].index);
+    CHECK_EQUAL(7, errors[1].position);
+    CHECK_EQUAL(1, jobs);
+    CHECK_EQUAL(80u, port);
+}
+
+namespace {
+    /* Handler recording the events as a string. */
+    class RecordingHandler : public ParseHandler {
+    public:
+        std::string events;
+
+        void on_program_name(const ArgumentText& name) override {
+            events += "P(" + name.str() + ")";
+        }
+
+        void on_option(const OptionArgument& option) override {
+            events += "O(" + std::to_string(option.get_id()) + ")";
+        }
+
+        void on_value(const OptionArgument&,
+                      const ArgumentText& value) override {
+            events += "V(" + value.str() + ")";
+        }
+
+        void on_positional(const ArgumentText& value) override {
+            events += "A(" + value.str() + ")";
+        }
+
+        void on_end() override {
+            events += "E";
+        }
+
+        bool on_error(const ParseError& error) override {
+            events += "X(" + std::to_string(error.type) + ")";
+            return true;
+        }
+    };
+}
+
+/**
+ * HAVE A parser
+ * WHEN parse events of a valid command line
+ * THEN options, values and positional arguments are notified in
+ *      command line order.
+ */
+TEST(OptionParser, Test_37) {
+    OptionParser parser;
+    parser.add('r', "reply");
+    parser.add('v', "verbose").set_type(flag);
+    parser.add('q').set_type(flag);
+    const char* argv[] = {
+        "prog", "-vq", "file", "--reply=a\\ b", "-r", "c" };
+    RecordingHandler handler;
+    ParseError error = parser.parse_events(6, argv, handler);
+    CHECK_EQUAL(parse_ok, error.type);
+    CHECK_EQUAL(std::string("P(prog)O(1)O(2)A(file)O(0)V(a b)O(0)V(c)E"),
+                handler.events);
+}
+
+/**
+ * HAVE A parser
+ * WHEN parse events of a command line with errors
+ * THEN errors are notified and the first one is returned.
+ */
+TEST(OptionParser, Test_38) {
+    OptionParser parser;
+    parser.add('r', "reply");
+    const char* argv[] = { "prog", "-x", "--answer", "-r", "1" };
+    RecordingHandler handler;
+    ParseError error = parser.parse_events(5, argv, handler);
+    CHECK_EQUAL(unknown_short_option, error.type);
+    CHECK_EQUAL(1, error.index);
+    CHECK_EQUAL(std::string("P(prog)X(1)X(2)O(0)V(1)E"), handler.events);
+}
+
+/**
+ * HAVE A parser
+ * WHEN the handler stops at the first error
+ * THEN end is not notified.
+ */
+TEST(OptionParser, Test_39) {
+    OptionParser parser;
+    parser.add('r', "reply");
+    const char* argv[] = { "prog", "--answer", "-r", "1" };
+    ParseHandler handler;
+    ParseError error = parser.parse_events(4, argv, handler);
+    CHECK_EQUAL(unknown_long_option, error.type);
+    CHECK_EQUAL(1, error.index);
+    CHECK_EQUAL(2, error.position);
+}
+
+/**
+ * HAVE A parser
+ * WHEN iterate lazily the items of a command line
+ * THEN options, values, positional arguments and errors are found in
+ *      command line order.
+ */
+TEST(OptionParser, Test_40) {
+    OptionParser parser;
+    parser.add('r', "reply");
+    parser.add('v', "verbose").set_type(flag);
+    const char* argv[] = { "prog", "-v", "--reply=42", "-x", "file" };
+    std::vector<ParsedItem> items;
+    for (const ParsedItem& item : parser.parse_lazily(5, argv)) {
+        items.push_back(item);
+    }
+    CHECK_EQUAL((std::size_t)5, items.size());
+    CHECK_EQUAL(parsed_program_name, items[0].type);
+    CHECK_TRUE(items[0].value == "prog");
+    CHECK_EQUAL(parsed_option, items[1].type);
+    CHECK_EQUAL('v', items[1].option -> get_short_name());
+    CHECK_FALSE(items[1].has_value);
+    CHECK_EQUAL(parsed_option, items[2].type);
+    CHECK_EQUAL('r', items[2].option -> get_short_name());
+    CHECK_TRUE(items[2].has_value);
+    CHECK_TRUE(items[2].value == "42");
+    CHECK_EQUAL(parsed_error, items[3].type);
+    CHECK_EQUAL(unknown_short_option, items[3].error.type);
+    CHECK_EQUAL(3, items[3].error.index);
+    CHECK_EQUAL(parsed_positional, items[4].type);
+    CHECK_TRUE(items[4].value == "file");
+}
+
+/**
+ * HAVE A parser
+ * WHEN stop the iteration of the items
+ * THEN arguments after the last item are not read.
+ */
+TEST(OptionParser, Test_41) {
+    OptionParser parser;
+    parser.add('v', "verbose").set_type(flag);
+    /* Reading the NULL argument would crash. */
+    const char* argv[] = { "prog", "-v", NULL };
+    ParseRange range = parser.parse_lazily(3, argv);
+    auto itr = range.begin();
+    CHECK_EQUAL(parsed_program_name, itr -> type);
+    ++itr;
+    CHECK_EQUAL(parsed_option, itr -> type);
+    CHECK_TRUE(itr != range.end());
+}
+
+/**
+ * HAVE A parser
+ * WHEN parse stopping at the separator
+ * THEN arguments after "--" are returned untouched and not read.
+ */
+TEST(OptionParser, Test_42) {
+    OptionParser parser;
+    parser.add('v', "verbose").set_type(flag);
+    parser.add('o', "output").set_type(value);
+    /* Reading the NULL argument would crash. */
+    const char* argv[] = { "prog", "-v", "file", "--", NULL, "-o" };
+    ParseResult result = parser.try_parse(6, argv, stop_at_separator);
+    CHECK_TRUE(result.is_ok());
+    CHECK_EQUAL(2, result.get_tail().argc);
+    CHECK_TRUE(argv + 4 == result.get_tail().argv);
+    auto options = result.get_options();
+    CHECK_TRUE((bool) *options -> at("verbose"));
+    CHECK_EQUAL("", (std::string) *options -> at("output"));
+}
+
+/**
+ * HAVE A parser
+ * WHEN parse stopping at the first positional argument
+ * THEN the tail starts at it and options after it are not parsed.
+ */
+TEST(OptionParser, Test_43) {
+    OptionParser parser;
+    parser.add('v', "verbose").set_type(flag);
+    parser.add('o', "output").set_type(value);
+    const char* argv[] = { "prog", "-o", "out", "run", "-v", "--bad" };
+    ParseResult result = parser.try_parse(6, argv, stop_at_positional);
+    CHECK_TRUE(result.is_ok());
+    CHECK_EQUAL(3, result.get_tail().argc);
+    CHECK_TRUE(argv + 3 == result.get_tail().argv);
+    auto options = result.get_options();
+    CHECK_EQUAL("out", (std::string) *options -> at("output"));
+    CHECK_FALSE((bool) *options -> at("verbose"));
+}
+
+/**
+ * HAVE A parser
+ * WHEN parse without stopping or without arguments to skip
+ * THEN the tail is empty and "--" alone is still an error.
+ */
+TEST(OptionParser, Test_44) {
+    OptionParser parser;
+    parser.add('v', "verbose").set_type(flag);
+    const char* argv[] = { "prog", "-v", "--" };
+    ParseResult all = parser.try_parse(2, argv, stop_at_positional);
+    CHECK_TRUE(all.is_ok());
+    CHECK_EQUAL(0, all.get_tail().argc);
+    ParseResult last = parser.try_parse(3, argv, stop_at_separator);
+    CHECK_TRUE(last.is_ok());
+    CHECK_EQUAL(0, last.get_tail().argc);
+    ParseResult error = parser.try_parse(3, argv);
+    CHECK_FALSE(error.is_ok());
+    CHECK_EQUAL(missing_option_name, error.get_error().type);
+    CHECK_EQUAL(0, error.get_tail().argc);
+}
+
+/**
+ * HAVE A parser
+ * WHEN parse a vector of strings
+ * THEN options are the same as parsing argv.
+ */
+TEST(OptionParser, Test_45) {
+    OptionParser parser;
+    parser.add('v', "verbose").set_type(flag);
+    parser.add('o', "output");
+    std::vector<std::string> arguments = {
+        "prog", "-v", "--output", "out.txt", "file" };
+    auto options = parser.parse(arguments);
+    CHECK_TRUE((bool) *options -> at("verbose"));
+    CHECK_EQUAL("out.txt", (std::string) *options -> at("output"));
+    CHECK_EQUAL("prog", options -> get_program_name());
+    CHECK_EQUAL("file", (std::string) **options -> arguments_cbegin());
+}
+
+/**
+ * HAVE A parser
+ * WHEN parse string views that are not NUL-terminated
+ * THEN each view is read within its bounds.
+ */
+TEST(OptionParser, Test_46) {
+    OptionParser parser;
+    parser.add('o', "output");
+    parser.add('q').set_type(flag);
+    const char line[] = "prog--output=out.txt-qx";
+    std::string_view arguments[] = {
+        std::string_view(line, 4),
+        std::string_view(line + 4, 16),
+        std::string_view(line + 20, 2) };
+    ParseResult result = parser.try_parse(arguments);
+    CHECK_TRUE(result.is_ok());
+    auto options = result.get_options();
+    CHECK_EQUAL("out.txt", (std::string) *options -> at("output"));
+    CHECK_TRUE((bool) *options -> at('q'));
+    std::string_view wrong[] = {
+        std::string_view(line, 4),
+        std::string_view(line + 20, 3) };
+    ParseResult error = parser.try_parse(wrong);
+    CHECK_FALSE(error.is_ok());
+    CHECK_EQUAL(unknown_short_option, error.get_error().type);
+    CHECK_EQUAL(1, error.get_error().index);
+    CHECK_EQUAL(2, error.get_error().position);
+}
+
+/**
+ * HAVE A parser
+ * WHEN parse NUL-delimited arguments read from a pipe in small
+ *      chunks
+ * THEN events are the same of argv, with arguments split by chunks.
+ */
+TEST(OptionParser, Test_47) {
+    OptionParser parser;
+    parser.add('r', "reply");
+    parser.add('v', "verbose").set_type(flag);
+    parser.add('q').set_type(flag);
+    const char input[] = "-vq\0file\0--reply=a\\ b\0-r\0long_positional";
+    int fds[2];
+    CHECK_EQUAL(0, pipe(fds));
+    CHECK_EQUAL((long) sizeof(input) - 1,
+                (long) write(fds[1], input, sizeof(input) - 1));
+    close(fds[1]);
+    RecordingHandler handler;
+    ParseError error = parser.parse_stream(fds[0], handler, 4);
+    close(fds[0]);
+    CHECK_EQUAL(parse_ok, error.type);
+    CHECK_EQUAL(std::string("O(1)O(2)A(file)O(0)V(a b)O(0)"
+                            "V(long_positional)E"),
+                handler.events);
+}
+
+/**
+ * HAVE A parser
+ * WHEN parse a stream with an error
+ * THEN the error index counts the arguments of the stream.
+ */
+TEST(OptionParser, Test_48) {
+    OptionParser parser;
+    parser.add('v', "verbose").set_type(flag);
+    const char input[] = "-v\0a\0\0-x\0";
+    int fds[2];
+    CHECK_EQUAL(0, pipe(fds));
+    CHECK_EQUAL((long) sizeof(input) - 1,
+                (long) write(fds[1], input, sizeof(input) - 1));
+    close(fds[1]);
+    RecordingHandler handler;
+    ParseError error = parser.parse_stream(fds[0], handler);
+    close(fds[0]);
+    CHECK_EQUAL(unknown_short_option, error.type);
+    CHECK_EQUAL(3, error.index);
+    CHECK_EQUAL(std::string("O(0)A(a)X(1)E"), handler.events);
+}
+
+/**
+ * HAVE A parser with an environment prefix
+ * WHEN parse with variables named by prefix and long name
+ * THEN options not given take the value of the variables, others
+ *      keep their default.
+ */
+TEST(OptionParser, Test_49) {
+    OptionParser parser;
+    parser.set_env_prefix("OPTTEST_");
+    parser.add('t', "threads").set_default_value("1");
+    parser.add('v', "verbose").set_type(flag);
+    parser.add('o', "output").set_default_value("a.out");
+    setenv("OPTTEST_THREADS", "8", 1);
+    setenv("OPTTEST_VERBOSE", "true", 1);
+    setenv("OPTTEST_verbose", "false", 1);
+    setenv("OPTTEST_", "x", 1);
+    const char* argv[] = { "prg" };
+    auto options = parser.parse(1, argv);
+    unsetenv("OPTTEST_THREADS");
+    unsetenv("OPTTEST_VERBOSE");
+    unsetenv("OPTTEST_verbose");
+    unsetenv("OPTTEST_");
+    CHECK_EQUAL(std::string("8"), options -> at("threads") -> get_value());
+    CHECK((bool) *options -> at("verbose"));
+    CHECK_EQUAL(std::string("a.out"), options -> at("output") -> get_value());
+}
+
+/**
+ * HAVE A parser with an option with an env name
+ * WHEN parse with the variable set and the option given
+ * THEN the command line overrides the variable.
+ */
+TEST(OptionParser, Test_50) {
+    OptionParser parser;
+    parser.add('c', "config").set_env_name("OPTTEST_CONFIG_FILE");
+    parser.add('l', "level").set_env_name("OPTTEST_LEVEL");
+    setenv("OPTTEST_CONFIG_FILE", "/etc/tool.conf", 1);
+    setenv("OPTTEST_LEVEL", "2", 1);
+    const char* argv[] = { "prg", "--level=3" };
+    auto options = parser.parse(2, argv);
+    unsetenv("OPTTEST_CONFIG_FILE");
+    unsetenv("OPTTEST_LEVEL");
+    CHECK_EQUAL(std::string("/etc/tool.conf"),
+                options -> at("config") -> get_value());
+    CHECK_EQUAL(std::string("3"), options -> at("level") -> get_value());
+}
+
+/**
+ * HAVE A parser with defaults
+ * WHEN parse command lines giving the same values in different
+ *      ways: in other order, overridden or equal to the default
+ * THEN fingerprints are equal, and differ from command lines with
+ *      other values or positionals in other order.
+ */
+TEST(OptionParser, Test_51) {
+    OptionParser parser;
+    parser.add('t', "threads").set_default_value("1");
+    parser.add('v', "verbose").set_type(flag);
+    parser.add('o', "output").set_default_value("a.out");
+    const char* first[] = { "prg", "-v", "--threads=4", "a", "b" };
+    const char* second[] = {
+        "prg", "--threads=2", "a", "--threads=4", "-v", "b" };
+    const char* third[] = {
+        "other", "--output=a.out", "-v", "--threads=4", "a", "b" };
+    const char* values[] = { "prg", "-v", "--threads=5", "a", "b" };
+    const char* order[] = { "prg", "-v", "--threads=4", "b", "a" };
+    OptionsFingerprint expected = parser.parse(5, first) -> get_fingerprint();
+    CHECK_TRUE(expected == parser.parse(6, second) -> get_fingerprint());
+    CHECK_TRUE(expected == parser.parse(6, third) -> get_fingerprint());
+    CHECK_TRUE(expected != parser.parse(5, values) -> get_fingerprint());
+    CHECK_TRUE(expected != parser.parse(5, order) -> get_fingerprint());
+    CHECK_TRUE(expected.value() == expected.low);
+}
+
+/**
+ * HAVE A parser with an environment prefix and a config file
+ * WHEN parse setting the same value by the environment, the config
+ *      file and the command line
+ * THEN fingerprints are equal.
+ */
+TEST(OptionParser, Test_52) {
+    OptionParser parser;
+    parser.set_env_prefix("OPTTEST_");
+    parser.add('t', "threads").set_default_value("1");
+    parser.add('l', "level").set_default_value("0");
+    char path[] = "/tmp/optparse_testXXXXXX";
+    int fd = mkstemp(path);
+    const std::string content = "threads = 4\n";
+    CHECK_EQUAL((long) content.size(),
+                (long) write(fd, content.data(), content.size()));
+    close(fd);
+    ConfigFile config;
+    CHECK_EQUAL(parse_ok, config.load(path).type);
+    unlink(path);
+    const char* plain[] = { "prg", "--level=2" };
+    const char* given[] = { "prg", "--threads=4", "--level=2" };
+    OptionsFingerprint expected =
+        parser.parse(3, given) -> get_fingerprint();
+    CHECK_TRUE(expected != parser.parse(2, plain) -> get_fingerprint());
+    CHECK_TRUE(expected ==
+               parser.parse(2, plain, config) -> get_fingerprint());
+    setenv("OPTTEST_THREADS", "4", 1);
+    auto options = parser.parse(2, plain);
+    unsetenv("OPTTEST_THREADS");
+    CHECK_TRUE(expected == options -> get_fingerprint());
+}
+
+/**
+ * HAVE A parser with an environment prefix and long names with
+ *      upper case chars
+ * WHEN parse with the variables of the long names in upper case
+ * THEN options take their value, but long names differing only by
+ *      case, which can not be told apart.
+ */
+TEST(OptionParser, Test_53) {
+    OptionParser parser;
+    parser.set_env_prefix("OPTTEST_");
+    parser.add('o', "outputFile").set_default_value("a.out");
+    parser.add('m', "maxJobs").set_default_value("1");
+    parser.add('x', "maxjobs").set_default_value("2");
+    setenv("OPTTEST_OUTPUTFILE", "b.out", 1);
+    setenv("OPTTEST_MAXJOBS", "8", 1);
+    const char* argv[] = { "prg" };
+    auto options = parser.parse(1, argv);
+    unsetenv("OPTTEST_OUTPUTFILE");
+    unsetenv("OPTTEST_MAXJOBS");
+    CHECK_EQUAL(std::string("b.out"), options -> at('o') -> get_value());
+    CHECK_EQUAL(std::string("1"), options -> at('m') -> get_value());
+    CHECK_EQUAL(std::string("2"), options -> at('x') -> get_value());
+}
+
+/**
+ * HAVE A parser with an environment prefix and options with an env
+ *      name
+ * WHEN parse with both the env name and the prefixed variable set,
+ *      in both orders
+ * THEN the env name wins, and a repeated option takes its value
+ *      only.
+ */
+TEST(OptionParser, Test_54) {
+    OptionParser parser;
+    parser.set_env_prefix("OPTTEST_");
+    parser.add('t', "threads").set_env_name("OPTTEST_JOBS");
+    parser.add('I', "include").set_type(repeated)
+        .set_env_name("OPTTEST_PATH");
+    const char* argv[] = { "prg" };
+    for (int order = 0; order < 2; ++order) {
+        if (order == 0) {
+            setenv("OPTTEST_THREADS", "2", 1);
+            setenv("OPTTEST_INCLUDE", "/usr/include", 1);
+            setenv("OPTTEST_JOBS", "4", 1);
+            setenv("OPTTEST_PATH", "/opt/include", 1);
+        } else {
+            setenv("OPTTEST_JOBS", "4", 1);
+            setenv("OPTTEST_PATH", "/opt/include", 1);
+            setenv("OPTTEST_THREADS", "2", 1);
+            setenv("OPTTEST_INCLUDE", "/usr/include", 1);
+        }
+        auto options = parser.parse(1, argv);
+        unsetenv("OPTTEST_THREADS");
+        unsetenv("OPTTEST_INCLUDE");
+        unsetenv("OPTTEST_JOBS");
+        unsetenv("OPTTEST_PATH");
+        CHECK_EQUAL(std::string("4"), options -> at('t') -> get_value());
+        ValueSpan paths = options -> get_values('I');
+        CHECK_EQUAL(1, (int) paths.size());
+        CHECK_EQUAL(std::string("/opt/include"), std::string(paths[0]));
+    }
+}
+
+/**
+ * HAVE A parser with an environment prefix and a flag
+ * WHEN parse with the variable of the flag set to booleans in any
+ *      form, empty or not valid, and with a config setting it
+ * THEN booleans are stored as "true" or "false", other values are
+ *      reported as invalid_option_value.
+ */
+TEST(OptionParser, Test_55) {
+    OptionParser parser;
+    parser.set_env_prefix("OPTTEST_");
+    parser.add('v', "verbose").set_type(flag);
+    parser.add('t', "threads").set_default_value("1");
+    const char* argv[] = { "prg" };
+    const char* sets[] = { "1", "yes", "TRUE" };
+    const char* unsets[] = { "0", "No", "false" };
+    for (const char* value : sets) {
+        setenv("OPTTEST_VERBOSE", value, 1);
+        auto options = parser.parse(1, argv);
+        CHECK_TRUE(options -> is_set(options -> find_id('v')));
+        CHECK_TRUE((bool) *options -> at('v'));
+        CHECK_EQUAL(std::string("true"), options -> at('v') -> get_value());
+    }
+    for (const char* value : unsets) {
+        setenv("OPTTEST_VERBOSE", value, 1);
+        auto options = parser.parse(1, argv);
+        CHECK_FALSE((bool) *options -> at('v'));
+        CHECK_EQUAL(std::string("false"),
+                    options -> at('v') -> get_value());
+    }
+    const char* invalid[] = { "", "2", "on" };
+    for (const char* value : invalid) {
+        setenv("OPTTEST_VERBOSE", value, 1);
+        ParseResult result = parser.try_parse(1, argv);
+        CHECK_FALSE(result.is_ok());
+        CHECK_EQUAL(invalid_option_value, result.get_error().type);
+        CHECK_EQUAL(-1, result.get_error().index);
+        std::vector<ParseError> errors;
+        CHECK_FALSE(parser.try_parse(1, argv, errors).is_ok());
+        CHECK_EQUAL(1, (int) errors.size());
+    }
+    unsetenv("OPTTEST_VERBOSE");
+    char path[] = "/tmp/optparse_testXXXXXX";
+    int fd = mkstemp(path);
+    const std::string content = "threads = 2\nverbose = 1\n";
+    CHECK_EQUAL((long) content.size(),
+                (long) write(fd, content.data(), content.size()));
+    close(fd);
+    ConfigFile config;
+    CHECK_EQUAL(parse_ok, config.load(path).type);
+    auto options = parser.parse(1, argv, config);
+    CHECK_TRUE((bool) *options -> at('v'));
+    fd = open(path, O_WRONLY | O_TRUNC);
+    const std::string wrong = "threads = 2\nverbose = maybe\n";
+    CHECK_EQUAL((long) wrong.size(),
+                (long) write(fd, wrong.data(), wrong.size()));
+    close(fd);
+    CHECK_EQUAL(parse_ok, config.load(path).type);
+    unlink(path);
+    ParseResult result = parser.try_parse(1, argv, config);
+    CHECK_EQUAL(invalid_option_value, result.get_error().type);
+    CHECK_EQUAL(2, result.get_error().index);
+}
+
+/**
+ * HAVE A parser with an environment prefix and a flag
+ * WHEN parse leaving the flag unset, setting it to false by the
+ *      environment and setting it by the command line
+ * THEN the flag reads "false" unless set, and the fingerprint of an
+ *      explicit false is the one of the unset flag.
+ */
+TEST(OptionParser, Test_56) {
+    OptionParser parser;
+    parser.set_env_prefix("OPTTEST_");
+    parser.add('v', "verbose").set_type(flag);
+    parser.add('t', "threads").set_default_value("4");
+    const char* plain[] = { "prg" };
+    const char* given[] = { "prg", "-v" };
+    auto unset = parser.parse(1, plain);
+    CHECK_EQUAL(std::string("false"), unset -> at('v') -> get_value());
+    CHECK_FALSE(unset -> is_set(unset -> find_id('v')));
+    setenv("OPTTEST_VERBOSE", "false", 1);
+    auto explicit_false = parser.parse(1, plain);
+    setenv("OPTTEST_VERBOSE", "0", 1);
+    auto zero = parser.parse(1, plain);
+    unsetenv("OPTTEST_VERBOSE");
+    CHECK_TRUE(unset -> get_fingerprint() ==
+               explicit_false -> get_fingerprint());
+    CHECK_TRUE(unset -> get_fingerprint() == zero -> get_fingerprint());
+    CHECK_TRUE(unset -> get_fingerprint() !=
+               parser.parse(2, given) -> get_fingerprint());
+}
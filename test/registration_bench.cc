@@ -0,0 +1,39 @@
+#include "../src/liboptparse/parser.hh"
+#include "benchmark.hh"
+#include <string>
+#include <vector>
+
+namespace {
+    std::vector<std::string> make_names(std::size_t count) {
+        std::vector<std::string> names;
+        for (std::size_t i = 0; i < count; ++i) {
+            std::string name = "opt";
+            for (std::size_t n = i; n > 0; n /= 26) {
+                name.push_back('a' + n % 26);
+            }
+            names.push_back(name);
+        }
+        return names;
+    }
+}
+
+/*
+ * Register 1k and 10k long options: time per option must not grow
+ * with the number of options already added.
+ */
+BENCHMARK(Registration, add_long_options) {
+    const std::size_t counts[] = { 1000, 10000 };
+    for (auto count : counts) {
+        std::vector<std::string> names = make_names(count);
+        std::string label = "add " + std::to_string(count) + " options";
+        double seconds = bench::measure(label.c_str(), 20, 0, [&]() {
+                OptionParser parser;
+                for (auto& name : names) {
+                    parser.add(name).set_default_value("0");
+                }
+                bench::keep(parser);
+            });
+        std::printf("  %-40s %12.1f ns/option\n",
+                    "", seconds * 1e9 / count);
+    }
+}
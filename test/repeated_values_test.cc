@@ -0,0 +1,167 @@
+#include "../src/liboptparse/repeated_values.hh"
+#include "../src/liboptparse/compiled_parser.hh"
+#include "../src/liboptparse/parser.hh"
+#include "../src/liboptparse/shell_split.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+    void add_options(OptionParser& parser) {
+        parser.add('I', "include").set_type(repeated);
+        parser.add('n', "number").set_type(repeated);
+        parser.add('o', "output").set_default_value("a.out");
+    }
+}
+
+TEST_GROUP(RepeatedValues) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A parser with repeated options
+ * WHEN parse a command line giving them several times, mixed with
+ *      other options, quoted values included
+ * THEN values of each option are contiguous, in the order given,
+ *      and other options keep their single value.
+ */
+TEST(RepeatedValues, Test_01) {
+    OptionParser parser;
+    add_options(parser);
+    ShellSplit words("prg -I a --output=b.out --include b -n 1 "
+                     "-I 'c d' --output=c.out --include=e file");
+    auto options = parser.parse(words);
+    ValueSpan includes = options -> get_values('I');
+    CHECK_EQUAL(4, (int) includes.size());
+    CHECK_EQUAL(std::string("a"), std::string(includes[0]));
+    CHECK_EQUAL(std::string("b"), std::string(includes[1]));
+    CHECK_EQUAL(std::string("c d"), std::string(includes[2]));
+    CHECK_EQUAL(std::string("e"), std::string(includes[3]));
+    CHECK_TRUE(includes.data() + 3 == &*(includes.end() - 1));
+    CHECK_EQUAL(1, (int) options -> get_values("number").size());
+    CHECK_TRUE(options -> get_values("output").empty());
+    CHECK_EQUAL(std::string("c.out"), options -> at('o') -> get_value());
+    CHECK_TRUE(options -> is_set(options -> find_id('I')));
+    CHECK_EQUAL(std::string("file"),
+                (*options -> arguments_cbegin()) -> get_value());
+    const char* none[] = { "prg" };
+    options = parser.parse(1, none);
+    CHECK_TRUE(options -> get_values('I').empty());
+    CHECK_FALSE(options -> is_set(options -> find_id('I')));
+}
+
+/**
+ * HAVE A repeated option given thousands of times
+ * WHEN convert its values in bulk
+ * THEN they are all converted in order, and a value not valid for
+ *      the type stops the conversion.
+ */
+TEST(RepeatedValues, Test_02) {
+    OptionParser parser;
+    add_options(parser);
+    const int count = 5000;
+    std::vector<std::string> arguments = { "prg" };
+    for (int i = 0; i < count; ++i) {
+        arguments.push_back("-n");
+        arguments.push_back(std::to_string(i * 3));
+    }
+    auto options = parser.parse(arguments);
+    std::vector<std::int64_t> numbers;
+    CHECK_TRUE(options -> get_values('n').convert(numbers));
+    CHECK_EQUAL(count, (int) numbers.size());
+    bool ordered = true;
+    for (int i = 0; i < count; ++i) {
+        ordered = ordered && numbers[i] == i * 3;
+    }
+    CHECK_TRUE(ordered);
+    const char* wrong[] = { "prg", "-n", "1", "-n", "x", "-n", "3" };
+    options = parser.parse(7, wrong);
+    std::vector<int> converted;
+    CHECK_FALSE(options -> get_values('n').convert(converted));
+    CHECK_EQUAL(1, (int) converted.size());
+    std::vector<std::string> texts;
+    CHECK_TRUE(options -> get_values('n').convert(texts));
+    CHECK_EQUAL(std::string("x"), texts[1]);
+}
+
+/**
+ * HAVE A parser with repeated options and its compiled image
+ * WHEN parse command lines with the same repeated values in other
+ *      order, or interleaved with the ones of another option
+ * THEN both parsers agree, and only the order of the values of the
+ *      same option changes the fingerprint.
+ */
+TEST(RepeatedValues, Test_03) {
+    OptionParser parser;
+    add_options(parser);
+    std::vector<std::uint64_t> image(CompiledParser::image_size(parser) / 8);
+    CompiledParser::write_image(parser, image.data());
+    CompiledParser compiled(image.data(), image.size() * 8);
+    const char* first[] = { "prg", "-I", "a", "-n", "1", "-I", "b" };
+    const char* mixed[] = { "prg", "-n", "1", "-I", "a", "-I", "b" };
+    const char* order[] = { "prg", "-I", "b", "-n", "1", "-I", "a" };
+    auto options = parser.parse(7, first);
+    auto image_options = compiled.parse(7, first);
+    CHECK_EQUAL(2, (int) image_options -> get_values('I').size());
+    CHECK_EQUAL(std::string("b"),
+                std::string(image_options -> get_values('I')[1]));
+    CHECK_TRUE(options -> get_fingerprint() ==
+               image_options -> get_fingerprint());
+    CHECK_TRUE(options -> get_fingerprint() ==
+               parser.parse(7, mixed) -> get_fingerprint());
+    CHECK_TRUE(options -> get_fingerprint() !=
+               parser.parse(7, order) -> get_fingerprint());
+}
+
+/**
+ * HAVE A parser with a repeated option, an env prefix and a config
+ *      file giving the option twice
+ * WHEN parse adding the environment and the command line
+ * THEN each source replaces the values of the ones below, values
+ *      of the same source are appended, and fingerprints do not
+ *      depend on the values replaced.
+ */
+TEST(RepeatedValues, Test_04) {
+    OptionParser parser;
+    parser.set_env_prefix("OPTTEST_");
+    add_options(parser);
+    char path[] = "/tmp/optparse_testXXXXXX";
+    int fd = mkstemp(path);
+    const std::string content = "include = /etc/x\ninclude = /etc/y\n";
+    CHECK_EQUAL((long) content.size(),
+                (long) write(fd, content.data(), content.size()));
+    close(fd);
+    ConfigFile config;
+    CHECK_EQUAL(parse_ok, config.load(path).type);
+    unlink(path);
+    const char* plain[] = { "prg" };
+    const char* given[] = { "prg", "-I", "a", "--include=b" };
+    auto values = [](const Options& options) {
+        std::string joined;
+        for (std::string_view value : options.get_values('I')) {
+            joined += std::string(value) + ";";
+        }
+        return joined;
+    };
+    CHECK_EQUAL(std::string("/etc/x;/etc/y;"),
+                values(*parser.parse(1, plain, config)));
+    CHECK_EQUAL(std::string("a;b;"),
+                values(*parser.parse(4, given, config)));
+    setenv("OPTTEST_INCLUDE", "/env", 1);
+    auto from_environment = parser.parse(1, plain, config);
+    auto from_command_line = parser.parse(4, given, config);
+    unsetenv("OPTTEST_INCLUDE");
+    CHECK_EQUAL(std::string("/env;"), values(*from_environment));
+    CHECK_EQUAL(std::string("a;b;"), values(*from_command_line));
+    CHECK_TRUE(from_command_line -> get_fingerprint() ==
+               parser.parse(4, given) -> get_fingerprint());
+}
@@ -0,0 +1,50 @@
+#include "../src/liboptparse/response_file.hh"
+#include "benchmark.hh"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+/*
+ * Read the arguments of a 100 MB response file: mapped and sliced in
+ * place, or read word by word through iostreams.
+ */
+BENCHMARK(ResponseFiles, read_100mb) {
+    const std::size_t size = 100 << 20;
+    char path[] = "/tmp/optparse_benchXXXXXX";
+    int fd = mkstemp(path);
+    {
+        std::string chunk;
+        for (int i = 0; chunk.size() < (1 << 20); ++i) {
+            chunk += "--option" + std::to_string(i % 1000) +
+                "=value\\ " + std::to_string(i) + "\n-abc file.txt ";
+        }
+        for (std::size_t written = 0; written < size;
+             written += chunk.size()) {
+            if (write(fd, chunk.data(), chunk.size()) < 0) {
+                break;
+            }
+        }
+        close(fd);
+    }
+    std::string at = std::string("@") + path;
+    const char* argv[] = { "prog", at.c_str() };
+    const ResponseFileLimits limits = { std::size_t(1) << 30, 4 };
+    bench::measure("mmap, arguments in place", 5, size, [&]() {
+            ResponseFiles files;
+            files.expand(2, argv, limits);
+            bench::keep(files.size());
+        });
+    bench::measure("iostreams, arguments copied", 5, size, [&]() {
+            std::ifstream in(path);
+            std::vector<std::string> arguments;
+            std::string argument;
+            while (in >> argument) {
+                arguments.push_back(argument);
+            }
+            bench::keep(arguments.size());
+        });
+    unlink(path);
+}
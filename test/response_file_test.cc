@@ -0,0 +1,187 @@
+#include "../src/liboptparse/response_file.hh"
+#include "../src/liboptparse/command_parser.hh"
+#include "../src/liboptparse/parser.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+    const ResponseFileLimits LIMITS = { 1 << 20, 4 };
+
+    /* Write a temporary file, removed by the destructor. */
+    struct TempFile {
+        std::string path;
+
+        explicit TempFile(const std::string& content) {
+            char name[] = "/tmp/optparse_testXXXXXX";
+            int fd = mkstemp(name);
+            CHECK_TRUE(fd >= 0);
+            CHECK_EQUAL((long) content.size(),
+                        (long) write(fd, content.data(), content.size()));
+            close(fd);
+            path = name;
+        }
+
+        /* Replace the content of the file. */
+        void rewrite(const std::string& content) {
+            FILE* file = std::fopen(path.c_str(), "w");
+            std::fputs(content.c_str(), file);
+            std::fclose(file);
+        }
+
+        ~TempFile() {
+            unlink(path.c_str());
+        }
+    };
+}
+
+TEST_GROUP(ResponseFiles) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A command line with nested response files
+ * WHEN expand it
+ * THEN files are replaced by their arguments, kept escaped, each one
+ *      mapped to the argument of argv it comes from.
+ */
+TEST(ResponseFiles, Test_01) {
+    TempFile inner("-q\n--title=a\\ b\n");
+    TempFile outer("  -v file\t@" + inner.path + "\nlast");
+    std::string at = "@" + outer.path;
+    const char* argv[] = { "@prog", at.c_str(), "@" };
+    ResponseFiles files;
+    ParseError error = files.expand(3, argv, LIMITS);
+    CHECK_EQUAL(parse_ok, error.type);
+    std::vector<std::string> expected = {
+        "@prog", "-v", "file", "-q", "--title=a\\ b", "last", "@" };
+    CHECK_EQUAL(expected.size(), files.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        CHECK_TRUE(files.data()[i] == expected[i]);
+    }
+    std::vector<int> origins = { 0, 1, 1, 1, 1, 1, 2 };
+    for (std::size_t i = 0; i < origins.size(); ++i) {
+        CHECK_EQUAL(origins[i], files.get_origin(i));
+        CHECK_EQUAL(i != 0 && i != 6, files.is_from_file(i));
+    }
+}
+
+/**
+ * HAVE A command line with wrong response files
+ * WHEN expand it
+ * THEN missing, recursive, too deep and too large files are errors
+ *      at the argument naming them.
+ */
+TEST(ResponseFiles, Test_02) {
+    TempFile self("-v");
+    self.rewrite("-v @" + self.path);
+    TempFile inner("-q");
+    TempFile outer("@" + inner.path);
+    std::string missing = "@/nonexistent/optparse";
+    std::string at_self = "@" + self.path;
+    std::string at_outer = "@" + outer.path;
+    const char* argv[] = { "prog", "-v", missing.c_str(),
+                           at_self.c_str(), at_outer.c_str() };
+    ResponseFiles files;
+    CHECK_EQUAL(unreadable_response_file,
+                files.expand(3, argv, LIMITS).type);
+    argv[2] = at_self.c_str();
+    ParseError error = files.expand(3, argv, LIMITS);
+    CHECK_EQUAL(nested_response_file, error.type);
+    CHECK_EQUAL(2, error.index);
+    argv[2] = at_outer.c_str();
+    CHECK_EQUAL(parse_ok, files.expand(3, argv, LIMITS).type);
+    CHECK_EQUAL(nested_response_file,
+                files.expand(3, argv, ResponseFileLimits { 1024, 1 }).type);
+    CHECK_EQUAL(response_file_too_large,
+                files.expand(3, argv, ResponseFileLimits { 3, 4 }).type);
+}
+
+/**
+ * HAVE A parser with response files enabled
+ * WHEN parse a command line with a response file
+ * THEN options inside the file are parsed.
+ */
+TEST(ResponseFiles, Test_03) {
+    OptionParser parser;
+    parser.add('v', "verbose").set_type(flag);
+    parser.add('t', "title");
+    TempFile file("--title=a\\ b -v");
+    std::string at = "@" + file.path;
+    const char* argv[] = { "prog", at.c_str() };
+    auto ignored = parser.parse(2, argv);
+    CHECK_FALSE((bool) *ignored -> at('v'));
+    CHECK_TRUE(at == (std::string) **ignored -> arguments_cbegin());
+    parser.set_response_files(LIMITS);
+    auto options = parser.parse(2, argv);
+    CHECK_TRUE((bool) *options -> at('v'));
+    CHECK_EQUAL("a b", (std::string) *options -> at('t'));
+    std::vector<ParseError> errors;
+    const char* wrong[] = { "prog", "@/nonexistent/optparse" };
+    ParseResult result = parser.try_parse(2, wrong, errors);
+    CHECK_FALSE(result.is_ok());
+    CHECK_EQUAL(1, errors.size());
+    CHECK_EQUAL(unreadable_response_file, errors[0].type);
+}
+
+/**
+ * HAVE A parser with response files enabled
+ * WHEN parse stopping at the first positional argument, or parse a
+ *      range of arguments
+ * THEN response files are expanded, the tail is the rest of argv and
+ *      a stop inside a file is an error at the argument naming it.
+ */
+TEST(ResponseFiles, Test_04) {
+    OptionParser parser;
+    parser.add('v', "verbose").set_type(flag);
+    parser.add('t', "title");
+    parser.set_response_files(LIMITS);
+    TempFile empty("");
+    TempFile file("--title=a\\ b -v");
+    TempFile split("-v run now");
+    std::string at = "@" + file.path;
+    std::string at_empty = "@" + empty.path;
+    std::string at_split = "@" + split.path;
+    const char* argv[] = { "prog", at.c_str(), at_empty.c_str(),
+                           "run", at.c_str() };
+    ParseResult result = parser.try_parse(5, argv, stop_at_positional);
+    CHECK_TRUE(result.is_ok());
+    CHECK_EQUAL(2, result.get_tail().argc);
+    CHECK_TRUE(argv + 3 == result.get_tail().argv);
+    auto options = result.get_options();
+    CHECK_TRUE((bool) *options -> at('v'));
+    CHECK_EQUAL("a b", (std::string) *options -> at('t'));
+    const char* wrong[] = { "prog", at_split.c_str() };
+    ParseResult failed = parser.try_parse(2, wrong, stop_at_positional);
+    CHECK_FALSE(failed.is_ok());
+    CHECK_EQUAL(split_response_file, failed.get_error().type);
+    CHECK_EQUAL(1, failed.get_error().index);
+    std::vector<std::string> range = { "prog", at };
+    options = parser.parse(range);
+    CHECK_TRUE((bool) *options -> at('v'));
+    CHECK_EQUAL("a b", (std::string) *options -> at('t'));
+    CommandParser commands;
+    commands.get_global_parser().add('v', "verbose").set_type(flag);
+    commands.get_global_parser().set_response_files(LIMITS);
+    commands.add("run", [](OptionParser& run) {
+            run.add('t', "title");
+        });
+    TempFile global("-v");
+    std::string at_global = "@" + global.path;
+    const char* command[] = { "prog", at_global.c_str(), "run", "-t",
+                              "x" };
+    CommandResult parsed = commands.try_parse(5, command);
+    CHECK_TRUE(parsed.is_ok());
+    CHECK_TRUE(parsed.get_command() == "run");
+    CHECK_TRUE((bool) *parsed.get_global_options() -> at('v'));
+    CHECK_EQUAL("x", (std::string) *parsed.get_options() -> at('t'));
+}
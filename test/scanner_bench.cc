@@ -0,0 +1,51 @@
+#include "../src/liboptparse/parser.hh"
+#include "../src/liboptparse/scanner.hh"
+#include "benchmark.hh"
+#include <string>
+
+namespace {
+    const std::size_t VALUE_SIZE = 1 << 20;
+
+    std::string make_blob(std::size_t size) {
+        const char alphabet[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+            "0123456789+/";
+        std::string blob(size, 'A');
+        for (std::size_t i = 0; i < size; ++i) {
+            blob[i] = alphabet[(i * 7919) % 64];
+        }
+        return blob;
+    }
+}
+
+/*
+ * Scan a 1 MiB base64 value without delimiters with each routine
+ * supported by the running CPU.
+ */
+BENCHMARK(Scanner, find_delimiter) {
+    std::string blob = make_blob(VALUE_SIZE);
+    const char* names[] = { "scalar", "sse2", "avx2" };
+    for (auto name : names) {
+        auto finder = _LIBOPTPARSE_::get_delimiter_finder(name);
+        if (finder != NULL) {
+            bench::measure(name, 200, blob.size(), [&]() {
+                    bench::keep(finder(blob.data(),
+                                       blob.data() + blob.size()));
+                });
+        }
+    }
+}
+
+/*
+ * Parse a command line with a 1 MiB value passed to a long option.
+ */
+BENCHMARK(Scanner, parse_long_value) {
+    OptionParser parser;
+    parser.add('d', "data");
+    std::string value = "--data=" + make_blob(VALUE_SIZE);
+    const char *argv[] = { "program_name", value.c_str() };
+    bench::measure(_LIBOPTPARSE_::get_delimiter_finder_name(),
+                   200,
+                   value.size(),
+                   [&]() { bench::keep(parser.parse(2, argv)); });
+}
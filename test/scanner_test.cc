@@ -0,0 +1,76 @@
+#include "../src/liboptparse/scanner.hh"
+#include "../src/liboptparse/parser.hh"
+#include <string>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+TEST_GROUP(Scanner) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A string without delimiters
+ * WHEN scan it
+ * THEN end of the string to be returned.
+ */
+TEST(Scanner, Test_01) {
+    std::string value(100, 'a');
+    const char* end = value.data() + value.size();
+    CHECK_TRUE(_LIBOPTPARSE_::find_delimiter(value.data(), end) == end);
+}
+
+/**
+ * HAVE A string with a delimiter in each position
+ * WHEN scan it with each supported routine
+ * THEN all routines return the position of the delimiter.
+ */
+TEST(Scanner, Test_02) {
+    const char* names[] = { "scalar", "sse2", "avx2" };
+    const char delimiters[] = { ' ', '=', '\\' };
+    for (auto name : names) {
+        auto finder = _LIBOPTPARSE_::get_delimiter_finder(name);
+        if (finder == NULL) {
+            continue;
+        }
+        for (auto delimiter : delimiters) {
+            for (std::size_t pos = 0; pos < 70; ++pos) {
+                std::string value(70, '-');
+                value[pos] = delimiter;
+                const char* begin = value.data();
+                const char* found = finder(begin, begin + value.size());
+                CHECK_EQUAL(pos, (std::size_t)(found - begin));
+            }
+        }
+    }
+}
+
+/**
+ * HAVE A running CPU
+ * WHEN gets the routine used by find_delimiter
+ * THEN it is the one with the name reported.
+ */
+TEST(Scanner, Test_03) {
+    auto name = _LIBOPTPARSE_::get_delimiter_finder_name();
+    CHECK_TRUE(_LIBOPTPARSE_::get_delimiter_finder() ==
+               _LIBOPTPARSE_::get_delimiter_finder(name));
+}
+
+/**
+ * HAVE A new parser with an option
+ * WHEN parse a value longer than a SIMD register with escaped
+ *      delimiters
+ * THEN the value is unescaped.
+ */
+TEST(Scanner, Test_04) {
+    OptionParser parser;
+    parser.add('d', "data");
+    std::string blob(100, 'x');
+    std::string arg = "--data=" + blob + "\\=" + blob + "\\ end";
+    const char *argv[] = { "program_name", arg.c_str() };
+    auto options = parser.parse(2, argv);
+    CHECK_EQUAL((std::string)*options -> at('d'),
+                blob + "=" + blob + " end");
+}
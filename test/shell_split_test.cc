@@ -0,0 +1,72 @@
+#include "../src/liboptparse/shell_split.hh"
+#include "../src/liboptparse/parser.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+TEST_GROUP(ShellSplit) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A command string without quotes
+ * WHEN split it
+ * THEN words are slices of the command, escapes included.
+ */
+TEST(ShellSplit, Test_01) {
+    std::string command = "  prog\t-v  --out=a\\ b\n";
+    ShellSplit words(command);
+    CHECK_EQUAL(3, words.size());
+    CHECK_EQUAL(0, words.copied());
+    CHECK_TRUE(words.data()[0] == "prog");
+    CHECK_TRUE(words.data()[1] == "-v");
+    CHECK_TRUE(words.data()[2] == "--out=a\\ b");
+    CHECK_TRUE(words.data()[2].data() == command.data() + 11);
+    CHECK_EQUAL(0, ShellSplit(" \t ").size());
+}
+
+/**
+ * HAVE A command string with quotes
+ * WHEN split it and parse the words
+ * THEN only words needing escapes are copied and values are the
+ *      unquoted texts.
+ */
+TEST(ShellSplit, Test_02) {
+    OptionParser parser;
+    parser.add('m', "message");
+    parser.add('o', "output");
+    parser.add('t', "title");
+    std::string command = "prog -o 'out' --message \"a \\\"b\\\" c\""
+        " -t it\\'s' ok'";
+    ShellSplit words(command);
+    CHECK_EQUAL(7, words.size());
+    CHECK_EQUAL(2, words.copied());
+    CHECK_TRUE(words.data()[2] == "out");
+    CHECK_TRUE(words.data()[4] == "a\\ \"b\"\\ c");
+    CHECK_TRUE(words.data()[6] == "it\\'s\\ ok");
+    auto options = parser.parse(words);
+    CHECK_EQUAL("out", (std::string) *options -> at('o'));
+    CHECK_EQUAL("a \"b\" c", (std::string) *options -> at('m'));
+    CHECK_EQUAL("it's ok", (std::string) *options -> at('t'));
+}
+
+/**
+ * HAVE A command string with a quote not closed
+ * WHEN split it
+ * THEN std::invalid_argument is thrown.
+ */
+TEST(ShellSplit, Test_03) {
+    bool thrown = false;
+    try {
+        ShellSplit words("prog --message \"hello\\\"");
+    } catch (std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK_TRUE(thrown);
+}
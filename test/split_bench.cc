@@ -0,0 +1,44 @@
+#include "../src/liboptparse/shell_split.hh"
+#include "benchmark.hh"
+#include <string>
+#include <vector>
+
+namespace {
+    /* Command string of about size bytes, with some quoted words. */
+    std::string make_command(std::size_t size) {
+        std::string command = "prog";
+        for (std::size_t i = 0; command.size() < size; ++i) {
+            switch (i % 4) {
+            case 0:
+                command += " --option" + std::to_string(i) + "=value";
+                break;
+            case 1:
+                command += " -abc";
+                break;
+            case 2:
+                command += " 'quoted'";
+                break;
+            default:
+                command += " \"two words\"";
+                break;
+            }
+        }
+        return command;
+    }
+}
+
+/* Split long command strings: throughput in bytes of command. */
+BENCHMARK(Split, shell_split) {
+    const std::size_t sizes[] = { 4096, 1 << 20 };
+    for (auto size : sizes) {
+        std::string command = make_command(size);
+        std::string label = "split " + std::to_string(size) + " bytes";
+        bench::measure(label.c_str(),
+                       size < 65536 ? 20000 : 50,
+                       command.size(),
+                       [&]() {
+                           ShellSplit words(command);
+                           bench::keep(words.size());
+                       });
+    }
+}
@@ -0,0 +1,135 @@
+#include "../src/liboptparse/static_parser.hh"
+#include "../src/liboptparse/parser.hh"
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr OptionSpec SPECS[] = {
+        { 'r', "reply", value, "42" },
+        { 'v', "verbose", flag, "false" },
+        { '\0', "output", value, "a.out" },
+        { 'q', nullptr, flag, "false" }
+    };
+
+    /* Runtime parser with the same options of SPECS. */
+    OptionParser make_runtime_parser() {
+        OptionParser parser;
+        parser.add('r', "reply").set_default_value("42");
+        parser.add('v', "verbose")
+            .set_type(flag)
+            .set_default_value("false");
+        parser.add("output").set_default_value("a.out");
+        parser.add('q').set_type(flag).set_default_value("false");
+        return parser;
+    }
+
+    void check_same(const Options& expected, const Options& actual) {
+        CHECK_EQUAL(expected.size(), actual.size());
+        for (option_id id = 0; id < expected.size(); ++id) {
+            CHECK_EQUAL((std::string)*expected.at_id(id),
+                        (std::string)*actual.at_id(id));
+        }
+        CHECK_EQUAL(expected.get_program_name(),
+                    actual.get_program_name());
+        auto expected_arg = expected.arguments_cbegin();
+        auto actual_arg = actual.arguments_cbegin();
+        for (; expected_arg != expected.arguments_cend() &&
+                 actual_arg != actual.arguments_cend();
+             ++expected_arg, ++actual_arg) {
+            CHECK_EQUAL((std::string)**expected_arg,
+                        (std::string)**actual_arg);
+        }
+        CHECK_TRUE(expected_arg == expected.arguments_cend());
+        CHECK_TRUE(actual_arg == actual.arguments_cend());
+    }
+}
+
+static_assert(StaticOptionParser<SPECS>::size() == 4);
+static_assert(StaticOptionParser<SPECS>::find('r') == 0);
+static_assert(StaticOptionParser<SPECS>::find("output") == 2);
+static_assert(StaticOptionParser<SPECS>::find("reply") == 0);
+static_assert(StaticOptionParser<SPECS>::find("answer") == NO_OPTION_ID);
+static_assert(StaticOptionParser<SPECS>::find("") == NO_OPTION_ID);
+
+TEST_GROUP(StaticOptionParser) {
+    void setup() { }
+    void teardown() {
+        mock().clear();
+    }
+};
+
+/**
+ * HAVE A static parser and a runtime parser with the same options
+ * WHEN parse the same command line
+ * THEN the options returned are the same.
+ */
+TEST(StaticOptionParser, Test_01) {
+    const char* argv[] = { "prog", "-vr", "--output=out.txt",
+                           "file", "-r", "1", "--verbose" };
+    StaticOptionParser<SPECS> static_parser;
+    OptionParser runtime_parser = make_runtime_parser();
+    auto expected = runtime_parser.parse(7, argv);
+    auto actual = static_parser.parse(7, argv);
+    check_same(*expected, *actual);
+    CHECK_EQUAL((std::string)*actual -> at('r'), "1");
+    CHECK_EQUAL((std::string)*actual -> at("verbose"), "true");
+    CHECK_EQUAL((std::string)*actual -> at("output"), "out.txt");
+    CHECK_EQUAL((std::string)*actual -> at('q'), "false");
+}
+
+/**
+ * HAVE A static parser
+ * WHEN parse a command line with errors
+ * THEN errors are the same of the runtime parser.
+ */
+TEST(StaticOptionParser, Test_02) {
+    const char* argv[] = { "prog", "-x", "--answer", "--output" };
+    StaticOptionParser<SPECS> static_parser;
+    OptionParser runtime_parser = make_runtime_parser();
+    std::vector<ParseError> expected;
+    std::vector<ParseError> actual;
+    CHECK_FALSE(runtime_parser.try_parse(4, argv, expected).is_ok());
+    CHECK_FALSE(static_parser.try_parse(4, argv, actual).is_ok());
+    CHECK_EQUAL(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        CHECK_EQUAL(expected[i].type, actual[i].type);
+        CHECK_EQUAL(expected[i].index, actual[i].index);
+        CHECK_EQUAL(expected[i].position, actual[i].position);
+    }
+}
+
+/**
+ * HAVE A static parser with many long options
+ * WHEN look for each name
+ * THEN each option is found with its id.
+ */
+TEST(StaticOptionParser, Test_03) {
+    static constexpr OptionSpec specs[] = {
+        { 'a', "alpha", value, "" }, { 'b', "bravo", value, "" },
+        { 'c', "charlie", value, "" }, { 'd', "delta", value, "" },
+        { 'e', "echo", value, "" }, { 'f', "foxtrot", value, "" },
+        { 'g', "golf", value, "" }, { 'h', "hotel", value, "" },
+        { 'i', "india", value, "" }, { 'j', "juliett", value, "" },
+        { 'k', "kilo", value, "" }, { 'l', "lima", value, "" },
+        { 'm', "mike", value, "" }, { 'n', "november", value, "" },
+        { 'o', "oscar", value, "" }, { 'p', "papa", value, "" },
+        { 'q', "quebec", value, "" }, { 'r', "romeo", value, "" },
+        { 's', "sierra", value, "" }, { 't', "tango", value, "" },
+        { 'u', "uniform", value, "" }, { 'v', "victor", value, "" },
+        { 'w', "whiskey", value, "" }, { 'x', "xray", value, "" },
+        { 'y', "yankee", value, "" }, { 'z', "zulu", value, "" }
+    };
+    typedef StaticOptionParser<specs> parser_type;
+    for (option_id id = 0; id < parser_type::size(); ++id) {
+        CHECK_EQUAL(id, parser_type::find(specs[id].short_name));
+        CHECK_EQUAL(id, parser_type::find(specs[id].long_name));
+    }
+    CHECK_EQUAL(NO_OPTION_ID, parser_type::find("zul"));
+    const char* argv[] = { "prog", "--kilo", "1000" };
+    parser_type parser;
+    auto options = parser.parse(3, argv);
+    CHECK_EQUAL((std::string)*options -> at('k'), "1000");
+}